@@ -34,6 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "EMMPMFilter.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <QtCore/QTextStream>
 #include <QtGui/QColor>
 
@@ -66,6 +69,7 @@
 #include "SIMPLib/Messages/GenericProgressMessage.h"
 #include "SIMPLib/Messages/GenericStatusMessage.h"
 #include "SIMPLib/Messages/GenericWarningMessage.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 /**
  * @brief This message handler is used by EMMPMFilter instances to re-emit incoming generic messages from the
@@ -115,6 +119,108 @@ private:
   EMMPMFilter* m_Filter = nullptr;
 };
 
+/**
+ * @brief This message handler records the error reported while segmenting a single slice in volume mode. The
+ * slices run on worker threads so nothing is re-emitted from here; the filter reports the error afterwards.
+ */
+class EMMPMSliceErrorHandler : public AbstractMessageHandler
+{
+public:
+  EMMPMSliceErrorHandler(int32_t& errorCode, QString& errorMessage)
+  : m_ErrorCode(errorCode)
+  , m_ErrorMessage(errorMessage)
+  {
+  }
+
+  /**
+   * @brief Stores incoming GenericErrorMessages.
+   */
+  void processMessage(const GenericErrorMessage* msg) const override
+  {
+    m_ErrorCode = msg->getCode();
+    m_ErrorMessage = msg->getMessageText();
+  }
+
+private:
+  int32_t& m_ErrorCode;
+  QString& m_ErrorMessage;
+};
+
+/**
+ * @brief The SegmentSlicesImpl class segments a range of Z slices of the input image, each slice on its own.
+ */
+class SegmentSlicesImpl
+{
+public:
+  SegmentSlicesImpl(EMMPMFilter* filter, EMMPM_InitializationType initType, const float* initialMu, const float* initialSigma, std::vector<float>& sliceMu,
+                    std::vector<float>& sliceSigma, std::vector<int32_t>& errorCodes, std::vector<QString>& errorMessages)
+  : m_Filter(filter)
+  , m_InitType(initType)
+  , m_InitialMu(initialMu)
+  , m_InitialSigma(initialSigma)
+  , m_SliceMu(sliceMu)
+  , m_SliceSigma(sliceSigma)
+  , m_ErrorCodes(errorCodes)
+  , m_ErrorMessages(errorMessages)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    size_t numClasses = static_cast<size_t>(m_Filter->getNumClasses());
+    for(size_t slice = start; slice < end; slice++)
+    {
+      if(m_Filter->getCancel())
+      {
+        return;
+      }
+      m_ErrorCodes[slice] = m_Filter->segmentSlice(slice, m_InitType, m_InitialMu, m_InitialSigma, m_SliceMu.data() + slice * numClasses, m_SliceSigma.data() + slice * numClasses,
+                                                   m_ErrorMessages[slice]);
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  EMMPMFilter* m_Filter = nullptr;
+  EMMPM_InitializationType m_InitType;
+  const float* m_InitialMu = nullptr;
+  const float* m_InitialSigma = nullptr;
+  std::vector<float>& m_SliceMu;
+  std::vector<float>& m_SliceSigma;
+  std::vector<int32_t>& m_ErrorCodes;
+  std::vector<QString>& m_ErrorMessages;
+};
+
+namespace
+{
+// Number of slices segmented together in the volume mode. It is fixed so that the slices a warm started block is seeded
+// from, and therefore the segmentation, do not depend on the number of processors
+constexpr size_t k_SliceBlockSize = 8;
+
+/**
+ * @brief Creates the initialization function that matches the initialization type
+ * @param initType Enumeration of EMMPM initialization types
+ * @return
+ */
+InitializationFunction::Pointer CreateInitializationFunction(EMMPM_InitializationType initType)
+{
+  switch(initType)
+  {
+  case EMMPM_ManualInit:
+    return InitializationFunction::New();
+  case EMMPM_UserInitArea:
+    return UserDefinedAreasInitialization::New();
+  default:
+    break;
+  }
+  return BasicInitialization::New();
+}
+} // namespace
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -187,6 +293,12 @@ void EMMPMFilter::setupFilterParameters()
   }
 
   parameters.push_back(SIMPL_NEW_BOOL_FP("Use 1-Based Values", UseOneBasedValues, FilterParameter::Category::Parameter, EMMPMFilter));
+  {
+    std::vector<QString> linkedProps;
+    linkedProps.push_back("UseNeighborSliceInitialization");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Segment All Z Slices", SegmentVolume, FilterParameter::Category::Parameter, EMMPMFilter, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Initialize Slices from Neighboring Slice", UseNeighborSliceInitialization, FilterParameter::Category::Parameter, EMMPMFilter));
 
   {
     std::vector<QString> linkedProps;
@@ -236,6 +348,8 @@ void EMMPMFilter::readFilterParameters(AbstractFilterParametersReader* reader, i
   setCurvatureBetaC(reader->readValue("CurvaturePenalty", getCurvatureBetaC()));
   setCurvatureRMax(reader->readValue("RMax", getCurvatureRMax()));
   setCurvatureEMLoopDelay(reader->readValue("EMLoopDelay", getCurvatureEMLoopDelay()));
+  setSegmentVolume(reader->readValue("SegmentVolume", getSegmentVolume()));
+  setUseNeighborSliceInitialization(reader->readValue("UseNeighborSliceInitialization", getUseNeighborSliceInitialization()));
   setOutputDataArrayPath(reader->readDataArrayPath("OutputDataArrayPath", getOutputDataArrayPath()));
   reader->closeFilterGroup();
 }
@@ -311,8 +425,22 @@ void EMMPMFilter::execute()
   }
   initialize();
 
+  DataArrayPath dap = getInputDataArrayPath();
+  std::vector<size_t> tDims = getDataContainerArray()->getAttributeMatrix(dap)->getTupleDimensions();
+
   // This is the routine that sets up the EM/MPM to segment the image
-  segment(getEmmpmInitType());
+  if(m_SegmentVolume && tDims.size() > 2 && tDims[2] > 1)
+  {
+    segmentVolume(getEmmpmInitType());
+  }
+  else
+  {
+    segment(getEmmpmInitType());
+  }
+  if(getErrorCode() < 0 || getCancel())
+  {
+    return;
+  }
 
   if(m_UseOneBasedValues && m_OutputImagePtr.lock() != nullptr)
   {
@@ -332,59 +460,10 @@ void EMMPMFilter::execute()
 void EMMPMFilter::segment(EMMPM_InitializationType initType)
 {
   // Copy all the variables from the filter into the EMmpm Data structure.
-  m_Data->initType = initType;
-
-  InitializationFunction::Pointer initFunction = BasicInitialization::New();
+  copyParametersToData(m_Data.get(), initType);
 
   // Set the initialization function based on the parameters
-  switch(m_Data->initType)
-  {
-  case EMMPM_ManualInit:
-    initFunction = InitializationFunction::New();
-    break;
-  case EMMPM_UserInitArea:
-    initFunction = UserDefinedAreasInitialization::New();
-    break;
-  default:
-    initFunction = BasicInitialization::New();
-    break;
-  }
-
-  m_Data->classes = getNumClasses();
-  m_Data->in_beta = getExchangeEnergy();
-  m_Data->emIterations = getHistogramLoops();
-  m_Data->mpmIterations = getSegmentationLoops();
-
-  DynamicTableData tableDataObj = getEMMPMTableData();
-  std::vector<std::vector<double>> tableData = tableDataObj.getTableData();
-  for(int32_t i = 0; i < m_Data->classes; i++)
-  {
-    int32_t gray = 255 / (m_Data->classes - 1);
-    // Generate a Gray Scale Color Table
-    m_Data->colorTable[i] = qRgb(i * gray, i * gray, i * gray);
-    // Hard code the minimum variance to 4.5; This could be a user option.
-    m_Data->min_variance[i] = tableData[i][1];
-    // Do we know what w_gamma is?
-    m_Data->w_gamma[i] = tableData[i][0];
-  }
-
-  DataArrayPath dap = getInputDataArrayPath();
-  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(dap);
-  std::vector<size_t> tDims = am->getTupleDimensions();
-  IDataArray::Pointer iDataArray = am->getAttributeArray(getInputDataArrayPath().getDataArrayName());
-  std::vector<size_t> cDims = iDataArray->getComponentDimensions();
-
-  m_Data->columns = tDims[0];
-  m_Data->rows = tDims[1];
-  m_Data->inputImageChannels = cDims[0];
-
-  m_Data->simulatedAnnealing = (char)(getUseSimulatedAnnealing());
-  m_Data->useGradientPenalty = static_cast<char>(getUseGradientPenalty());
-  m_Data->beta_e = getGradientBetaE();
-  m_Data->useCurvaturePenalty = static_cast<char>(getUseCurvaturePenalty());
-  m_Data->beta_c = getCurvatureBetaC();
-  m_Data->r_max = getCurvatureRMax();
-  m_Data->ccostLoopDelay = getCurvatureEMLoopDelay();
+  InitializationFunction::Pointer initFunction = CreateInitializationFunction(m_Data->initType);
 
   // Assign our Data array allocated input and output images into the EMMPData class
   m_Data->inputImage = m_InputImage;
@@ -432,6 +511,183 @@ void EMMPMFilter::segment(EMMPM_InitializationType initType)
   m_PreviousSigma.resize(getNumClasses() * m_Data->dims);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EMMPMFilter::copyParametersToData(EMMPM_Data* data, EMMPM_InitializationType initType)
+{
+  data->initType = initType;
+  data->classes = getNumClasses();
+  data->in_beta = getExchangeEnergy();
+  data->emIterations = getHistogramLoops();
+  data->mpmIterations = getSegmentationLoops();
+
+  DynamicTableData tableDataObj = getEMMPMTableData();
+  std::vector<std::vector<double>> tableData = tableDataObj.getTableData();
+  for(int32_t i = 0; i < data->classes; i++)
+  {
+    int32_t gray = 255 / (data->classes - 1);
+    // Generate a Gray Scale Color Table
+    data->colorTable[i] = qRgb(i * gray, i * gray, i * gray);
+    // Hard code the minimum variance to 4.5; This could be a user option.
+    data->min_variance[i] = tableData[i][1];
+    // Do we know what w_gamma is?
+    data->w_gamma[i] = tableData[i][0];
+  }
+
+  DataArrayPath dap = getInputDataArrayPath();
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(dap);
+  std::vector<size_t> tDims = am->getTupleDimensions();
+  IDataArray::Pointer iDataArray = am->getAttributeArray(getInputDataArrayPath().getDataArrayName());
+  std::vector<size_t> cDims = iDataArray->getComponentDimensions();
+
+  data->columns = tDims[0];
+  data->rows = tDims[1];
+  data->inputImageChannels = cDims[0];
+
+  data->simulatedAnnealing = (char)(getUseSimulatedAnnealing());
+  data->useGradientPenalty = static_cast<char>(getUseGradientPenalty());
+  data->beta_e = getGradientBetaE();
+  data->useCurvaturePenalty = static_cast<char>(getUseCurvaturePenalty());
+  data->beta_c = getCurvatureBetaC();
+  data->r_max = getCurvatureRMax();
+  data->ccostLoopDelay = getCurvatureEMLoopDelay();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t EMMPMFilter::segmentSlice(size_t slice, EMMPM_InitializationType initType, const float* initialMu, const float* initialSigma, float* finalMu, float* finalSigma, QString& errorMessage)
+{
+  // Each slice gets its own EMMPM_Data so the slices can be segmented at the same time
+  EMMPM_Data::Pointer data = EMMPM_Data::New();
+  data->dims = 1; // We operate on a single channel | single component "image".
+  copyParametersToData(data.get(), initType);
+
+  // A seeded slice starts from the supplied statistics instead of running its own initialization
+  if(nullptr != initialMu)
+  {
+    data->initType = EMMPM_ManualInit;
+  }
+  InitializationFunction::Pointer initFunction = CreateInitializationFunction(data->initType);
+
+  size_t sliceOffset = slice * static_cast<size_t>(data->rows) * static_cast<size_t>(data->columns);
+  data->inputImage = m_InputImage + sliceOffset;
+  data->xt = m_OutputImage + sliceOffset;
+
+  data->allocateDataStructureMemory();
+
+  if(data->initType == EMMPM_ManualInit)
+  {
+    const float* mu = (nullptr != initialMu) ? initialMu : m_PreviousMu.data();
+    const float* sigma = (nullptr != initialSigma) ? initialSigma : m_PreviousSigma.data();
+    for(int32_t i = 0; i < data->classes; i++)
+    {
+      for(uint32_t d = 0; d < data->dims; d++)
+      {
+        data->mean[i * data->dims + d] = mu[i * data->dims + d];
+        data->variance[i * data->dims + d] = sigma[i * data->dims + d];
+      }
+    }
+  }
+
+  StatsDelegate::Pointer statsDelegate = StatsDelegate::New();
+
+  EMMPM::Pointer emmpm = EMMPM::New();
+  emmpm->setData(data);
+  emmpm->setStatsDelegate(statsDelegate.get());
+  emmpm->setInitializationFunction(initFunction);
+
+  // Progress from the individual slices is dropped; only an error is kept so it can be reported once the slices finish
+  int32_t errorCode = 0;
+  connect(emmpm.get(), &EMMPM::messageGenerated, [&errorCode, &errorMessage](const AbstractMessage::Pointer& msg) {
+    EMMPMSliceErrorHandler msgHandler(errorCode, errorMessage);
+    msg->visit(&msgHandler);
+  });
+
+  emmpm->execute();
+
+  for(int32_t i = 0; i < data->classes; i++)
+  {
+    for(uint32_t d = 0; d < data->dims; d++)
+    {
+      finalMu[i * data->dims + d] = data->mean[i * data->dims + d];
+      finalSigma[i * data->dims + d] = data->variance[i * data->dims + d];
+    }
+  }
+
+  // We manually set the pointers to nullptr so that the EMMPData class does not try to free the memory
+  data->inputImage = nullptr;
+  data->xt = nullptr;
+
+  return errorCode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EMMPMFilter::segmentVolume(EMMPM_InitializationType initType)
+{
+  DataArrayPath dap = getInputDataArrayPath();
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(dap);
+  std::vector<size_t> tDims = am->getTupleDimensions();
+  size_t numSlices = tDims[2];
+  size_t numClasses = static_cast<size_t>(getNumClasses());
+
+  std::vector<float> sliceMu(numSlices * numClasses, 0.0f);
+  std::vector<float> sliceSigma(numSlices * numClasses, 0.0f);
+  std::vector<int32_t> errorCodes(numSlices, 0);
+  std::vector<QString> errorMessages(numSlices);
+
+  // The slices are segmented concurrently in blocks of k_SliceBlockSize slices. When warm starting, the first slice is
+  // run on its own with the chosen initialization and every block is then seeded from the last slice of the block before
+  // it, so the result depends neither on the number of threads nor on how they are scheduled.
+  size_t sliceStart = 0;
+  while(sliceStart < numSlices)
+  {
+    size_t sliceEnd = std::min(numSlices, sliceStart + k_SliceBlockSize);
+    const float* initialMu = nullptr;
+    const float* initialSigma = nullptr;
+    if(m_UseNeighborSliceInitialization)
+    {
+      if(sliceStart == 0)
+      {
+        sliceEnd = 1;
+      }
+      else
+      {
+        initialMu = sliceMu.data() + (sliceStart - 1) * numClasses;
+        initialSigma = sliceSigma.data() + (sliceStart - 1) * numClasses;
+      }
+    }
+
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(sliceStart, sliceEnd);
+    dataAlg.execute(SegmentSlicesImpl(this, initType, initialMu, initialSigma, sliceMu, sliceSigma, errorCodes, errorMessages));
+
+    if(getCancel())
+    {
+      return;
+    }
+    for(size_t slice = sliceStart; slice < sliceEnd; slice++)
+    {
+      if(errorCodes[slice] < 0)
+      {
+        QString ss = QObject::tr("Slice %1: %2").arg(slice).arg(errorMessages[slice]);
+        setErrorCondition(errorCodes[slice], ss);
+        return;
+      }
+    }
+
+    sliceStart = sliceEnd;
+    notifyStatusMessage(QObject::tr("Segmented slice %1 of %2").arg(sliceStart).arg(numSlices));
+  }
+
+  // The statistics of the last slice become the previous Mu/Sigma values, as they do for a single image
+  m_PreviousMu.assign(sliceMu.end() - numClasses, sliceMu.end());
+  m_PreviousSigma.assign(sliceSigma.end() - numClasses, sliceSigma.end());
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -753,6 +1009,30 @@ DataArrayPath EMMPMFilter::getOutputDataArrayPath() const
   return m_OutputDataArrayPath;
 }
 
+// -----------------------------------------------------------------------------
+void EMMPMFilter::setSegmentVolume(bool value)
+{
+  m_SegmentVolume = value;
+}
+
+// -----------------------------------------------------------------------------
+bool EMMPMFilter::getSegmentVolume() const
+{
+  return m_SegmentVolume;
+}
+
+// -----------------------------------------------------------------------------
+void EMMPMFilter::setUseNeighborSliceInitialization(bool value)
+{
+  m_UseNeighborSliceInitialization = value;
+}
+
+// -----------------------------------------------------------------------------
+bool EMMPMFilter::getUseNeighborSliceInitialization() const
+{
+  return m_UseNeighborSliceInitialization;
+}
+
 // -----------------------------------------------------------------------------
 void EMMPMFilter::setEmmpmInitType(const EMMPM_InitializationType& value)
 {
@@ -48,6 +48,7 @@
 #include "EMMPM/EMMPMDLLExport.h"
 
 class EMMPMFilterMessageHandler;
+class SegmentSlicesImpl;
 
 /**
  * @brief The EMMPMFilter class. See [Filter documentation](@ref emmpmfilter) for details.
@@ -76,6 +77,8 @@ class EMMPM_EXPORT EMMPMFilter : public AbstractFilter
   PYB11_PROPERTY(double CurvatureRMax READ getCurvatureRMax WRITE setCurvatureRMax)
   PYB11_PROPERTY(int CurvatureEMLoopDelay READ getCurvatureEMLoopDelay WRITE setCurvatureEMLoopDelay)
   PYB11_PROPERTY(DataArrayPath OutputDataArrayPath READ getOutputDataArrayPath WRITE setOutputDataArrayPath)
+  PYB11_PROPERTY(bool SegmentVolume READ getSegmentVolume WRITE setSegmentVolume)
+  PYB11_PROPERTY(bool UseNeighborSliceInitialization READ getUseNeighborSliceInitialization WRITE setUseNeighborSliceInitialization)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -110,6 +113,7 @@ public:
   ~EMMPMFilter() override;
 
   friend EMMPMFilterMessageHandler;
+  friend SegmentSlicesImpl;
 
   /**
    * @brief Setter property for InputDataArrayPath
@@ -276,6 +280,28 @@ public:
   DataArrayPath getOutputDataArrayPath() const;
   Q_PROPERTY(DataArrayPath OutputDataArrayPath READ getOutputDataArrayPath WRITE setOutputDataArrayPath)
 
+  /**
+   * @brief Setter property for SegmentVolume
+   */
+  void setSegmentVolume(bool value);
+  /**
+   * @brief Getter property for SegmentVolume
+   * @return Value of SegmentVolume
+   */
+  bool getSegmentVolume() const;
+  Q_PROPERTY(bool SegmentVolume READ getSegmentVolume WRITE setSegmentVolume)
+
+  /**
+   * @brief Setter property for UseNeighborSliceInitialization
+   */
+  void setUseNeighborSliceInitialization(bool value);
+  /**
+   * @brief Getter property for UseNeighborSliceInitialization
+   * @return Value of UseNeighborSliceInitialization
+   */
+  bool getUseNeighborSliceInitialization() const;
+  Q_PROPERTY(bool UseNeighborSliceInitialization READ getUseNeighborSliceInitialization WRITE setUseNeighborSliceInitialization)
+
   /**
    * @brief Setter property for EmmpmInitType
    */
@@ -364,6 +390,36 @@ protected:
    */
   virtual void segment(EMMPM_InitializationType initType);
 
+  /**
+   * @brief segmentVolume Segments every Z slice of the input image as its own 2D image. Slices are
+   * segmented concurrently in blocks; with neighbor slice initialization turned on, each block starts
+   * from the final Mu/Sigma of the last slice of the previous block.
+   * @param initType Enumeration of EMMPM initialization types used for the first slice (and for every
+   * slice when neighbor slice initialization is off)
+   */
+  virtual void segmentVolume(EMMPM_InitializationType initType);
+
+  /**
+   * @brief copyParametersToData Copies the filter parameters and the image dimensions into an EMMPM_Data
+   * @param data The EMMPM_Data to fill
+   * @param initType Enumeration of EMMPM initialization types
+   */
+  void copyParametersToData(EMMPM_Data* data, EMMPM_InitializationType initType);
+
+  /**
+   * @brief segmentSlice Runs the EM/MPM algorithm on a single Z slice of the input image. This is safe to
+   * call concurrently for different slices.
+   * @param slice The Z index of the slice
+   * @param initType Enumeration of EMMPM initialization types
+   * @param initialMu Mu values to start from or nullptr to use the initialization type
+   * @param initialSigma Sigma values to start from or nullptr to use the initialization type
+   * @param finalMu Output; the Mu values of the finished segmentation
+   * @param finalSigma Output; the Sigma values of the finished segmentation
+   * @param errorMessage Output; the error message if the segmentation failed
+   * @return Integer error code
+   */
+  int32_t segmentSlice(size_t slice, EMMPM_InitializationType initType, const float* initialMu, const float* initialSigma, float* finalMu, float* finalSigma, QString& errorMessage);
+
   /**
    * @brief getPreviousMu
    * @return
@@ -415,6 +471,8 @@ private:
   double m_CurvatureRMax = {};
   int m_CurvatureEMLoopDelay = {};
   DataArrayPath m_OutputDataArrayPath = {};
+  bool m_SegmentVolume = {false};
+  bool m_UseNeighborSliceInitialization = {false};
   EMMPM_InitializationType m_EmmpmInitType = {};
 
   std::vector<float> m_PreviousMu;
@@ -52,6 +52,14 @@ void StatsDelegate::reportProgress(EMMPM_Data::Pointer data)
 {
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool StatsDelegate::getRequiresOutputImage() const
+{
+  return false;
+}
+
 // -----------------------------------------------------------------------------
 StatsDelegate::Pointer StatsDelegate::NullPointer()
 {
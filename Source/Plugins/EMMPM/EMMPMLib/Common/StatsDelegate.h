@@ -71,6 +71,13 @@ public:
 
   virtual void reportProgress(EMMPM_Data::Pointer data);
 
+  /**
+   * @brief Returns true if reportProgress() reads the output image or histograms of the EMMPM_Data. Only then
+   * are they refreshed before every progress report; otherwise they are only written once the EM/MPM loops finish.
+   * @return
+   */
+  virtual bool getRequiresOutputImage() const;
+
 protected:
   StatsDelegate();
 
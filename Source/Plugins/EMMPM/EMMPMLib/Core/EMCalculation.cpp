@@ -204,14 +204,17 @@ void EMCalculation::execute()
   {
 
     ss.clear();
-    msgOut << "EM Loop " << data->currentEMLoop << " - Converting Xt Data to Output Image..";
+    msgOut << "EM Loop " << data->currentEMLoop << " - Reporting Progress..";
     notifyStatusMessage(ss);
 
     /* Send back the Progress Stats and the segmented image. If we never get into this loop because
      * emiter == 0 then we will still send back the stats just after the end of the EM Loops */
-    EMMPMUtilities::ConvertXtToOutputImage(getData());
     if(m_StatsDelegate != nullptr)
     {
+      if(m_StatsDelegate->getRequiresOutputImage())
+      {
+        EMMPMUtilities::ConvertXtToOutputImage(getData());
+      }
       m_StatsDelegate->reportProgress(getData());
     }
 
@@ -33,9 +33,11 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "EMMPMLib/Common/EMMPM_Math.h"
 #include "EMMPMLib/Core/EMMPMUtilities.h"
@@ -44,6 +46,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "EMMPMLib/Core/InitializationFunctions.h"
 #include "EMMPMLib/EMMPMLibTypes.h"
 
+#ifdef EMMPM_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -228,125 +236,146 @@ void EMMPMUtilities::copyCurrentMeanVarianceValues(EMMPM_Data::Pointer data)
   ::memcpy(data->prev_variance, data->variance, data->classes * data->dims * sizeof(real_t));
 }
 
+namespace
+{
+// The rows of the image are grouped into blocks of roughly this many pixels. Each block keeps its own partial
+// sums which are then added together in block order, so the estimates do not depend on the number of threads.
+constexpr size_t k_ReductionBlockPixels = 65536;
+} // namespace
+
 // -----------------------------------------------------------------------------
-// This class can not be easily parallelized due to the summation of the
-// data->variance[ld] variable.
+// Sums the numerator (y * probs) and denominator (probs) of Eq. (20) for every
+// class over a range of row blocks. blockSums holds (dims + 1) values per class
+// per block: the denominator followed by the numerator of each dimension.
 // -----------------------------------------------------------------------------
 class EstimateMeans
 {
 public:
-  EstimateMeans(EMMPM_Data* dPtr, size_t l)
+  EstimateMeans(EMMPM_Data* dPtr, size_t rowsPerBlock, std::vector<double>& blockSums)
+  : data(dPtr)
+  , rowsPerBlock(rowsPerBlock)
+  , blockSums(blockSums)
   {
-    this->l = l;
-    this->data = dPtr;
   }
   virtual ~EstimateMeans() = default;
 
-  void calc(int rowStart, int rowEnd, int colStart, int colEnd) const
+  void calc(size_t blockStart, size_t blockEnd) const
   {
-    int dims = data->dims;
-    int rows = data->rows;
-    int cols = data->columns;
-    int32_t k_, k2_, lij, ld, ijd, k_temp, k2_temp;
-    real_t* m = data->mean;
+    size_t dims = data->dims;
+    size_t rows = data->rows;
+    size_t cols = data->columns;
+    size_t classes = data->classes;
+    size_t stride = classes * (dims + 1);
     unsigned char* y = data->y;
     real_t* probs = data->probs;
-    real_t* N = data->N;
 
-    k_temp = (cols * rows * l);
-    for(int r = rowStart; r < rowEnd; r++)
+    for(size_t b = blockStart; b < blockEnd; b++)
     {
-      k_ = k_temp + (cols * r);
-      k2_temp = (dims * cols * r);
-      for(int c = colStart; c < colEnd; c++)
+      size_t rowStart = b * rowsPerBlock;
+      size_t rowEnd = std::min(rows, rowStart + rowsPerBlock);
+      double* sums = blockSums.data() + b * stride;
+      for(size_t l = 0; l < classes; l++)
       {
-        k2_ = k2_temp + (dims * c);
-        lij = k_ + c;
-        N[l] += probs[lij]; // denominator of (20)
-        for(int d = 0; d < dims; d++)
+        double* classSums = sums + l * (dims + 1);
+        size_t k_temp = cols * rows * l;
+        for(size_t r = rowStart; r < rowEnd; r++)
         {
-          ld = dims * l + d;
-          ijd = k2_ + d;
-          m[ld] += y[ijd] * probs[lij]; // numerator of (20)
+          size_t k_ = k_temp + (cols * r);
+          size_t k2_temp = dims * cols * r;
+          for(size_t c = 0; c < cols; c++)
+          {
+            real_t p = probs[k_ + c];
+            classSums[0] += p; // denominator of (20)
+            for(size_t d = 0; d < dims; d++)
+            {
+              classSums[1 + d] += y[k2_temp + (dims * c) + d] * p; // numerator of (20)
+            }
+          }
         }
       }
     }
-    if(N[l] != 0)
-    {
-      for(int d = 0; d < dims; d++)
-      {
-        ld = dims * l + d;
-        m[ld] = m[ld] / N[l];
-      }
-    }
   }
 
+#if EMMPM_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    calc(r.begin(), r.end());
+  }
+#endif
+
 private:
-  size_t l;
   EMMPM_Data* data;
+  size_t rowsPerBlock;
+  std::vector<double>& blockSums;
 };
 
-/* This class can not be easily parallelized due to the summation of the
- * data->variance[ld] variable.
- */
+// -----------------------------------------------------------------------------
+// Sums the numerator of Eq. (21) for every class over a range of row blocks
+// using the already updated means. blockSums holds dims values per class per block.
+// -----------------------------------------------------------------------------
 class EstimateVariance
 {
 public:
-  EstimateVariance(EMMPM_Data* dPtr, size_t l)
+  EstimateVariance(EMMPM_Data* dPtr, size_t rowsPerBlock, std::vector<double>& blockSums)
+  : data(dPtr)
+  , rowsPerBlock(rowsPerBlock)
+  , blockSums(blockSums)
   {
-    this->l = l;
-    this->data = dPtr;
   }
   virtual ~EstimateVariance() = default;
 
-  void calc(int rowStart, int rowEnd, int colStart, int colEnd) const
+  void calc(size_t blockStart, size_t blockEnd) const
   {
-    int dims = data->dims;
-    int rows = data->rows;
-    int cols = data->columns;
-    int32_t k_, k2_, lij, ld, ijd, k_temp, k2_temp;
+    size_t dims = data->dims;
+    size_t rows = data->rows;
+    size_t cols = data->columns;
+    size_t classes = data->classes;
+    size_t stride = classes * dims;
     real_t* m = data->mean;
     unsigned char* y = data->y;
     real_t* probs = data->probs;
-    real_t* N = data->N;
     real_t res = 0.0f;
-    real_t* v = data->variance;
-    int32_t dimsXl = dims * l;
 
-    k_temp = (cols * rows * l);
-    for(int r = rowStart; r < rowEnd; r++)
+    for(size_t b = blockStart; b < blockEnd; b++)
     {
-      k_ = k_temp + (cols * r);
-      k2_temp = (dims * cols * r);
-      for(int c = colStart; c < colEnd; c++)
+      size_t rowStart = b * rowsPerBlock;
+      size_t rowEnd = std::min(rows, rowStart + rowsPerBlock);
+      double* sums = blockSums.data() + b * stride;
+      for(size_t l = 0; l < classes; l++)
       {
-        k2_ = k2_temp + (dims * c);
-        // numerator of (21)
-        lij = k_ + c;
-        for(int d = 0; d < dims; d++)
+        size_t dimsXl = dims * l;
+        size_t k_temp = cols * rows * l;
+        for(size_t r = rowStart; r < rowEnd; r++)
         {
-          ld = dimsXl + d;
-          ijd = k2_ + d;
-          res = y[ijd] - m[ld];
-          res = res * res; // Square to get the Variance
-          v[ld] += (res)*probs[lij];
+          size_t k_ = k_temp + (cols * r);
+          size_t k2_temp = dims * cols * r;
+          for(size_t c = 0; c < cols; c++)
+          {
+            // numerator of (21)
+            real_t p = probs[k_ + c];
+            for(size_t d = 0; d < dims; d++)
+            {
+              res = y[k2_temp + (dims * c) + d] - m[dimsXl + d];
+              res = res * res; // Square to get the Variance
+              sums[dimsXl + d] += res * p;
+            }
+          }
         }
       }
     }
+  }
 
-    if(N[l] != 0)
-    {
-      for(int d = 0; d < dims; d++)
-      {
-        ld = dims * l + d;
-        v[ld] = v[ld] / N[l];
-      }
-    }
+#if EMMPM_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    calc(r.begin(), r.end());
   }
+#endif
 
 private:
-  size_t l;
   EMMPM_Data* data;
+  size_t rowsPerBlock;
+  std::vector<double>& blockSums;
 };
 
 // -----------------------------------------------------------------------------
@@ -357,25 +386,85 @@ void EMMPMUtilities::UpdateMeansAndVariances(EMMPM_Data::Pointer dt)
   EMMPM_Data* data = dt.get();
 
   size_t l;
-  // size_t dims = data->dims;
+  size_t dims = data->dims;
   size_t rows = data->rows;
   size_t cols = data->columns;
   size_t classes = data->classes;
+  if(rows == 0 || cols == 0)
+  {
+    return;
+  }
+
+  size_t rowsPerBlock = std::max<size_t>(1, k_ReductionBlockPixels / cols);
+  size_t numBlocks = (rows + rowsPerBlock - 1) / rowsPerBlock;
 
   /*** Some efficiency was sacrificed for readability below ***/
   /* Update estimates for mean of each class - (Maximization) */
+  size_t meanStride = classes * (dims + 1);
+  std::vector<double> meanSums(numBlocks * meanStride, 0.0);
+  EstimateMeans estimateMeans(data, rowsPerBlock, meanSums);
+#if EMMPM_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numBlocks), estimateMeans, tbb::auto_partitioner());
+#else
+  estimateMeans.calc(0, numBlocks);
+#endif
+
+  std::vector<double> totals(meanStride, 0.0);
+  for(size_t b = 0; b < numBlocks; b++)
+  {
+    for(size_t i = 0; i < meanStride; i++)
+    {
+      totals[i] += meanSums[b * meanStride + i];
+    }
+  }
   for(l = 0; l < classes; l++)
   {
-    EstimateMeans estimateMeans(data, l);
-    estimateMeans.calc(0, rows, 0, cols);
+    data->N[l] += static_cast<real_t>(totals[l * (dims + 1)]);
+    for(size_t d = 0; d < dims; d++)
+    {
+      data->mean[dims * l + d] += static_cast<real_t>(totals[l * (dims + 1) + 1 + d]);
+    }
+    if(data->N[l] != 0)
+    {
+      for(size_t d = 0; d < dims; d++)
+      {
+        data->mean[dims * l + d] = data->mean[dims * l + d] / data->N[l];
+      }
+    }
   }
 
   // Eq. (20)}
   /* Update estimates of variance of each class */
+  size_t varianceStride = classes * dims;
+  std::vector<double> varianceSums(numBlocks * varianceStride, 0.0);
+  EstimateVariance estimateVariance(data, rowsPerBlock, varianceSums);
+#if EMMPM_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numBlocks), estimateVariance, tbb::auto_partitioner());
+#else
+  estimateVariance.calc(0, numBlocks);
+#endif
+
+  totals.assign(varianceStride, 0.0);
+  for(size_t b = 0; b < numBlocks; b++)
+  {
+    for(size_t i = 0; i < varianceStride; i++)
+    {
+      totals[i] += varianceSums[b * varianceStride + i];
+    }
+  }
   for(l = 0; l < classes; l++)
   {
-    EstimateVariance estimateVariance(data, l);
-    estimateVariance.calc(0, rows, 0, cols);
+    for(size_t d = 0; d < dims; d++)
+    {
+      data->variance[dims * l + d] += static_cast<real_t>(totals[dims * l + d]);
+    }
+    if(data->N[l] != 0)
+    {
+      for(size_t d = 0; d < dims; d++)
+      {
+        data->variance[dims * l + d] = data->variance[dims * l + d] / data->N[l];
+      }
+    }
   }
 
   // Make sure we don't fall below some minimum variance.
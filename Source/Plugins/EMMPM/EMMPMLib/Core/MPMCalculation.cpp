@@ -461,8 +461,11 @@ void MPMCalculation::execute()
     pcl.calc(0, rows, 0, cols);
 #endif
 
-    // std::cout << "Counter: " << counter << std::endl;
-    EMMPMUtilities::ConvertXtToOutputImage(getData());
+    // Only refresh the output image when the progress observer is going to look at it
+    if(m_StatsDelegate != nullptr && m_StatsDelegate->getRequiresOutputImage())
+    {
+      EMMPMUtilities::ConvertXtToOutputImage(getData());
+    }
 
     data->currentMPMLoop = k;
     QString ss = QString("MPM Loop %1").arg(k);
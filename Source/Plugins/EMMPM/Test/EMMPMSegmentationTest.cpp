@@ -39,16 +39,24 @@
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/Filtering/FilterFactory.hpp"
 #include "SIMPLib/Filtering/FilterManager.h"
 #include "SIMPLib/Filtering/FilterPipeline.h"
 #include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Plugin/ISIMPLibPlugin.h"
 #include "SIMPLib/Plugin/SIMPLibPluginLoader.h"
 #include "UnitTestSupport.hpp"
 
 #include "EMMPMTestFileLocations.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_arena.h>
+#endif
+
 class EMMPMSegmentationTest
 {
 public:
@@ -347,6 +355,117 @@ public:
     return EXIT_SUCCESS;
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  DataContainerArray::Pointer createVolumeTestData()
+  {
+    // A dark disk on a bright background whose radius and brightness drift through the stack
+    std::vector<size_t> tDims = {48, 40, 20};
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    DataContainer::Pointer dc = DataContainer::New("ImageDataContainer");
+    dca->addOrReplaceDataContainer(dc);
+    ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+    imageGeom->setDimensions(SizeVec3Type(tDims[0], tDims[1], tDims[2]));
+    dc->setGeometry(imageGeom);
+    AttributeMatrix::Pointer am = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+    dc->addOrReplaceAttributeMatrix(am);
+
+    UInt8ArrayType::Pointer imageData = UInt8ArrayType::CreateArray(tDims, std::vector<size_t>(1, 1), "ImageData", true);
+    am->addOrReplaceAttributeArray(imageData);
+    for(size_t z = 0; z < tDims[2]; z++)
+    {
+      int radius = 8 + static_cast<int>(z / 2);
+      for(size_t y = 0; y < tDims[1]; y++)
+      {
+        for(size_t x = 0; x < tDims[0]; x++)
+        {
+          int dx = static_cast<int>(x) - 24;
+          int dy = static_cast<int>(y) - 20;
+          int value = (dx * dx + dy * dy < radius * radius) ? 50 : 190;
+          value += static_cast<int>(2 * z + (x + y) % 5);
+          imageData->setValue((z * tDims[1] + y) * tDims[0] + x, static_cast<uint8_t>(value));
+        }
+      }
+    }
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  UInt8ArrayType::Pointer runVolumeSegmentation(DataContainerArray::Pointer dca, const QString& outputName, bool useNeighborSliceInitialization)
+  {
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName("EMMPMFilter");
+    DREAM3D_REQUIRE_VALID_POINTER(filterFactory.get())
+    AbstractFilter::Pointer filter = filterFactory->create();
+
+    QVariant var;
+    bool propWasSet;
+
+    var.setValue(DataArrayPath("ImageDataContainer", "CellData", "ImageData"));
+    propWasSet = filter->setProperty("InputDataArrayPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(DataArrayPath("ImageDataContainer", "CellData", outputName));
+    propWasSet = filter->setProperty("OutputDataArrayPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(true);
+    propWasSet = filter->setProperty("SegmentVolume", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(useNeighborSliceInitialization);
+    propWasSet = filter->setProperty("UseNeighborSliceInitialization", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    filter->setDataContainerArray(dca);
+    filter->execute();
+    DREAM3D_REQUIRE_EQUAL(filter->getErrorCode(), NO_ERROR)
+
+    return dca->getAttributeMatrix(DataArrayPath("ImageDataContainer", "CellData", ""))->getAttributeArrayAs<UInt8ArrayType>(outputName);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestEMMPMVolumeSegmentation()
+  {
+    DataContainerArray::Pointer dca = createVolumeTestData();
+
+    // The stack spans several slice blocks. Segment it with one thread and with more, so a different number of
+    // blocks runs at the same time, and require identical labels every time
+    for(bool useNeighborSliceInitialization : {false, true})
+    {
+      QString prefix = useNeighborSliceInitialization ? QString("Seeded") : QString("Unseeded");
+      UInt8ArrayType::Pointer labels = runVolumeSegmentation(dca, prefix + "Labels", useNeighborSliceInitialization);
+      DREAM3D_REQUIRE_VALID_POINTER(labels.get())
+
+      std::vector<int> threadCounts = {1, 3};
+      for(int threadCount : threadCounts)
+      {
+        QString outputName = prefix + QString("Labels_%1").arg(threadCount);
+        UInt8ArrayType::Pointer otherLabels;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+        tbb::task_arena arena(threadCount);
+        arena.execute([&] { otherLabels = runVolumeSegmentation(dca, outputName, useNeighborSliceInitialization); });
+#else
+        otherLabels = runVolumeSegmentation(dca, outputName, useNeighborSliceInitialization);
+#endif
+        DREAM3D_REQUIRE_VALID_POINTER(otherLabels.get())
+
+        size_t numTuples = labels->getNumberOfTuples();
+        for(size_t i = 0; i < numTuples; i++)
+        {
+          DREAM3D_REQUIRE_EQUAL(labels->getValue(i), otherLabels->getValue(i))
+        }
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -355,6 +474,7 @@ public:
 
     int err = EXIT_SUCCESS;
     DREAM3D_REGISTER_TEST(TestFilterAvailability());
+    DREAM3D_REGISTER_TEST(TestEMMPMVolumeSegmentation())
     if(m_ImageProcessingPluginLoaded)
     {
       DREAM3D_REGISTER_TEST(TestEMMPMSegmentation())
@@ -67,6 +67,14 @@ public:
   }
   virtual ~CLIStatsDelegate(){};
 
+  // -----------------------------------------------------------------------------
+  // reportProgress() writes the intermediate output image, so it has to be current
+  // -----------------------------------------------------------------------------
+  virtual bool getRequiresOutputImage() const
+  {
+    return true;
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -87,6 +87,10 @@ void EbsdToH5EbsdFilterParameter::readJson(const QJsonObject& json)
   m_Filter->setFileSuffix(json["FileSuffix"].toString());
   m_Filter->setFileExtension(json["FileExtension"].toString());
   m_Filter->setPaddingDigits(json["PaddingDigits"].toInt());
+  if(json.contains("MaxQueuedSlices"))
+  {
+    m_Filter->setMaxQueuedSlices(json["MaxQueuedSlices"].toInt());
+  }
 
   QJsonObject sampleTransObj = json["SampleTransformation"].toObject();
   AxisAngleInput sampleTrans;
@@ -114,6 +118,7 @@ void EbsdToH5EbsdFilterParameter::writeJson(QJsonObject& json) const
   json["FileSuffix"] = m_Filter->getFileSuffix();
   json["FileExtension"] = m_Filter->getFileExtension();
   json["PaddingDigits"] = m_Filter->getPaddingDigits();
+  json["MaxQueuedSlices"] = m_Filter->getMaxQueuedSlices();
 
   QJsonObject sampleTransObj;
   AxisAngleInput sampleTrans = m_Filter->getSampleTransformation();
@@ -165,7 +165,7 @@ void EbsdToH5EbsdWidget::setupGui()
 
   m_WidgetList << m_LineEdit << m_InputDirBtn << m_OutputFile << m_OutputFileBtn;
   m_WidgetList << m_FileExt << m_ErrorMessage << m_TotalDigits;
-  m_WidgetList << m_FilePrefix << m_TotalSlices << m_ZStartIndex << m_ZEndIndex << m_zSpacing;
+  m_WidgetList << m_FilePrefix << m_TotalSlices << m_ZStartIndex << m_ZEndIndex << m_zSpacing << m_MaxQueuedSlices;
   m_ErrorMessage->setVisible(false);
 
   m_StackingGroup = new QButtonGroup(this);
@@ -267,6 +267,7 @@ void EbsdToH5EbsdWidget::getGuiParametersFromFilter()
   m_ZStartIndex->setValue(m_Filter->getZStartIndex());
   m_ZEndIndex->setValue(m_Filter->getZEndIndex());
   m_zSpacing->setText(QString::number(m_Filter->getZResolution()));
+  m_MaxQueuedSlices->setValue(m_Filter->getMaxQueuedSlices());
   setRefFrameZDir(m_Filter->getRefFrameZDir());
 
   m_FilePrefix->setText(m_Filter->getFilePrefix());
@@ -466,6 +467,14 @@ void EbsdToH5EbsdWidget::on_m_zSpacing_textChanged(const QString& string)
   Q_EMIT parametersChanged();
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EbsdToH5EbsdWidget::on_m_MaxQueuedSlices_valueChanged(int value)
+{
+  Q_EMIT parametersChanged();
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -846,6 +855,7 @@ void EbsdToH5EbsdWidget::filterNeedsInputParameters(AbstractFilter* filter)
   ebsdConverter->setZStartIndex(m_ZStartIndex->text().toLongLong(&ok));
   ebsdConverter->setZEndIndex(m_ZEndIndex->text().toLongLong(&ok));
   ebsdConverter->setZResolution(m_zSpacing->text().toDouble(&ok));
+  ebsdConverter->setMaxQueuedSlices(m_MaxQueuedSlices->value());
   ebsdConverter->setRefFrameZDir(getRefFrameZDir());
 
   QString inputPath = m_LineEdit->text();
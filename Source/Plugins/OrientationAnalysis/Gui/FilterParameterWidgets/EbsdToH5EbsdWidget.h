@@ -107,6 +107,7 @@ protected Q_SLOTS:
   void on_m_ZStartIndex_valueChanged(int value);
   void on_m_ZEndIndex_valueChanged(int value);
   void on_m_zSpacing_textChanged(const QString& string);
+  void on_m_MaxQueuedSlices_valueChanged(int value);
 
   // slots to catch signals emitted by the various QLineEdit widgets
   void on_m_LineEdit_textChanged(const QString& text);
@@ -34,6 +34,14 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "EbsdToH5Ebsd.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <QtCore/QDir>
 #include <QtCore/QTextStream>
 
@@ -54,6 +62,266 @@ using namespace H5Support;
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+namespace
+{
+/**
+ * @brief The PipelinedAngImporter class exposes the slice writer of the H5AngImporter so that a
+ * slice that was already parsed by a worker thread can be written without reading the file again.
+ */
+class PipelinedAngImporter : public H5AngImporter
+{
+public:
+  PipelinedAngImporter() = default;
+  ~PipelinedAngImporter() override = default;
+
+  using H5AngImporter::writeSliceData;
+};
+
+/**
+ * @brief The PipelinedCtfImporter class exposes the slice writer of the H5CtfImporter so that a
+ * slice that was already parsed by a worker thread can be written without reading the file again.
+ */
+class PipelinedCtfImporter : public H5CtfImporter
+{
+public:
+  PipelinedCtfImporter() = default;
+  ~PipelinedCtfImporter() override = default;
+
+  using H5CtfImporter::writeSliceData;
+};
+
+/**
+ * @brief checkParsedSlice Applies the same validation to a parsed .ang slice that H5AngImporter::importFile performs
+ */
+int32_t checkParsedSlice(AngReader& reader, QString& message)
+{
+  if(reader.getGrid() == EbsdLib::Ang::HexGrid)
+  {
+    message = QObject::tr("The .ang file '%1' uses a hexagonal grid. Please convert the file to a square grid before importing it.").arg(QString::fromStdString(reader.getFileName()));
+    return -400;
+  }
+  return 0;
+}
+
+/**
+ * @brief checkParsedSlice .ctf slices need no validation beyond a successful read
+ */
+int32_t checkParsedSlice(CtfReader& reader, QString& message)
+{
+  Q_UNUSED(reader)
+  Q_UNUSED(message)
+  return 0;
+}
+
+void getSliceGeometry(AngReader& reader, int64_t& xDim, int64_t& yDim, float& xRes, float& yRes)
+{
+  xDim = reader.getXDimension();
+  yDim = reader.getYDimension();
+  xRes = reader.getXStep();
+  yRes = reader.getYStep();
+}
+
+void getSliceGeometry(CtfReader& reader, int64_t& xDim, int64_t& yDim, float& xRes, float& yRes)
+{
+  xDim = reader.getXCells();
+  yDim = reader.getYCells();
+  xRes = reader.getXStep();
+  yRes = reader.getYStep();
+}
+
+/**
+ * @brief The SliceParsePipeline class parses a list of EBSD files on a set of worker threads while a
+ * single consumer takes the parsed slices back in file order. At most maxQueuedSlices slices that have
+ * not yet been taken are parsed or held in memory at any time.
+ */
+template <typename ReaderType>
+class SliceParsePipeline
+{
+public:
+  SliceParsePipeline(const QVector<QString>& fileList, size_t first, size_t maxQueuedSlices)
+  : m_FileList(fileList)
+  , m_MaxQueuedSlices(maxQueuedSlices)
+  , m_NextToParse(first)
+  , m_NextToTake(first)
+  , m_Readers(static_cast<size_t>(fileList.size()))
+  , m_Errors(static_cast<size_t>(fileList.size()), 0)
+  , m_ErrorMessages(static_cast<size_t>(fileList.size()))
+  , m_Parsed(static_cast<size_t>(fileList.size()), 0)
+  {
+    size_t numThreads = std::thread::hardware_concurrency();
+    // Leave one core for the HDF5 writer
+    numThreads = (numThreads > 2) ? numThreads - 1 : 1;
+    numThreads = std::min(numThreads, m_MaxQueuedSlices);
+    for(size_t i = 0; i < numThreads; i++)
+    {
+      m_Workers.emplace_back(&SliceParsePipeline::parseSlices, this);
+    }
+  }
+
+  ~SliceParsePipeline()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_Condition.notify_all();
+    for(auto& worker : m_Workers)
+    {
+      worker.join();
+    }
+  }
+
+  SliceParsePipeline(const SliceParsePipeline&) = delete;            // Copy Constructor Not Implemented
+  SliceParsePipeline(SliceParsePipeline&&) = delete;                 // Move Constructor Not Implemented
+  SliceParsePipeline& operator=(const SliceParsePipeline&) = delete; // Copy Assignment Not Implemented
+  SliceParsePipeline& operator=(SliceParsePipeline&&) = delete;      // Move Assignment Not Implemented
+
+  /**
+   * @brief take Blocks until the slice at the given index has been parsed and hands it to the caller. Slices
+   * must be taken in increasing order.
+   * @param index Index into the file list
+   * @param err The error code reported by the reader
+   * @param errorMessage The error message reported by the reader
+   * @return The reader holding the parsed slice, or nullptr if the slice could not be read
+   */
+  std::unique_ptr<ReaderType> take(size_t index, int32_t& err, std::string& errorMessage)
+  {
+    std::unique_ptr<ReaderType> reader;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Condition.wait(lock, [this, index] { return m_Parsed[index] != 0; });
+      reader = std::move(m_Readers[index]);
+      err = m_Errors[index];
+      errorMessage = std::move(m_ErrorMessages[index]);
+      m_NextToTake = index + 1;
+    }
+    m_Condition.notify_all();
+    return reader;
+  }
+
+private:
+  const QVector<QString>& m_FileList;
+  size_t m_MaxQueuedSlices = 1;
+  size_t m_NextToParse = 0;
+  size_t m_NextToTake = 0;
+  bool m_Stop = false;
+  std::vector<std::unique_ptr<ReaderType>> m_Readers;
+  std::vector<int32_t> m_Errors;
+  std::vector<std::string> m_ErrorMessages;
+  std::vector<uint8_t> m_Parsed;
+  std::vector<std::thread> m_Workers;
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+
+  void parseSlices()
+  {
+    const size_t numFiles = m_Readers.size();
+    while(true)
+    {
+      size_t index = 0;
+      std::string fileName;
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this, numFiles] { return m_Stop || m_NextToParse >= numFiles || m_NextToParse < m_NextToTake + m_MaxQueuedSlices; });
+        if(m_Stop || m_NextToParse >= numFiles)
+        {
+          return;
+        }
+        index = m_NextToParse++;
+        fileName = m_FileList[static_cast<int>(index)].toStdString();
+      }
+
+      std::unique_ptr<ReaderType> reader(new ReaderType());
+      reader->setFileName(fileName);
+      int32_t err = reader->readFile();
+      // Keep the reader's own diagnostics, the same ones the importer reports for a serially read slice, and
+      // release the failed slice right away
+      std::string errorMessage;
+      if(err < 0)
+      {
+        if(reader->getErrorCode() < 0)
+        {
+          err = reader->getErrorCode();
+        }
+        errorMessage = reader->getErrorMessage();
+        reader.reset();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Readers[index] = std::move(reader);
+        m_Errors[index] = err;
+        m_ErrorMessages[index] = std::move(errorMessage);
+        m_Parsed[index] = 1;
+      }
+      m_Condition.notify_all();
+    }
+  }
+};
+
+/**
+ * @brief importSlicesPipelined Converts the files starting at index 'first' of the file list. The files are parsed
+ * ahead by a SliceParsePipeline and written to the HDF5 file in stacking order on the calling thread.
+ * @return Negative value if an error occurred. The error condition has already been set on the filter.
+ */
+template <typename ReaderType, typename ImporterType>
+int32_t importSlicesPipelined(EbsdToH5Ebsd* filter, hid_t fileId, const QVector<QString>& fileList, size_t first, size_t maxQueuedSlices, int64_t& z, int64_t& biggestxDim, int64_t& biggestyDim,
+                              float& xRes, float& yRes, int32_t& totalSlicesImported, QVector<int32_t>& indices)
+{
+  ImporterType importer;
+  SliceParsePipeline<ReaderType> pipeline(fileList, first, maxQueuedSlices);
+  const size_t numFiles = static_cast<size_t>(fileList.size());
+  for(size_t i = first; i < numFiles; i++)
+  {
+    QString ebsdFName = fileList[static_cast<int>(i)];
+    filter->notifyStatusMessage("Converting File: " + ebsdFName);
+
+    int32_t err = 0;
+    std::string errorMessage;
+    std::unique_ptr<ReaderType> reader = pipeline.take(i, err, errorMessage);
+    if(err < 0)
+    {
+      QString ss = QString::fromStdString(errorMessage);
+      if(ss.isEmpty())
+      {
+        ss = QObject::tr("The file '%1' could not be read. The reader returned error code %2").arg(ebsdFName).arg(err);
+      }
+      filter->setErrorCondition(err, ss);
+      return err;
+    }
+    QString message;
+    err = checkParsedSlice(*reader, message);
+    if(err < 0)
+    {
+      filter->setErrorCondition(err, message);
+      return err;
+    }
+
+    err = importer.writeSliceData(fileId, *reader, static_cast<int>(z), 0);
+    if(err < 0)
+    {
+      QString ss = QObject::tr("Could not write dataset for slice to HDF5 file");
+      filter->setErrorCondition(-1, ss);
+      return -1;
+    }
+    totalSlicesImported++;
+
+    int64_t xDim = 0, yDim = 0;
+    getSliceGeometry(*reader, xDim, yDim, xRes, yRes);
+    biggestxDim = std::max(biggestxDim, xDim);
+    biggestyDim = std::max(biggestyDim, yDim);
+
+    indices.push_back(static_cast<int32_t>(z));
+    ++z;
+    if(filter->getCancel())
+    {
+      return 0;
+    }
+  }
+  return 0;
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -103,6 +371,7 @@ void EbsdToH5Ebsd::readFilterParameters(AbstractFilterParametersReader* reader,
   setFileSuffix(reader->readString("FileSuffix", getFileSuffix()));
   setFileExtension(reader->readString("FileExtension", getFileExtension()));
   setPaddingDigits(reader->readValue("PaddingDigits", getPaddingDigits()));
+  setMaxQueuedSlices(reader->readValue("MaxQueuedSlices", getMaxQueuedSlices()));
   setSampleTransformation(reader->readAxisAngle("SampleTransformation", getSampleTransformation(), -1));
   setEulerTransformation(reader->readAxisAngle("EulerTransformation", getEulerTransformation(), -1));
   reader->closeFilterGroup();
@@ -301,6 +570,7 @@ void EbsdToH5Ebsd::execute()
       FilePathGenerator::GenerateFileList(m_ZStartIndex, m_ZEndIndex, increment, hasMissingFiles, stackLowToHigh, m_InputPath, m_FilePrefix, m_FileSuffix, m_FileExtension, m_PaddingDigits);
 
   EbsdImporter::Pointer fileImporter;
+  bool ctfIs3D = false;
 
   // Write the Manufacturer of the OIM file here
   // This list will grow to be the number of EBSD file formats we support
@@ -330,6 +600,7 @@ void EbsdToH5Ebsd::execute()
     CtfReader ctfReader;
     ctfReader.setFileName(fileList.front().toStdString());
     err = ctfReader.readHeaderOnly();
+    ctfIs3D = ctfReader.getZCells() > 1;
     if(ctfReader.getZCells() > 1 && fileList.size() == 1)
     {
       m_ZStartIndex = 0;
@@ -379,7 +650,13 @@ void EbsdToH5Ebsd::execute()
   int64_t biggestxDim = 0;
   int64_t biggestyDim = 0;
   int32_t totalSlicesImported = 0;
-  for(QVector<QString>::iterator filepath = fileList.begin(); filepath != fileList.end(); ++filepath)
+
+  // The first file always goes through the importer so that it can write any file level meta data. The
+  // remaining files are parsed ahead on worker threads while this thread writes the slices in stacking order.
+  size_t maxQueuedSlices = (m_MaxQueuedSlices > 1) ? static_cast<size_t>(m_MaxQueuedSlices) : 1;
+  bool pipelineSlices = maxQueuedSlices > 1 && fileList.size() > 1 && !ctfIs3D;
+  QVector<QString>::iterator serialEnd = pipelineSlices ? fileList.begin() + 1 : fileList.end();
+  for(QVector<QString>::iterator filepath = fileList.begin(); filepath != serialEnd; ++filepath)
   {
     QString ebsdFName = *filepath;
     progress = static_cast<int32_t>(z - m_ZStartIndex);
@@ -420,6 +697,22 @@ void EbsdToH5Ebsd::execute()
     }
   }
 
+  if(pipelineSlices)
+  {
+    if(ext == EbsdLib::Ang::FileExt)
+    {
+      err = importSlicesPipelined<AngReader, PipelinedAngImporter>(this, fileId, fileList, 1, maxQueuedSlices, z, biggestxDim, biggestyDim, xRes, yRes, totalSlicesImported, indices);
+    }
+    else
+    {
+      err = importSlicesPipelined<CtfReader, PipelinedCtfImporter>(this, fileId, fileList, 1, maxQueuedSlices, z, biggestxDim, biggestyDim, xRes, yRes, totalSlicesImported, indices);
+    }
+    if(err < 0 || getCancel())
+    {
+      return;
+    }
+  }
+
   // Write Z index start, Z index end and Z Spacing to the HDF5 file
   err = H5Lite::writeScalarDataset(fileId, EbsdLib::H5Ebsd::ZStartIndex, m_ZStartIndex);
   if(err < 0)
@@ -494,6 +787,7 @@ AbstractFilter::Pointer EbsdToH5Ebsd::newFilterInstance(bool copyFilterParameter
     filter->setFileSuffix(getFileSuffix());
     filter->setFileExtension(getFileExtension());
     filter->setPaddingDigits(getPaddingDigits());
+    filter->setMaxQueuedSlices(getMaxQueuedSlices());
     filter->setSampleTransformation(getSampleTransformation());
     filter->setEulerTransformation(getEulerTransformation());
   }
@@ -707,6 +1001,18 @@ int EbsdToH5Ebsd::getPaddingDigits() const
   return m_PaddingDigits;
 }
 
+// -----------------------------------------------------------------------------
+void EbsdToH5Ebsd::setMaxQueuedSlices(int value)
+{
+  m_MaxQueuedSlices = value;
+}
+
+// -----------------------------------------------------------------------------
+int EbsdToH5Ebsd::getMaxQueuedSlices() const
+{
+  return m_MaxQueuedSlices;
+}
+
 // -----------------------------------------------------------------------------
 void EbsdToH5Ebsd::setSampleTransformation(const AxisAngleInput& value)
 {
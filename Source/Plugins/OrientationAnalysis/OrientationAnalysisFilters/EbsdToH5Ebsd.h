@@ -65,6 +65,7 @@ class OrientationAnalysis_EXPORT EbsdToH5Ebsd : public AbstractFilter
   PYB11_PROPERTY(QString FileSuffix READ getFileSuffix WRITE setFileSuffix)
   PYB11_PROPERTY(QString FileExtension READ getFileExtension WRITE setFileExtension)
   PYB11_PROPERTY(int PaddingDigits READ getPaddingDigits WRITE setPaddingDigits)
+  PYB11_PROPERTY(int MaxQueuedSlices READ getMaxQueuedSlices WRITE setMaxQueuedSlices)
   PYB11_PROPERTY(int64_t ZStartIndex READ getZStartIndex WRITE setZStartIndex)
   PYB11_PROPERTY(int64_t ZEndIndex READ getZEndIndex WRITE setZEndIndex)
   PYB11_PROPERTY(float ZResolution READ getZResolution WRITE setZResolution)
@@ -203,6 +204,17 @@ public:
    */
   int getPaddingDigits() const;
 
+  /**
+   * @brief Setter property for MaxQueuedSlices. This is the number of slices that may be
+   * parsed ahead of the HDF5 writer. Values of 1 or less convert the slices serially.
+   */
+  void setMaxQueuedSlices(int value);
+  /**
+   * @brief Getter property for MaxQueuedSlices
+   * @return Value of MaxQueuedSlices
+   */
+  int getMaxQueuedSlices() const;
+
   /**
    * @brief Setter property for SampleTransformation
    */
@@ -312,6 +324,7 @@ private:
   QString m_FileSuffix = {""};
   QString m_FileExtension = {"ang"};
   int m_PaddingDigits = {4};
+  int m_MaxQueuedSlices = {8};
   AxisAngleInput m_SampleTransformation = {};
   AxisAngleInput m_EulerTransformation = {};
 };
@@ -34,14 +34,21 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindAvgOrientations.h"
 
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArrayCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "EbsdLib/Core/Orientation.hpp"
 #include "EbsdLib/Core/OrientationTransformation.hpp"
@@ -51,6 +58,136 @@
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+namespace
+{
+// The symmetry aligned quaternions are summed as 64 bit fixed point values. Integer addition does not depend on
+// the order of the terms, so the averages come out bit for bit the same for any number of threads. 2^30 leaves room
+// for more than 8 billion cells per feature.
+constexpr double k_FixedPointScale = 1073741824.0;
+
+/**
+ * @brief The FindReferenceCellsImpl class finds the lowest index cell with a valid phase of every feature. Its
+ * quaternion serves as the reference orientation of the feature.
+ */
+class FindReferenceCellsImpl
+{
+public:
+  FindReferenceCellsImpl(const int32_t* featureIds, const int32_t* cellPhases, std::vector<std::atomic<size_t>>& referenceCells)
+  : m_FeatureIds(featureIds)
+  , m_CellPhases(cellPhases)
+  , m_ReferenceCells(referenceCells)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      if(m_FeatureIds[i] > 0 && m_CellPhases[i] > 0)
+      {
+        std::atomic<size_t>& reference = m_ReferenceCells[m_FeatureIds[i]];
+        size_t current = reference.load();
+        while(i < current && !reference.compare_exchange_weak(current, i))
+        {
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  const int32_t* m_CellPhases;
+  std::vector<std::atomic<size_t>>& m_ReferenceCells;
+};
+
+/**
+ * @brief The AccumulateAlignedQuatsImpl class sums, for every feature, the cell quaternions rotated to their
+ * symmetric equivalent nearest the feature's reference orientation. Runs of cells that belong to the same feature
+ * are summed locally and then added to the shared per feature sums with one atomic add per component.
+ */
+class AccumulateAlignedQuatsImpl
+{
+public:
+  AccumulateAlignedQuatsImpl(const int32_t* featureIds, const int32_t* cellPhases, const float* quats, const uint32_t* crystalStructures, const std::vector<std::atomic<size_t>>& referenceCells,
+                             std::vector<std::atomic<int64_t>>& featureSums)
+  : m_FeatureIds(featureIds)
+  , m_CellPhases(cellPhases)
+  , m_Quats(quats)
+  , m_CrystalStructures(crystalStructures)
+  , m_ReferenceCells(referenceCells)
+  , m_FeatureSums(featureSums)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    std::vector<LaueOps::Pointer> orientationOps = LaueOps::GetAllOrientationOps();
+    std::array<float, 4> nearest = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    // Each feature gets 4 quaternion component sums and a cell count
+    std::array<int64_t, 5> runSums = {0, 0, 0, 0, 0};
+    int32_t runFeature = 0;
+    for(size_t i = start; i < end; i++)
+    {
+      int32_t featureId = m_FeatureIds[i];
+      if(featureId <= 0 || m_CellPhases[i] <= 0)
+      {
+        continue;
+      }
+      if(featureId != runFeature)
+      {
+        flush(runFeature, runSums);
+        runFeature = featureId;
+      }
+      const float* referenceQuatPtr = m_Quats + m_ReferenceCells[featureId].load() * 4;
+      QuatF referenceQuat(referenceQuatPtr[0], referenceQuatPtr[1], referenceQuatPtr[2], referenceQuatPtr[3]);
+      const float* currentVoxelQuatPtr = m_Quats + i * 4;
+      QuatF voxquat(currentVoxelQuatPtr[0], currentVoxelQuatPtr[1], currentVoxelQuatPtr[2], currentVoxelQuatPtr[3]);
+      QuatF nearestQuat = orientationOps[m_CrystalStructures[m_CellPhases[i]]]->getNearestQuat(referenceQuat, voxquat);
+      nearestQuat.copyInto(nearest.data(), QuatF::Order::VectorScalar);
+
+      for(size_t c = 0; c < 4; c++)
+      {
+        runSums[c] += std::llround(static_cast<double>(nearest[c]) * k_FixedPointScale);
+      }
+      runSums[4]++;
+    }
+    flush(runFeature, runSums);
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  const int32_t* m_CellPhases;
+  const float* m_Quats;
+  const uint32_t* m_CrystalStructures;
+  const std::vector<std::atomic<size_t>>& m_ReferenceCells;
+  std::vector<std::atomic<int64_t>>& m_FeatureSums;
+
+  void flush(int32_t featureId, std::array<int64_t, 5>& runSums) const
+  {
+    if(runSums[4] == 0)
+    {
+      return;
+    }
+    for(size_t c = 0; c < 5; c++)
+    {
+      m_FeatureSums[featureId * 5 + c].fetch_add(runSums[c], std::memory_order_relaxed);
+      runSums[c] = 0;
+    }
+  }
+};
+} // namespace
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -74,6 +211,7 @@ FindAvgOrientations::~FindAvgOrientations() = default;
 void FindAvgOrientations::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Average Against Reference Orientation in Parallel", UseReferenceOrientation, FilterParameter::Category::Parameter, FindAvgOrientations));
   parameters.push_back(SeparatorFilterParameter::Create("Element Data", FilterParameter::Category::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::Int32, 1, AttributeMatrix::Category::Element);
@@ -117,6 +255,7 @@ void FindAvgOrientations::readFilterParameters(AbstractFilterParametersReader* r
   setQuatsArrayPath(reader->readDataArrayPath("QuatsArrayPath", getQuatsArrayPath()));
   setCellPhasesArrayPath(reader->readDataArrayPath("CellPhasesArrayPath", getCellPhasesArrayPath()));
   setFeatureIdsArrayPath(reader->readDataArrayPath("FeatureIdsArrayPath", getFeatureIdsArrayPath()));
+  setUseReferenceOrientation(reader->readValue("UseReferenceOrientation", getUseReferenceOrientation()));
   reader->closeFilterGroup();
 }
 
@@ -224,6 +363,12 @@ void FindAvgOrientations::execute()
   // Initialize all Euler Angles to Zero
   m_FeatureEulerAnglesPtr.lock()->initializeWithZeros();
 
+  if(m_UseReferenceOrientation)
+  {
+    averageAgainstReferenceOrientations();
+    return;
+  }
+
   for(size_t i = 0; i < totalPoints; i++)
   {
     if(m_FeatureIds[i] > 0 && m_CellPhases[i] > 0)
@@ -258,6 +403,60 @@ void FindAvgOrientations::execute()
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FindAvgOrientations::averageAgainstReferenceOrientations()
+{
+  size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
+  size_t totalFeatures = m_AvgQuatsPtr.lock()->getNumberOfTuples();
+
+  // Pass one: the first cell of every feature provides its reference orientation
+  std::vector<std::atomic<size_t>> referenceCells(totalFeatures);
+  for(auto& reference : referenceCells)
+  {
+    reference.store(totalPoints);
+  }
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, totalPoints);
+    dataAlg.execute(FindReferenceCellsImpl(m_FeatureIds, m_CellPhases, referenceCells));
+  }
+
+  // Pass two: sum the quaternions nearest to the reference orientations. All threads add into one set of
+  // per feature sums, so the memory does not grow with the number of threads.
+  std::vector<std::atomic<int64_t>> totals(totalFeatures * 5);
+  for(auto& total : totals)
+  {
+    total.store(0);
+  }
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, totalPoints);
+    dataAlg.execute(AccumulateAlignedQuatsImpl(m_FeatureIds, m_CellPhases, m_Quats, m_CrystalStructures, referenceCells, totals));
+  }
+
+  for(size_t i = 1; i < totalFeatures; i++)
+  {
+    int64_t count = totals[i * 5 + 4].load();
+    if(count == 0)
+    {
+      continue;
+    }
+    float* avgQuatsPtr = m_AvgQuats + i * 4;
+    for(size_t c = 0; c < 4; c++)
+    {
+      avgQuatsPtr[c] = static_cast<float>(static_cast<double>(totals[i * 5 + c].load()) / k_FixedPointScale / static_cast<double>(count));
+    }
+    QuatF qAvg(avgQuatsPtr[0], avgQuatsPtr[1], avgQuatsPtr[2], avgQuatsPtr[3]);
+    qAvg = qAvg.unitQuaternion();
+    qAvg.copyInto(avgQuatsPtr, QuatF::Order::VectorScalar);
+
+    OrientationF eu = OrientationTransformation::qu2eu<Quaternion<float>, Orientation<float>>(qAvg);
+    eu.copyInto(m_FeatureEulerAngles + (3 * i), 3);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -418,6 +617,18 @@ DataArrayPath FindAvgOrientations::getAvgQuatsArrayPath() const
   return m_AvgQuatsArrayPath;
 }
 
+// -----------------------------------------------------------------------------
+void FindAvgOrientations::setUseReferenceOrientation(bool value)
+{
+  m_UseReferenceOrientation = value;
+}
+
+// -----------------------------------------------------------------------------
+bool FindAvgOrientations::getUseReferenceOrientation() const
+{
+  return m_UseReferenceOrientation;
+}
+
 // -----------------------------------------------------------------------------
 void FindAvgOrientations::setAvgEulerAnglesArrayPath(const DataArrayPath& value)
 {
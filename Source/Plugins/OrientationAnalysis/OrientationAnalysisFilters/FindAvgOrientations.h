@@ -65,6 +65,7 @@ class OrientationAnalysis_EXPORT FindAvgOrientations : public AbstractFilter
   PYB11_PROPERTY(DataArrayPath CrystalStructuresArrayPath READ getCrystalStructuresArrayPath WRITE setCrystalStructuresArrayPath)
   PYB11_PROPERTY(DataArrayPath AvgQuatsArrayPath READ getAvgQuatsArrayPath WRITE setAvgQuatsArrayPath)
   PYB11_PROPERTY(DataArrayPath AvgEulerAnglesArrayPath READ getAvgEulerAnglesArrayPath WRITE setAvgEulerAnglesArrayPath)
+  PYB11_PROPERTY(bool UseReferenceOrientation READ getUseReferenceOrientation WRITE setUseReferenceOrientation)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -164,6 +165,17 @@ public:
   DataArrayPath getAvgEulerAnglesArrayPath() const;
   Q_PROPERTY(DataArrayPath AvgEulerAnglesArrayPath READ getAvgEulerAnglesArrayPath WRITE setAvgEulerAnglesArrayPath)
 
+  /**
+   * @brief Setter property for UseReferenceOrientation
+   */
+  void setUseReferenceOrientation(bool value);
+  /**
+   * @brief Getter property for UseReferenceOrientation
+   * @return Value of UseReferenceOrientation
+   */
+  bool getUseReferenceOrientation() const;
+  Q_PROPERTY(bool UseReferenceOrientation READ getUseReferenceOrientation WRITE setUseReferenceOrientation)
+
   /**
    * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
@@ -236,6 +248,14 @@ protected:
    */
   void initialize();
 
+  /**
+   * @brief averageAgainstReferenceOrientations Computes the average orientations in two parallel passes. The
+   * first cell of each feature provides a reference orientation and every cell quaternion is moved to its
+   * symmetric equivalent nearest that reference before it is summed. The result does not depend on the
+   * number of threads.
+   */
+  void averageAgainstReferenceOrientations();
+
 private:
   std::weak_ptr<DataArray<int32_t>> m_FeatureIdsPtr;
   int32_t* m_FeatureIds = nullptr;
@@ -256,6 +276,7 @@ private:
   DataArrayPath m_CrystalStructuresArrayPath = {SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::CrystalStructures};
   DataArrayPath m_AvgQuatsArrayPath = {SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::AvgQuats};
   DataArrayPath m_AvgEulerAnglesArrayPath = {SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::CellData::EulerAngles};
+  bool m_UseReferenceOrientation = {false};
 
   LaueOpsContainer m_OrientationOps;
 
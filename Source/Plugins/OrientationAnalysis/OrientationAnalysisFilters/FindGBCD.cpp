@@ -60,8 +60,10 @@
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
 
-#include <utility>
+#include <algorithm>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
 #include <tbb/blocked_range.h>
@@ -81,67 +83,87 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID31 = 31,
 };
 
-namespace
-{
-const size_t k_NumMisoReps = 576 * 4;
-
-} // namespace
-
 /**
  * @brief The CalculateGBCDImpl class implements a threaded algorithm that calculates the
- * grain boundary character distribution (GBCD) for a surface mesh
+ * grain boundary character distribution (GBCD) for a surface mesh. Each block of triangles is
+ * split into a fixed number of contiguous slots and every slot bins its triangles directly into
+ * its own per-phase GBCD histogram, so no per-triangle intermediate bins are needed.
  */
 class CalculateGBCDImpl
 {
-  size_t m_TriangleChunkStartIndex;
-  size_t m_NumBinPerTriangle;
+  size_t m_BlockStart;
+  size_t m_BlockEnd;
+  size_t m_NumSlots;
+  size_t m_TotalPhases;
+  size_t m_TotalGBCDBins;
+  std::vector<std::vector<double>>& m_SlotGBCD;
+  std::vector<double>& m_SlotFaceArea;
   Int32ArrayType::Pointer m_LabelsArray;
   DoubleArrayType::Pointer m_NormalsArray;
+  DoubleArrayType::Pointer m_AreasArray;
   Int32ArrayType::Pointer m_PhasesArray;
   FloatArrayType::Pointer m_EulersArray;
 
   FloatArrayType::Pointer m_GbcdDeltasArray;
   FloatArrayType::Pointer m_GbcdLimitsArray;
   Int32ArrayType::Pointer m_GbcdSizesArray;
-  Int32ArrayType::Pointer m_GbcdBinsArray;
-  BoolArrayType::Pointer m_GbcdHemiCheckArray;
 
   UInt32ArrayType::Pointer m_CrystalStructuresArray;
   LaueOpsContainer m_OrientationOps;
 
 public:
-  CalculateGBCDImpl(size_t i, size_t numMisoReps, Int32ArrayType::Pointer labels, DoubleArrayType::Pointer normals, FloatArrayType::Pointer eulers, Int32ArrayType::Pointer phases,
-                    UInt32ArrayType::Pointer crystalStructures, Int32ArrayType::Pointer bins, BoolArrayType::Pointer hemiCheck, FloatArrayType::Pointer gbcdDeltas, Int32ArrayType::Pointer gbcdSizes,
-                    FloatArrayType::Pointer gbcdLimits)
-  : m_TriangleChunkStartIndex(i)
-  , m_NumBinPerTriangle(numMisoReps)
+  CalculateGBCDImpl(size_t blockStart, size_t blockEnd, size_t numSlots, size_t totalPhases, size_t totalGBCDBins, std::vector<std::vector<double>>& slotGBCD, std::vector<double>& slotFaceArea,
+                    Int32ArrayType::Pointer labels, DoubleArrayType::Pointer normals, DoubleArrayType::Pointer areas, FloatArrayType::Pointer eulers, Int32ArrayType::Pointer phases,
+                    UInt32ArrayType::Pointer crystalStructures, FloatArrayType::Pointer gbcdDeltas, Int32ArrayType::Pointer gbcdSizes, FloatArrayType::Pointer gbcdLimits)
+  : m_BlockStart(blockStart)
+  , m_BlockEnd(blockEnd)
+  , m_NumSlots(numSlots)
+  , m_TotalPhases(totalPhases)
+  , m_TotalGBCDBins(totalGBCDBins)
+  , m_SlotGBCD(slotGBCD)
+  , m_SlotFaceArea(slotFaceArea)
   , m_LabelsArray(std::move(labels))
   , m_NormalsArray(std::move(normals))
+  , m_AreasArray(std::move(areas))
   , m_PhasesArray(std::move(phases))
   , m_EulersArray(std::move(eulers))
   , m_GbcdDeltasArray(std::move(gbcdDeltas))
   , m_GbcdLimitsArray(std::move(gbcdLimits))
   , m_GbcdSizesArray(std::move(gbcdSizes))
-  , m_GbcdBinsArray(std::move(bins))
-  , m_GbcdHemiCheckArray(std::move(hemiCheck))
   , m_CrystalStructuresArray(std::move(crystalStructures))
   {
     m_OrientationOps = LaueOps::GetAllOrientationOps();
   }
   virtual ~CalculateGBCDImpl() = default;
 
-  void generate(size_t start, size_t end) const
+  /**
+   * @brief accumulateSlots Bins the triangles of the slots [startSlot, endSlot). A slot always covers the
+   * same contiguous triangle range of the block and only ever writes its own histograms.
+   * @param startSlot
+   * @param endSlot
+   */
+  void accumulateSlots(size_t startSlot, size_t endSlot) const
+  {
+    size_t blockSize = m_BlockEnd - m_BlockStart;
+    for(size_t slot = startSlot; slot < endSlot; slot++)
+    {
+      size_t start = m_BlockStart + (blockSize * slot) / m_NumSlots;
+      size_t end = m_BlockStart + (blockSize * (slot + 1)) / m_NumSlots;
+      generate(slot, start, end);
+    }
+  }
+
+  void generate(size_t slot, size_t start, size_t end) const
   {
 
     // We want to work with the raw pointers for speed so get those pointers.
     float* gbcdDeltas = m_GbcdDeltasArray->getPointer(0);
     float* gbcdLimits = m_GbcdLimitsArray->getPointer(0);
     int* gbcdSizes = m_GbcdSizesArray->getPointer(0);
-    int32_t* gbcdBins = m_GbcdBinsArray->getPointer(0);
-    bool* hemiCheck = m_GbcdHemiCheckArray->getPointer(0);
 
     int32_t* labels = m_LabelsArray->getPointer(0);
     double* normals = m_NormalsArray->getPointer(0);
+    double* areas = m_AreasArray->getPointer(0);
     int32_t* phases = m_PhasesArray->getPointer(0);
     float* eulers = m_EulersArray->getPointer(0);
     uint32_t* crystalStructures = m_CrystalStructuresArray->getPointer(0);
@@ -167,10 +189,6 @@ public:
 
     for(size_t triangleIndex = start; triangleIndex < end; triangleIndex++)
     {
-      size_t minGbcdBinIndex = (triangleIndex - m_TriangleChunkStartIndex) * m_NumBinPerTriangle;
-      // size_t maxGbcdBinIndex = minGbcdBinIndex + m_NumBinPerTriangle;
-
-      int32_t SYMcounter = 0;
       feature1 = labels[2 * triangleIndex];
       feature2 = labels[2 * triangleIndex + 1];
       normal[0] = normals[3 * triangleIndex];
@@ -184,6 +202,14 @@ public:
 
       if(phases[feature1] == phases[feature2] && phases[feature1] > 0)
       {
+        double area = areas[triangleIndex];
+        size_t histIndex = slot * m_TotalPhases + phases[feature1];
+        std::vector<double>& gbcd = m_SlotGBCD[histIndex];
+        if(gbcd.empty())
+        {
+          gbcd.resize(m_TotalGBCDBins, 0.0);
+        }
+        double& faceArea = m_SlotFaceArea[histIndex];
         uint32_t cryst = crystalStructures[phases[feature1]];
         for(int32_t q = 0; q < 2; q++)
         {
@@ -247,27 +273,19 @@ public:
                 gbcd_index = GBCDIndex(gbcdDeltas, gbcdSizes, gbcdLimits, euler_mis, sqCoord);
                 if(gbcd_index != -1)
                 {
-                  size_t gbcdBinIndex = minGbcdBinIndex + SYMcounter;
-                  hemiCheck[gbcdBinIndex] = nhCheck;
-                  gbcdBins[gbcdBinIndex] = gbcd_index;
+                  gbcd[2 * gbcd_index + (nhCheck ? 0 : 1)] += area;
+                  faceArea += area;
                 }
-                SYMcounter++;
                 if(inversion == 1)
                 {
                   gbcd_index = GBCDIndex(gbcdDeltas, gbcdSizes, gbcdLimits, euler_mis, sqCoordInv);
                   if(gbcd_index != -1)
                   {
-                    size_t gbcdBinIndex = minGbcdBinIndex + SYMcounter;
-                    hemiCheck[gbcdBinIndex] = nhCheckInv;
-                    gbcdBins[gbcdBinIndex] = gbcd_index;
+                    gbcd[2 * gbcd_index + (nhCheckInv ? 0 : 1)] += area;
+                    faceArea += area;
                   }
-                  SYMcounter++;
                 }
               }
-              else
-              {
-                SYMcounter += 2;
-              }
             }
           }
         }
@@ -278,7 +296,7 @@ public:
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
   void operator()(const tbb::blocked_range<size_t>& r) const
   {
-    generate(r.begin(), r.end());
+    accumulateSlots(r.begin(), r.end());
   }
 #endif
 
@@ -373,8 +391,6 @@ FindGBCD::FindGBCD()
   m_GbcdDeltasArray = FloatArrayType::NullPointer();
   m_GbcdSizesArray = Int32ArrayType::NullPointer();
   m_GbcdLimitsArray = FloatArrayType::NullPointer();
-  m_GbcdBinsArray = Int32ArrayType::NullPointer();
-  m_GbcdHemiCheckArray = BoolArrayType::NullPointer();
 }
 
 // -----------------------------------------------------------------------------
@@ -455,14 +471,10 @@ void FindGBCD::initialize()
   m_GbcdDeltasArray = FloatArrayType::NullPointer();
   m_GbcdSizesArray = Int32ArrayType::NullPointer();
   m_GbcdLimitsArray = FloatArrayType::NullPointer();
-  m_GbcdBinsArray = Int32ArrayType::NullPointer();
-  m_GbcdHemiCheckArray = BoolArrayType::NullPointer();
 
   m_GbcdDeltas = nullptr;
   m_GbcdSizes = nullptr;
   m_GbcdLimits = nullptr;
-  m_GbcdBins = nullptr;
-  m_HemiCheck = nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -508,8 +520,8 @@ void FindGBCD::dataCheckSurfaceMesh()
     m_SurfaceMeshFaceAreas = m_SurfaceMeshFaceAreasPtr.lock()->getPointer(0);
   } /* Now assign the raw pointer to data from the DataArray<T> object */
 
-  // call the sizeGBCD function to get the GBCD ranges, dimensions, etc.  Note that the input parameters do not affect the size and can be dummy values here;
-  sizeGBCD(0, 0);
+  // call the sizeGBCD function to get the GBCD ranges, dimensions, etc.
+  sizeGBCD();
   cDims.resize(6);
   cDims[0] = m_GbcdSizes[0];
   cDims[1] = m_GbcdSizes[1];
@@ -593,22 +605,25 @@ void FindGBCD::execute()
   {
     triangleChunkSize = totalFaces;
   }
-  // call the sizeGBCD function with proper chunkSize and numMisoReps to get Bins array set up properly
-  sizeGBCD(triangleChunkSize, k_NumMisoReps);
+  // call the sizeGBCD function to get the GBCD ranges and dimensions set up properly
+  sizeGBCD();
   int32_t totalGBCDBins = m_GbcdSizes[0] * m_GbcdSizes[1] * m_GbcdSizes[2] * m_GbcdSizes[3] * m_GbcdSizes[4] * 2;
 
+  // Every slot owns a private GBCD histogram (allocated on first use) and face area per phase. The
+  // slot count is fixed up front so each triangle always lands in the same slot and the final merge
+  // below sums the slots in the same order no matter how the threads are scheduled.
+  size_t numSlots = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  numSlots = std::max(1U, std::thread::hardware_concurrency());
+#endif
+  std::vector<std::vector<double>> slotGBCD(numSlots * totalPhases);
+  std::vector<double> slotFaceArea(numSlots * totalPhases, 0.0);
+
   uint64_t millis = QDateTime::currentMSecsSinceEpoch();
   uint64_t currentMillis = millis;
   uint64_t startMillis = millis;
   uint64_t estimatedTime = 0;
 
-  int32_t hemisphere = 0;
-
-  // create an array to hold the total face area for each phase and initialize the array to 0.0
-  DoubleArrayType::Pointer totalFaceAreaPtr = DoubleArrayType::CreateArray(totalPhases, std::string("totalFaceArea"), true);
-  totalFaceAreaPtr->initializeWithValue(0.0);
-  double* totalFaceArea = totalFaceAreaPtr->getPointer(0);
-
   QString ss = QObject::tr("1/2 Starting GBCD Calculation and Summation Phase");
   notifyStatusMessage(ss);
 
@@ -624,53 +639,15 @@ void FindGBCD::execute()
     {
       triangleChunkSize = totalFaces - i;
     }
-    m_GbcdBinsArray->initializeWithValue(-1);
-    m_GbcdHemiCheckArray->initializeWithValue(false);
+    CalculateGBCDImpl impl(i, i + triangleChunkSize, numSlots, totalPhases, totalGBCDBins, slotGBCD, slotFaceArea, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(),
+                           m_SurfaceMeshFaceAreasPtr.lock(), m_FeatureEulerAnglesPtr.lock(), m_FeaturePhasesPtr.lock(), m_CrystalStructuresPtr.lock(), m_GbcdDeltasArray, m_GbcdSizesArray,
+                           m_GbcdLimitsArray);
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-    tbb::parallel_for(tbb::blocked_range<size_t>(i, i + triangleChunkSize, triangleChunkSize / std::thread::hardware_concurrency()),
-                      CalculateGBCDImpl(i, k_NumMisoReps, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(), m_FeatureEulerAnglesPtr.lock(), m_FeaturePhasesPtr.lock(),
-                                        m_CrystalStructuresPtr.lock(), m_GbcdBinsArray, m_GbcdHemiCheckArray, m_GbcdDeltasArray, m_GbcdSizesArray, m_GbcdLimitsArray));
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlots, 1), impl, tbb::simple_partitioner());
 #else
-    CalculateGBCDImpl serial(i, k_NumMisoReps, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(), m_FeatureEulerAnglesPtr.lock(), m_FeaturePhasesPtr.lock(),
-                             m_CrystalStructuresPtr.lock(), m_GbcdBinsArray, m_GbcdHemiCheckArray, m_GbcdDeltasArray, m_GbcdSizesArray, m_GbcdLimitsArray);
-    serial.generate(i, i + triangleChunkSize);
+    impl.accumulateSlots(0, numSlots);
 #endif
 
-    if(getCancel())
-    {
-      return;
-    }
-
-    int32_t phase = 0;
-    int32_t feature = 0;
-    double area = 0.0;
-    for(size_t j = 0; j < triangleChunkSize; j++)
-    {
-      area = m_SurfaceMeshFaceAreas[i + j];
-      feature = m_SurfaceMeshFaceLabels[2 * (i + j)];
-      if(feature < 0)
-      {
-        continue;
-      }
-      phase = m_FeaturePhases[feature];
-      for(size_t k = 0; k < k_NumMisoReps; k++)
-      {
-        size_t gbcdBinIdx = (j * k_NumMisoReps) + k;
-        if(m_GbcdBins[gbcdBinIdx] >= 0)
-        {
-          hemisphere = 0;
-          if(!m_HemiCheck[gbcdBinIdx])
-          {
-            hemisphere = 1;
-          }
-
-          size_t gbcdIdx = (phase * totalGBCDBins) + (2 * m_GbcdBins[gbcdBinIdx] + hemisphere);
-          m_GBCD[gbcdIdx] += area;
-          totalFaceArea[phase] += area;
-        }
-      }
-    }
-
     currentMillis = QDateTime::currentMSecsSinceEpoch();
     if(currentMillis - millis > 1000)
     {
@@ -684,6 +661,37 @@ void FindGBCD::execute()
     }
   }
 
+  if(getCancel())
+  {
+    return;
+  }
+
+  // create an array to hold the total face area for each phase and initialize the array to 0.0
+  DoubleArrayType::Pointer totalFaceAreaPtr = DoubleArrayType::CreateArray(totalPhases, std::string("totalFaceArea"), true);
+  totalFaceAreaPtr->initializeWithValue(0.0);
+  double* totalFaceArea = totalFaceAreaPtr->getPointer(0);
+
+  // merge the slot histograms into the GBCD, always in slot order
+  for(size_t slot = 0; slot < numSlots; slot++)
+  {
+    for(size_t phase = 0; phase < totalPhases; phase++)
+    {
+      size_t histIndex = slot * totalPhases + phase;
+      std::vector<double>& gbcd = slotGBCD[histIndex];
+      if(gbcd.empty())
+      {
+        continue;
+      }
+      double* phaseGBCD = m_GBCD + phase * totalGBCDBins;
+      for(int32_t j = 0; j < totalGBCDBins; j++)
+      {
+        phaseGBCD[j] += gbcd[j];
+      }
+      totalFaceArea[phase] += slotFaceArea[histIndex];
+      std::vector<double>().swap(gbcd);
+    }
+  }
+
   ss = QObject::tr("2/2 Starting GBCD Normalization Phase");
   notifyStatusMessage(ss);
 
@@ -703,7 +711,7 @@ void FindGBCD::execute()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void FindGBCD::sizeGBCD(size_t faceChunkSize, size_t numMisoReps)
+void FindGBCD::sizeGBCD()
 {
   m_GbcdDeltasArray = FloatArrayType::CreateArray(5, std::string("GBCDDeltas"), true);
   m_GbcdDeltasArray->initializeWithZeros();
@@ -711,17 +719,10 @@ void FindGBCD::sizeGBCD(size_t faceChunkSize, size_t numMisoReps)
   m_GbcdLimitsArray->initializeWithZeros();
   m_GbcdSizesArray = Int32ArrayType::CreateArray(5, std::string("GBCDSizes"), true);
   m_GbcdSizesArray->initializeWithZeros();
-  std::vector<size_t> cDims(1, numMisoReps);
-  m_GbcdBinsArray = Int32ArrayType::CreateArray(faceChunkSize, cDims, "GBCDBins", true);
-  m_GbcdBinsArray->initializeWithZeros();
-  m_GbcdHemiCheckArray = BoolArrayType::CreateArray(faceChunkSize, cDims, "GBCDHemiCheck", true);
-  m_GbcdHemiCheckArray->initializeWithValue(false);
 
   m_GbcdDeltas = m_GbcdDeltasArray->getPointer(0);
   m_GbcdSizes = m_GbcdSizesArray->getPointer(0);
   m_GbcdLimits = m_GbcdLimitsArray->getPointer(0);
-  m_GbcdBins = m_GbcdBinsArray->getPointer(0);
-  m_HemiCheck = m_GbcdHemiCheckArray->getPointer(0);
 
   // Original Ranges from Dave R.
   // m_GBCDlimits[0] = 0.0f;
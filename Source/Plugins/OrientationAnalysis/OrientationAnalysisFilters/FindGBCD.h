@@ -292,10 +292,8 @@ protected:
 
   /**
    * @brief sizeGBCD Determines the sizing for the GBCD arrays
-   * @param faceChunkSize Number of triangles per chunk
-   * @param numMisoReps Dimensionality for bins
    */
-  void sizeGBCD(size_t faceChunkSize, size_t numMisoReps);
+  void sizeGBCD();
 
 private:
   std::weak_ptr<DataArray<double>> m_SurfaceMeshFaceAreasPtr;
@@ -327,14 +325,10 @@ private:
   FloatArrayType::Pointer m_GbcdDeltasArray;
   Int32ArrayType::Pointer m_GbcdSizesArray;
   FloatArrayType::Pointer m_GbcdLimitsArray;
-  Int32ArrayType::Pointer m_GbcdBinsArray;
-  BoolArrayType::Pointer m_GbcdHemiCheckArray;
 
   float* m_GbcdDeltas;
   int32_t* m_GbcdSizes;
   float* m_GbcdLimits;
-  int32_t* m_GbcdBins;
-  bool* m_HemiCheck;
 
 public:
   FindGBCD(const FindGBCD&) = delete;            // Copy Constructor Not Implemented
@@ -44,6 +44,8 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindGBCDMetricBased.h"
 
+#include <algorithm>
+
 #include <QtCore/QDir>
 #include <QtCore/QTextStream>
 
@@ -335,10 +337,11 @@ class ProbeDistrib
   std::vector<float> samplPtsY;
   std::vector<float> samplPtsZ;
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  tbb::concurrent_vector<TriAreaAndNormals> selectedTris;
+  const tbb::concurrent_vector<TriAreaAndNormals>& selectedTris;
 #else
-  QVector<TriAreaAndNormals> selectedTris;
+  const QVector<TriAreaAndNormals>& selectedTris;
 #endif
+  const OrientationUtilities::UnitVectorGrid& grain1NormalsGrid;
   float planeResolSq;
   double totalFaceArea;
   int numDistinctGBs;
@@ -348,17 +351,18 @@ class ProbeDistrib
 public:
   ProbeDistrib(std::vector<double>* __distribValues, std::vector<double>* __errorValues, std::vector<float> __samplPtsX, std::vector<float> __samplPtsY, std::vector<float> __samplPtsZ,
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-               tbb::concurrent_vector<TriAreaAndNormals> __selectedTris,
+               const tbb::concurrent_vector<TriAreaAndNormals>& __selectedTris,
 #else
-               QVector<TriAreaAndNormals> __selectedTris,
+               const QVector<TriAreaAndNormals>& __selectedTris,
 #endif
-               float __planeResolSq, double __totalFaceArea, int __numDistinctGBs, double __ballVolume, const Matrix3fR& __gFixedT)
+               const OrientationUtilities::UnitVectorGrid& __grain1NormalsGrid, float __planeResolSq, double __totalFaceArea, int __numDistinctGBs, double __ballVolume, const Matrix3fR& __gFixedT)
   : distribValues(__distribValues)
   , errorValues(__errorValues)
   , samplPtsX(__samplPtsX)
   , samplPtsY(__samplPtsY)
   , samplPtsZ(__samplPtsZ)
   , selectedTris(__selectedTris)
+  , grain1NormalsGrid(__grain1NormalsGrid)
   , planeResolSq(__planeResolSq)
   , totalFaceArea(__totalFaceArea)
   , numDistinctGBs(__numDistinctGBs)
@@ -371,34 +375,49 @@ public:
 
   void probe(size_t start, size_t end) const
   {
+    std::vector<size_t> neighbors;
+    std::vector<size_t> candidates;
     for(size_t ptIdx = start; ptIdx < end; ptIdx++)
     {
       Eigen::Vector3f fixedNormal1 = {samplPtsX.at(ptIdx), samplPtsY.at(ptIdx), samplPtsZ.at(ptIdx)};
       Eigen::Vector3f fixedNormal2 = {0.0f, 0.0f, 0.0f};
       fixedNormal2 = gFixedT * fixedNormal1;
 
-      for(int triRepresIdx = 0; triRepresIdx < static_cast<int>(selectedTris.size()); triRepresIdx++)
+      // Only triangles whose first normal lies within sqrt(2) * planeResol of +/- fixedNormal1 can pass the distance
+      // test below, so gather those as (triangle, inversion) keys and visit them in the original loop order
+      candidates.clear();
+      for(int inversion = 0; inversion <= 1; inversion++)
       {
-        for(int inversion = 0; inversion <= 1; inversion++)
+        float sign = (inversion == 1) ? -1.0f : 1.0f;
+        neighbors.clear();
+        grain1NormalsGrid.findCandidates(sign * fixedNormal1[0], sign * fixedNormal1[1], sign * fixedNormal1[2], neighbors);
+        for(size_t triRepresIdx : neighbors)
         {
-          float sign = 1.0f;
-          if(inversion == 1)
-          {
-            sign = -1.0f;
-          }
+          candidates.push_back(2 * triRepresIdx + inversion);
+        }
+      }
+      std::sort(candidates.begin(), candidates.end());
 
-          float theta1 = acosf(sign * (selectedTris[triRepresIdx].normal_grain1_x * fixedNormal1[0] + selectedTris[triRepresIdx].normal_grain1_y * fixedNormal1[1] +
-                                       selectedTris[triRepresIdx].normal_grain1_z * fixedNormal1[2]));
+      for(size_t candidate : candidates)
+      {
+        size_t triRepresIdx = candidate / 2;
+        float sign = 1.0f;
+        if(candidate % 2 == 1)
+        {
+          sign = -1.0f;
+        }
 
-          float theta2 = acosf(-sign * (selectedTris[triRepresIdx].normal_grain2_x * fixedNormal2[0] + selectedTris[triRepresIdx].normal_grain2_y * fixedNormal2[1] +
-                                        selectedTris[triRepresIdx].normal_grain2_z * fixedNormal2[2]));
+        float theta1 = acosf(sign * (selectedTris[triRepresIdx].normal_grain1_x * fixedNormal1[0] + selectedTris[triRepresIdx].normal_grain1_y * fixedNormal1[1] +
+                                     selectedTris[triRepresIdx].normal_grain1_z * fixedNormal1[2]));
 
-          float distSq = 0.5f * (theta1 * theta1 + theta2 * theta2);
+        float theta2 = acosf(-sign * (selectedTris[triRepresIdx].normal_grain2_x * fixedNormal2[0] + selectedTris[triRepresIdx].normal_grain2_y * fixedNormal2[1] +
+                                      selectedTris[triRepresIdx].normal_grain2_z * fixedNormal2[2]));
 
-          if(distSq < planeResolSq)
-          {
-            (*distribValues)[ptIdx] += selectedTris[triRepresIdx].area;
-          }
+        float distSq = 0.5f * (theta1 * theta1 + theta2 * theta2);
+
+        if(distSq < planeResolSq)
+        {
+          (*distribValues)[ptIdx] += selectedTris[triRepresIdx].area;
         }
       }
 
@@ -945,6 +964,16 @@ void FindGBCDMetricBased::execute()
   std::vector<double> distribValues(samplPtsX.size(), 0.0);
   std::vector<double> errorValues(samplPtsX.size(), 0.0);
 
+  // Bucket the first normal of every selected triangle once so each sampling point only visits nearby triangles
+  std::vector<float> grain1Normals(3 * selectedTris.size());
+  for(size_t triRepresIdx = 0; triRepresIdx < selectedTris.size(); triRepresIdx++)
+  {
+    grain1Normals[3 * triRepresIdx] = selectedTris[triRepresIdx].normal_grain1_x;
+    grain1Normals[3 * triRepresIdx + 1] = selectedTris[triRepresIdx].normal_grain1_y;
+    grain1Normals[3 * triRepresIdx + 2] = selectedTris[triRepresIdx].normal_grain1_z;
+  }
+  OrientationUtilities::UnitVectorGrid grain1NormalsGrid(grain1Normals, std::sqrt(2.0 * m_PlaneResolSq));
+
   int32_t pointsChunkSize = 100;
   if(samplPtsX.size() < pointsChunkSize)
   {
@@ -968,13 +997,13 @@ void FindGBCDMetricBased::execute()
     if(doParallel)
     {
       tbb::parallel_for(tbb::blocked_range<size_t>(i, i + pointsChunkSize),
-                        GBCDMetricBased::ProbeDistrib(&distribValues, &errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, m_PlaneResolSq, totalFaceArea, numDistinctGBs, ballVolume, gFixedT),
+                        GBCDMetricBased::ProbeDistrib(&distribValues, &errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, grain1NormalsGrid, m_PlaneResolSq, totalFaceArea, numDistinctGBs, ballVolume, gFixedT),
                         tbb::auto_partitioner());
     }
     else
 #endif
     {
-      GBCDMetricBased::ProbeDistrib serial(&distribValues, &errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, m_PlaneResolSq, totalFaceArea, numDistinctGBs, ballVolume, gFixedT);
+      GBCDMetricBased::ProbeDistrib serial(&distribValues, &errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, grain1NormalsGrid, m_PlaneResolSq, totalFaceArea, numDistinctGBs, ballVolume, gFixedT);
       serial.probe(i, i + pointsChunkSize);
     }
   }
@@ -45,6 +45,8 @@
 
 #include "FindGBPDMetricBased.h"
 
+#include <algorithm>
+
 #include <QtCore/QDir>
 #include <QtCore/QTextStream>
 
@@ -139,6 +141,7 @@ class TrisSelector
   LaueOpsContainer m_OrientationOps;
   uint32_t cryst;
   int32_t nsym;
+  std::vector<Matrix3dR> symOps;
   float* m_Eulers = nullptr;
   int32_t* m_Phases = nullptr;
   int32_t* m_FaceLabels = nullptr;
@@ -258,10 +261,11 @@ class ProbeDistrib
   std::vector<double>& samplPtsY;
   std::vector<double>& samplPtsZ;
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  tbb::concurrent_vector<TriAreaAndNormals> selectedTris;
+  const tbb::concurrent_vector<TriAreaAndNormals>& selectedTris;
 #else
-  std::vector<TriAreaAndNormals> selectedTris;
+  const std::vector<TriAreaAndNormals>& selectedTris;
 #endif
+  const OrientationUtilities::UnitVectorGrid& normalsGrid;
   double limitDist;
   double totalFaceArea;
   int numDistinctGBs;
@@ -269,22 +273,24 @@ class ProbeDistrib
   LaueOpsContainer m_OrientationOps;
   uint32_t cryst;
   int32_t nsym;
+  std::vector<Matrix3dR> symOps;
 
 public:
   ProbeDistrib(std::vector<double>& __distribValues, std::vector<double>& __errorValues,
                std::vector<double>& __samplPtsX, std::vector<double>& __samplPtsY, std::vector<double>& __samplPtsZ,
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-               tbb::concurrent_vector<TriAreaAndNormals> __selectedTris,
+               const tbb::concurrent_vector<TriAreaAndNormals>& __selectedTris,
 #else
-               std::vector<TriAreaAndNormals> __selectedTris,
+               const std::vector<TriAreaAndNormals>& __selectedTris,
 #endif
-               double __limitDist, double __totalFaceArea, int __numDistinctGBs, double __ballVolume, int32_t __cryst)
+               const OrientationUtilities::UnitVectorGrid& __normalsGrid, double __limitDist, double __totalFaceArea, int __numDistinctGBs, double __ballVolume, int32_t __cryst)
   : distribValues(__distribValues)
   , errorValues(__errorValues)
   , samplPtsX(__samplPtsX)
   , samplPtsY(__samplPtsY)
   , samplPtsZ(__samplPtsZ)
   , selectedTris(__selectedTris)
+  , normalsGrid(__normalsGrid)
   , limitDist(__limitDist)
   , totalFaceArea(__totalFaceArea)
   , numDistinctGBs(__numDistinctGBs)
@@ -293,67 +299,79 @@ public:
   {
     m_OrientationOps = LaueOps::GetAllOrientationOps();
     nsym = m_OrientationOps[__cryst]->getNumSymOps();
+    symOps.resize(nsym);
+    for(int j = 0; j < nsym; j++)
+    {
+      symOps[j] = EbsdLibMatrixToEigenMatrix(m_OrientationOps[cryst]->getMatSymOpD(j));
+    }
   }
 
   virtual ~ProbeDistrib() = default;
 
   void probe(size_t start, size_t end) const
   {
+    std::vector<size_t> neighbors;
+    std::vector<size_t> candidates;
     for(size_t ptIdx = start; ptIdx < end; ptIdx++)
     {
       double __c = 0.0;
 
       double probeNormal[3] = {samplPtsX[ptIdx], samplPtsY[ptIdx], samplPtsZ[ptIdx]};
+      Eigen::Vector3d probe = {probeNormal[0], probeNormal[1], probeNormal[2]};
 
-      for(int triRepresIdx = 0; triRepresIdx < static_cast<int>(selectedTris.size()); triRepresIdx++)
+      // The angle between sym * normal and the probe equals the angle between the normal and transpose(sym) * probe,
+      // so only the normals bucketed near +/- transpose(sym) * probe can be within limitDist. They are collected as
+      // (triangle, symmetry, inversion, normal) keys and summed in the same order as a loop over all triangles would.
+      candidates.clear();
+      for(int j = 0; j < nsym; j++)
       {
-        Eigen::Vector3d normal1 = {selectedTris[triRepresIdx].normal_grain1_x, selectedTris[triRepresIdx].normal_grain1_y, selectedTris[triRepresIdx].normal_grain1_z};
-
-        Eigen::Vector3d normal2 = {selectedTris[triRepresIdx].normal_grain2_x, selectedTris[triRepresIdx].normal_grain2_y, selectedTris[triRepresIdx].normal_grain2_z};
+        Eigen::Vector3d rotatedProbe = symOps[j].transpose() * probe;
+        for(int inversion = 0; inversion <= 1; inversion++)
+        {
+          double sign = (inversion == 1) ? -1.0 : 1.0;
+          neighbors.clear();
+          normalsGrid.findCandidates(sign * rotatedProbe[0], sign * rotatedProbe[1], sign * rotatedProbe[2], neighbors);
+          for(size_t normalIdx : neighbors)
+          {
+            size_t triRepresIdx = normalIdx / 2;
+            candidates.push_back(((triRepresIdx * nsym + j) * 2 + inversion) * 2 + normalIdx % 2);
+          }
+        }
+      }
+      std::sort(candidates.begin(), candidates.end());
 
-        Matrix3dR sym;
-        sym.fill(0.0);
+      for(size_t candidate : candidates)
+      {
+        size_t whichNormal = candidate % 2;
+        size_t inversion = (candidate / 2) % 2;
+        size_t j = (candidate / 4) % nsym;
+        size_t triRepresIdx = candidate / 4 / nsym;
 
-        for(int j = 0; j < nsym; j++)
+        Eigen::Vector3d normal = {selectedTris[triRepresIdx].normal_grain1_x, selectedTris[triRepresIdx].normal_grain1_y, selectedTris[triRepresIdx].normal_grain1_z};
+        if(whichNormal == 1)
         {
-          sym = EbsdLibMatrixToEigenMatrix(m_OrientationOps[cryst]->getMatSymOpD(j));
+          normal = {selectedTris[triRepresIdx].normal_grain2_x, selectedTris[triRepresIdx].normal_grain2_y, selectedTris[triRepresIdx].normal_grain2_z};
+        }
 
-          Eigen::Vector3d sym_normal1 = {0.0, 0.0, 0.0};
-          Eigen::Vector3d sym_normal2 = {0.0, 0.0, 0.0};
+        Eigen::Vector3d sym_normal = {0.0, 0.0, 0.0};
+        sym_normal = symOps[j] * normal;
 
-          sym_normal1 = sym * normal1;
-          sym_normal2 = sym * normal2;
+        double sign = 1.0f;
+        if(inversion == 1)
+        {
+          sign = -1.0f;
+        }
 
-          for(int inversion = 0; inversion <= 1; inversion++)
-          {
-            double sign = 1.0f;
-            if(inversion == 1)
-            {
-              sign = -1.0f;
-            }
-
-            double gamma1 = std::acos(sign * (probeNormal[0] * sym_normal1[0] + probeNormal[1] * sym_normal1[1] + probeNormal[2] * sym_normal1[2]));
-
-            double gamma2 = std::acos(sign * (probeNormal[0] * sym_normal2[0] + probeNormal[1] * sym_normal2[1] + probeNormal[2] * sym_normal2[2]));
-
-            if(gamma1 < limitDist)
-            {
-              // Kahan summation algorithm
-              double __y = selectedTris[triRepresIdx].area - __c;
-              double __t = distribValues[ptIdx] + __y;
-              __c = (__t - distribValues[ptIdx]);
-              __c -= __y;
-              distribValues[ptIdx] = __t;
-            }
-            if(gamma2 < limitDist)
-            {
-              double __y = selectedTris[triRepresIdx].area - __c;
-              double __t = distribValues[ptIdx] + __y;
-              __c = (__t - distribValues[ptIdx]);
-              __c -= __y;
-              distribValues[ptIdx] = __t;
-            }
-          }
+        double gamma = std::acos(sign * (probeNormal[0] * sym_normal[0] + probeNormal[1] * sym_normal[1] + probeNormal[2] * sym_normal[2]));
+
+        if(gamma < limitDist)
+        {
+          // Kahan summation algorithm
+          double __y = selectedTris[triRepresIdx].area - __c;
+          double __t = distribValues[ptIdx] + __y;
+          __c = (__t - distribValues[ptIdx]);
+          __c -= __y;
+          distribValues[ptIdx] = __t;
         }
       }
       errorValues[ptIdx] = std::sqrt(distribValues[ptIdx] / totalFaceArea / double(numDistinctGBs)) / ballVolume;
@@ -1023,6 +1041,19 @@ void FindGBPDMetricBased::execute()
   std::vector<double> distribValues(samplPtsX.size(), 0.0);
   std::vector<double> errorValues(samplPtsX.size(), 0.0);
 
+  // Bucket both normals of every selected triangle once so each sampling point only visits nearby triangles
+  std::vector<float> triNormals(6 * selectedTris.size());
+  for(size_t triRepresIdx = 0; triRepresIdx < selectedTris.size(); triRepresIdx++)
+  {
+    triNormals[6 * triRepresIdx] = static_cast<float>(selectedTris[triRepresIdx].normal_grain1_x);
+    triNormals[6 * triRepresIdx + 1] = static_cast<float>(selectedTris[triRepresIdx].normal_grain1_y);
+    triNormals[6 * triRepresIdx + 2] = static_cast<float>(selectedTris[triRepresIdx].normal_grain1_z);
+    triNormals[6 * triRepresIdx + 3] = static_cast<float>(selectedTris[triRepresIdx].normal_grain2_x);
+    triNormals[6 * triRepresIdx + 4] = static_cast<float>(selectedTris[triRepresIdx].normal_grain2_y);
+    triNormals[6 * triRepresIdx + 5] = static_cast<float>(selectedTris[triRepresIdx].normal_grain2_z);
+  }
+  OrientationUtilities::UnitVectorGrid normalsGrid(triNormals, limitDist);
+
   int32_t pointsChunkSize = 20;
   if(samplPtsX.size() < pointsChunkSize)
   {
@@ -1046,13 +1077,13 @@ void FindGBPDMetricBased::execute()
     if(doParallel)
     {
       tbb::parallel_for(tbb::blocked_range<size_t>(i, i + pointsChunkSize),
-                        GBPDMetricBased::ProbeDistrib(distribValues, errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, limitDist, totalFaceArea, numDistinctGBs, ballVolume, cryst),
+                        GBPDMetricBased::ProbeDistrib(distribValues, errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, normalsGrid, limitDist, totalFaceArea, numDistinctGBs, ballVolume, cryst),
                         tbb::auto_partitioner());
     }
     else
 #endif
     {
-      GBPDMetricBased::ProbeDistrib serial(distribValues, errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, limitDist, totalFaceArea, numDistinctGBs, ballVolume, cryst);
+      GBPDMetricBased::ProbeDistrib serial(distribValues, errorValues, samplPtsX, samplPtsY, samplPtsZ, selectedTris, normalsGrid, limitDist, totalFaceArea, numDistinctGBs, ballVolume, cryst);
       serial.probe(i, i + pointsChunkSize);
     }
   }
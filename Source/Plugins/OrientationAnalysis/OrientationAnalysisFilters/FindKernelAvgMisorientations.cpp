@@ -35,12 +35,18 @@
 
 #include "FindKernelAvgMisorientations.h"
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/IntVec3FilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
@@ -58,12 +64,21 @@
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 namespace
 {
 static size_t s_InstanceIndex = 0;
 static std::map<size_t, int64_t> s_ProgressValues;
 static std::map<size_t, int64_t> s_LastProgressInt;
 
+// Upper bound on the number of cached pair angles of one tile, which bounds the pair caching memory per thread
+constexpr int64_t k_MaxCachedPairAngles = 1 << 21;
+
 class FindKernelAvgMisorientationsImpl
 {
 public:
@@ -210,6 +225,263 @@ private:
   const SizeVec3Type& m_UDims;
 };
 
+/**
+ * @brief The FindKernelAvgMisorientationsPairCacheImpl class computes the KAM over fixed size tiles of the volume.
+ * The quaternions, feature ids and phases of a tile plus a halo of one kernel radius are gathered into a local
+ * buffer, and the misorientation of each unordered pair of neighboring cells is computed once and cached for
+ * both cells. Pairs that cross a tile boundary are computed by both tiles. The kernel of each cell is then summed
+ * in the same order and precision as FindKernelAvgMisorientationsImpl.
+ */
+class FindKernelAvgMisorientationsPairCacheImpl
+{
+public:
+  FindKernelAvgMisorientationsPairCacheImpl(FindKernelAvgMisorientations* filter, const FloatArrayType& quatPtr, const Int32ArrayType& cellPhases, const Int32ArrayType& featureIds,
+                                            const UInt32ArrayType& crystalStructures, IntVec3Type& kernelSize, FloatArrayType& kernelAverageMisorientations, const SizeVec3Type& udims,
+                                            const std::array<int64_t, 3>& tileSize)
+  : m_Filter(filter)
+  , m_Quats(quatPtr)
+  , m_CellPhases(cellPhases)
+  , m_FeatureIds(featureIds)
+  , m_CrystalStructures(crystalStructures)
+  , m_KernelSize(kernelSize)
+  , m_KernelAverageMisorientations(kernelAverageMisorientations)
+  , m_UDims(udims)
+  , m_TileSize(tileSize)
+  {
+    for(size_t i = 0; i < 3; i++)
+    {
+      m_NumTiles[i] = (static_cast<int64_t>(m_UDims[i]) + m_TileSize[i] - 1) / m_TileSize[i];
+    }
+  }
+
+  size_t getNumberOfTiles() const
+  {
+    return static_cast<size_t>(m_NumTiles[0] * m_NumTiles[1] * m_NumTiles[2]);
+  }
+
+  void convert(size_t tileStart, size_t tileEnd) const
+  {
+    std::vector<LaueOps::Pointer> orientationOps = LaueOps::GetAllOrientationOps();
+
+    int64_t xPoints = static_cast<int64_t>(m_UDims[0]);
+    int64_t yPoints = static_cast<int64_t>(m_UDims[1]);
+    int64_t zPoints = static_cast<int64_t>(m_UDims[2]);
+    std::array<int64_t, 3> radius = {m_KernelSize[0], m_KernelSize[1], m_KernelSize[2]};
+    std::array<int64_t, 3> kernelDims = {2 * radius[0] + 1, 2 * radius[1] + 1, 2 * radius[2] + 1};
+
+    // Only the offsets that come after the center cell in x fastest order are stored; the others are covered by symmetry.
+    // kernelSlots maps every kernel offset to the slot of the forward offset that covers it
+    std::vector<std::array<int64_t, 3>> forwardOffsets;
+    std::vector<size_t> kernelSlots(static_cast<size_t>(kernelDims[0] * kernelDims[1] * kernelDims[2]), 0);
+    for(int64_t j = 0; j <= radius[2]; j++)
+    {
+      for(int64_t k = -radius[1]; k <= radius[1]; k++)
+      {
+        for(int64_t l = -radius[0]; l <= radius[0]; l++)
+        {
+          if(j > 0 || k > 0 || (k == 0 && l > 0))
+          {
+            kernelSlots[static_cast<size_t>(((j + radius[2]) * kernelDims[1] + (k + radius[1])) * kernelDims[0] + (l + radius[0]))] = forwardOffsets.size();
+            kernelSlots[static_cast<size_t>(((radius[2] - j) * kernelDims[1] + (radius[1] - k)) * kernelDims[0] + (radius[0] - l))] = forwardOffsets.size();
+            forwardOffsets.push_back({l, k, j});
+          }
+        }
+      }
+    }
+    size_t numForwardOffsets = forwardOffsets.size();
+
+    std::vector<QuatF> quats;
+    std::vector<int32_t> featureIds;
+    std::vector<uint8_t> validPhases;
+    std::vector<uint32_t> structures;
+    std::vector<float> cellAngles;
+    std::vector<float> neighborAngles;
+
+    for(size_t tile = tileStart; tile < tileEnd; tile++)
+    {
+      if(m_Filter->getCancel())
+      {
+        return;
+      }
+
+      std::array<int64_t, 3> tileIdx = {static_cast<int64_t>(tile) % m_NumTiles[0], (static_cast<int64_t>(tile) / m_NumTiles[0]) % m_NumTiles[1],
+                                        static_cast<int64_t>(tile) / (m_NumTiles[0] * m_NumTiles[1])};
+      std::array<int64_t, 3> tileMin = {0, 0, 0};
+      std::array<int64_t, 3> tileMax = {0, 0, 0};
+      std::array<int64_t, 3> boxMin = {0, 0, 0};
+      std::array<int64_t, 3> boxDims = {0, 0, 0};
+      for(size_t i = 0; i < 3; i++)
+      {
+        tileMin[i] = tileIdx[i] * m_TileSize[i];
+        tileMax[i] = std::min(tileMin[i] + m_TileSize[i], static_cast<int64_t>(m_UDims[i]));
+        boxMin[i] = std::max<int64_t>(0, tileMin[i] - radius[i]);
+        boxDims[i] = std::min(tileMax[i] + radius[i], static_cast<int64_t>(m_UDims[i])) - boxMin[i];
+      }
+
+      // Gather the tile plus its halo into the local buffer
+      size_t boxSize = static_cast<size_t>(boxDims[0] * boxDims[1] * boxDims[2]);
+      quats.resize(boxSize);
+      featureIds.resize(boxSize);
+      validPhases.resize(boxSize);
+      structures.resize(boxSize);
+      cellAngles.resize(boxSize * numForwardOffsets);
+      neighborAngles.resize(boxSize * numForwardOffsets);
+      for(int64_t z = 0; z < boxDims[2]; z++)
+      {
+        for(int64_t y = 0; y < boxDims[1]; y++)
+        {
+          for(int64_t x = 0; x < boxDims[0]; x++)
+          {
+            size_t local = static_cast<size_t>((z * boxDims[1] + y) * boxDims[0] + x);
+            size_t point = static_cast<size_t>(((boxMin[2] + z) * yPoints + (boxMin[1] + y)) * xPoints + (boxMin[0] + x));
+            float* currentQuatPtr = m_Quats.getTuplePointer(point);
+            quats[local] = QuatF(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+            featureIds[local] = m_FeatureIds[point];
+            validPhases[local] = static_cast<uint8_t>(m_CellPhases[point] > 0);
+            structures[local] = m_CrystalStructures[m_CellPhases[point]];
+          }
+        }
+      }
+
+      auto inTile = [&](int64_t x, int64_t y, int64_t z) {
+        return x + boxMin[0] >= tileMin[0] && x + boxMin[0] < tileMax[0] && y + boxMin[1] >= tileMin[1] && y + boxMin[1] < tileMax[1] && z + boxMin[2] >= tileMin[2] &&
+               z + boxMin[2] < tileMax[2];
+      };
+
+      // Compute the misorientation of each forward pair that a cell of the tile needs. cellAngles holds the angle seen from the
+      // first cell of the pair and neighborAngles the angle seen from the second; only the slots that are read later are written
+      for(int64_t z = 0; z < boxDims[2]; z++)
+      {
+        for(int64_t y = 0; y < boxDims[1]; y++)
+        {
+          for(int64_t x = 0; x < boxDims[0]; x++)
+          {
+            size_t local = static_cast<size_t>((z * boxDims[1] + y) * boxDims[0] + x);
+            int32_t featureId = featureIds[local];
+            if(featureId <= 0)
+            {
+              continue;
+            }
+            // A cell only collects the misorientations of its kernel if it has a valid phase
+            bool pointCollects = validPhases[local] != 0 && inTile(x, y, z);
+
+            for(size_t f = 0; f < numForwardOffsets; f++)
+            {
+              int64_t nx = x + forwardOffsets[f][0];
+              int64_t ny = y + forwardOffsets[f][1];
+              int64_t nz = z + forwardOffsets[f][2];
+              if(nx < 0 || nx >= boxDims[0] || ny < 0 || ny >= boxDims[1] || nz >= boxDims[2])
+              {
+                continue;
+              }
+              size_t neighbor = static_cast<size_t>((nz * boxDims[1] + ny) * boxDims[0] + nx);
+              if(featureIds[neighbor] != featureId)
+              {
+                continue;
+              }
+              bool neighborCollects = validPhases[neighbor] != 0 && inTile(nx, ny, nz);
+              size_t slot = local * numForwardOffsets + f;
+              if(pointCollects)
+              {
+                OrientationF axisAngle = orientationOps[structures[local]]->calculateMisorientation(quats[local], quats[neighbor]);
+                cellAngles[slot] = axisAngle[3];
+              }
+              if(neighborCollects)
+              {
+                // The misorientation angle is the same in both directions as long as both cells use the same symmetry
+                if(pointCollects && structures[local] == structures[neighbor])
+                {
+                  neighborAngles[slot] = cellAngles[slot];
+                }
+                else
+                {
+                  OrientationF axisAngle = orientationOps[structures[neighbor]]->calculateMisorientation(quats[neighbor], quats[local]);
+                  neighborAngles[slot] = axisAngle[3];
+                }
+              }
+            }
+          }
+        }
+      }
+
+      // Average the kernel of each cell of the tile, visiting the offsets and summing in the same order and precision as
+      // FindKernelAvgMisorientationsImpl so both modes produce the same values
+      for(int64_t z = tileMin[2]; z < tileMax[2]; z++)
+      {
+        for(int64_t y = tileMin[1]; y < tileMax[1]; y++)
+        {
+          for(int64_t x = tileMin[0]; x < tileMax[0]; x++)
+          {
+            size_t local = static_cast<size_t>(((z - boxMin[2]) * boxDims[1] + (y - boxMin[1])) * boxDims[0] + (x - boxMin[0]));
+            size_t point = static_cast<size_t>((z * yPoints + y) * xPoints + x);
+            if(featureIds[local] <= 0 || validPhases[local] == 0)
+            {
+              m_KernelAverageMisorientations[point] = 0.0f;
+              continue;
+            }
+
+            float totalmisorientation = 0.0f;
+            int32_t numVoxel = 0;
+            for(int64_t j = -radius[2]; j <= radius[2]; j++)
+            {
+              for(int64_t k = -radius[1]; k <= radius[1]; k++)
+              {
+                for(int64_t l = -radius[0]; l <= radius[0]; l++)
+                {
+                  if(z + j < 0 || z + j > zPoints - 1 || y + k < 0 || y + k > yPoints - 1 || x + l < 0 || x + l > xPoints - 1)
+                  {
+                    continue;
+                  }
+                  size_t neighbor = static_cast<size_t>((static_cast<int64_t>(local) + (j * boxDims[1] + k) * boxDims[0] + l));
+                  if(featureIds[neighbor] != featureIds[local])
+                  {
+                    continue;
+                  }
+                  float angle = 0.0f;
+                  if(j == 0 && k == 0 && l == 0)
+                  {
+                    OrientationF axisAngle = orientationOps[structures[local]]->calculateMisorientation(quats[local], quats[local]);
+                    angle = axisAngle[3];
+                  }
+                  else
+                  {
+                    size_t kernelSlot = kernelSlots[static_cast<size_t>(((j + radius[2]) * kernelDims[1] + (k + radius[1])) * kernelDims[0] + (l + radius[0]))];
+                    bool forward = j > 0 || (j == 0 && (k > 0 || (k == 0 && l > 0)));
+                    angle = forward ? cellAngles[local * numForwardOffsets + kernelSlot] : neighborAngles[neighbor * numForwardOffsets + kernelSlot];
+                  }
+                  totalmisorientation = totalmisorientation + (angle * SIMPLib::Constants::k_180OverPiD);
+                  numVoxel++;
+                }
+              }
+            }
+            m_KernelAverageMisorientations[point] = (numVoxel == 0) ? 0.0f : totalmisorientation / static_cast<float>(numVoxel);
+          }
+        }
+      }
+      m_Filter->sendThreadSafeProgressMessage((tileMax[0] - tileMin[0]) * (tileMax[1] - tileMin[1]) * (tileMax[2] - tileMin[2]));
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  FindKernelAvgMisorientations* m_Filter;
+  const FloatArrayType& m_Quats;
+  const Int32ArrayType& m_CellPhases;
+  const Int32ArrayType& m_FeatureIds;
+  const UInt32ArrayType& m_CrystalStructures;
+  const IntVec3Type& m_KernelSize;
+  FloatArrayType& m_KernelAverageMisorientations;
+  const SizeVec3Type& m_UDims;
+  std::array<int64_t, 3> m_TileSize;
+  std::array<int64_t, 3> m_NumTiles = {1, 1, 1};
+};
+
 } // namespace
 
 // -----------------------------------------------------------------------------
@@ -234,6 +506,7 @@ void FindKernelAvgMisorientations::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_INT_VEC3_FP("Kernel Radius", KernelSize, FilterParameter::Category::Parameter, FindKernelAvgMisorientations));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Compute Each Neighbor Pair Once", CacheNeighborPairs, FilterParameter::Category::Parameter, FindKernelAvgMisorientations));
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
 
   {
@@ -270,6 +543,7 @@ void FindKernelAvgMisorientations::readFilterParameters(AbstractFilterParameters
   setCellPhasesArrayPath(reader->readDataArrayPath("CellPhasesArrayPath", getCellPhasesArrayPath()));
   setFeatureIdsArrayPath(reader->readDataArrayPath("FeatureIdsArrayPath", getFeatureIdsArrayPath()));
   setKernelSize(reader->readIntVec3("KernelSize", getKernelSize()));
+  setCacheNeighborPairs(reader->readValue("CacheNeighborPairs", getCacheNeighborPairs()));
   reader->closeFilterGroup();
 }
 
@@ -289,6 +563,13 @@ void FindKernelAvgMisorientations::dataCheck()
   clearWarningCode();
   DataArrayPath tempPath;
 
+  if(m_KernelSize[0] < 0 || m_KernelSize[1] < 0 || m_KernelSize[2] < 0)
+  {
+    QString ss = QObject::tr("The Kernel Radius must be 0 or greater in every direction. The current radius is (%1, %2, %3)").arg(m_KernelSize[0]).arg(m_KernelSize[1]).arg(m_KernelSize[2]);
+    setErrorCondition(-11901, ss);
+    return;
+  }
+
   getDataContainerArray()->getPrereqGeometryFromDataContainer<ImageGeom>(this, getFeatureIdsArrayPath().getDataContainerName());
 
   QVector<DataArrayPath> dataArrayPaths;
@@ -362,6 +643,29 @@ void FindKernelAvgMisorientations::execute()
 
   m_TotalElements = udims[0] * udims[1] * udims[2];
 
+  if(m_CacheNeighborPairs)
+  {
+    // Shrink the tiles for large kernels so the two cached angles of every forward pair of a tile and its halo stay bounded
+    std::array<int64_t, 3> tileSize = {64, 64, 16};
+    int64_t numForwardOffsets = ((2 * m_KernelSize[0] + 1) * (2 * m_KernelSize[1] + 1) * (2 * m_KernelSize[2] + 1) - 1) / 2;
+    auto cachedPairAngles = [&]() {
+      return 2 * numForwardOffsets * (tileSize[0] + 2 * m_KernelSize[0]) * (tileSize[1] + 2 * m_KernelSize[1]) * (tileSize[2] + 2 * m_KernelSize[2]);
+    };
+    while(cachedPairAngles() > k_MaxCachedPairAngles && (tileSize[0] > 1 || tileSize[1] > 1 || tileSize[2] > 1))
+    {
+      size_t largest = std::distance(tileSize.begin(), std::max_element(tileSize.begin(), tileSize.end()));
+      tileSize[largest] /= 2;
+    }
+    FindKernelAvgMisorientationsPairCacheImpl impl(this, *m_QuatsPtr.lock(), *m_CellPhasesPtr.lock(), *m_FeatureIdsPtr.lock(), *m_CrystalStructuresPtr.lock(), m_KernelSize,
+                                                   *m_KernelAverageMisorientationsPtr.lock(), udims, tileSize);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, impl.getNumberOfTiles(), 1), impl, tbb::simple_partitioner());
+#else
+    impl.convert(0, impl.getNumberOfTiles());
+#endif
+    return;
+  }
+
 #if(SIMPL_USE_PARALLEL_ALGORITHMS == 1)
   tbb::parallel_for(tbb::blocked_range3d<int64_t, int64_t, int64_t>(0, udims[2], 0, udims[1], 0, udims[0]),
                     FindKernelAvgMisorientationsImpl(this, *m_QuatsPtr.lock(), *m_CellPhasesPtr.lock(), *m_FeatureIdsPtr.lock(), *m_CrystalStructuresPtr.lock(), m_KernelSize,
@@ -571,3 +875,15 @@ IntVec3Type FindKernelAvgMisorientations::getKernelSize() const
 {
   return m_KernelSize;
 }
+
+// -----------------------------------------------------------------------------
+void FindKernelAvgMisorientations::setCacheNeighborPairs(bool value)
+{
+  m_CacheNeighborPairs = value;
+}
+
+// -----------------------------------------------------------------------------
+bool FindKernelAvgMisorientations::getCacheNeighborPairs() const
+{
+  return m_CacheNeighborPairs;
+}
@@ -36,6 +36,7 @@
 #include "FindMisorientations.h"
 
 #include <cmath>
+#include <vector>
 
 #include <QtCore/QTextStream>
 
@@ -48,6 +49,7 @@
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "EbsdLib/Core/Quaternion.hpp"
 #include "EbsdLib/LaueOps/LaueOps.h"
@@ -55,6 +57,79 @@
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+namespace
+{
+/**
+ * @brief The FeaturePairMisorientationsImpl class computes the misorientation of every pair of neighboring
+ * features once. The NeighborList entries are flattened; an entry whose pair was already claimed by the
+ * lower numbered feature only records the index of that entry and copies its value afterwards.
+ */
+class FeaturePairMisorientationsImpl
+{
+public:
+  FeaturePairMisorientationsImpl(NeighborList<int32_t>& neighborList, const std::vector<size_t>& entryOffsets, const std::vector<size_t>& pairOwners, const float* avgQuats,
+                                 const int32_t* featurePhases, const uint32_t* crystalStructures, const LaueOpsContainer& orientationOps, std::vector<float>& misorientations)
+  : m_NeighborList(neighborList)
+  , m_EntryOffsets(entryOffsets)
+  , m_PairOwners(pairOwners)
+  , m_AvgQuats(avgQuats)
+  , m_FeaturePhases(featurePhases)
+  , m_CrystalStructures(crystalStructures)
+  , m_OrientationOps(orientationOps)
+  , m_Misorientations(misorientations)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      const float* currentAvgQuatPtr = m_AvgQuats + i * 4;
+      QuatF q1(currentAvgQuatPtr[0], currentAvgQuatPtr[1], currentAvgQuatPtr[2], currentAvgQuatPtr[3]);
+      uint32_t xtalType1 = m_CrystalStructures[m_FeaturePhases[i]];
+      NeighborList<int32_t>::VectorType& featureNeighborList = m_NeighborList[i];
+
+      for(size_t j = 0; j < featureNeighborList.size(); j++)
+      {
+        size_t entry = m_EntryOffsets[i] + j;
+        if(m_PairOwners[entry] != entry)
+        {
+          continue;
+        }
+        int32_t nname = featureNeighborList[j];
+        currentAvgQuatPtr = m_AvgQuats + nname * 4;
+        QuatF q2(currentAvgQuatPtr[0], currentAvgQuatPtr[1], currentAvgQuatPtr[2], currentAvgQuatPtr[3]);
+        uint32_t xtalType2 = m_CrystalStructures[m_FeaturePhases[nname]];
+        if(xtalType1 == xtalType2 && static_cast<int64_t>(xtalType1) < static_cast<int64_t>(m_OrientationOps.size()))
+        {
+          OrientationD axisAngle = m_OrientationOps[xtalType1]->calculateMisorientation(q1, q2);
+          m_Misorientations[entry] = axisAngle[3] * SIMPLib::Constants::k_180OverPiD;
+        }
+        else
+        {
+          m_Misorientations[entry] = NAN;
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  NeighborList<int32_t>& m_NeighborList;
+  const std::vector<size_t>& m_EntryOffsets;
+  const std::vector<size_t>& m_PairOwners;
+  const float* m_AvgQuats;
+  const int32_t* m_FeaturePhases;
+  const uint32_t* m_CrystalStructures;
+  const LaueOpsContainer& m_OrientationOps;
+  std::vector<float>& m_Misorientations;
+};
+} // namespace
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -223,52 +298,67 @@ void FindMisorientations::execute()
   // us to use the same syntax as the "vector of vectors"
   NeighborList<int32_t>& neighborlist = *(m_NeighborList.lock());
 
-  std::vector<std::vector<float>> misorientationlists;
-
-  size_t tempMisoList = 0;
-
-  uint32_t xtalType1 = 0, xtalType2 = 0;
-  int32_t nname = 0;
-  float* currentAvgQuatPtr = nullptr;
-  misorientationlists.resize(totalFeatures);
+  // Flatten the NeighborList so every entry has an index. The misorientation of a pair of features is symmetric,
+  // so each pair is computed by the entry of the lower numbered feature and the mirrored entry reuses it.
+  std::vector<size_t> entryOffsets(totalFeatures + 1, 0);
+  for(size_t i = 1; i < totalFeatures; i++)
+  {
+    entryOffsets[i + 1] = entryOffsets[i] + neighborlist[i].size();
+  }
+  std::vector<size_t> pairOwners(entryOffsets[totalFeatures]);
   for(size_t i = 1; i < totalFeatures; i++)
   {
-    currentAvgQuatPtr = m_AvgQuats + i * 4;
-
-    QuatF q1(currentAvgQuatPtr[0], currentAvgQuatPtr[1], currentAvgQuatPtr[2], currentAvgQuatPtr[3]);
-    xtalType1 = m_CrystalStructures[m_FeaturePhases[i]];
     NeighborList<int32_t>::VectorType& featureNeighborList = neighborlist[i];
-
-    misorientationlists[i].assign(featureNeighborList.size(), -1.0);
-
     for(size_t j = 0; j < featureNeighborList.size(); j++)
     {
-      nname = featureNeighborList[j];
-      currentAvgQuatPtr = m_AvgQuats + nname * 4;
-      QuatF q2(currentAvgQuatPtr[0], currentAvgQuatPtr[1], currentAvgQuatPtr[2], currentAvgQuatPtr[3]);
-      xtalType2 = m_CrystalStructures[m_FeaturePhases[nname]];
-      tempMisoList = featureNeighborList.size();
-      if(xtalType1 == xtalType2 && static_cast<int64_t>(xtalType1) < static_cast<int64_t>(m_OrientationOps.size()))
+      size_t entry = entryOffsets[i] + j;
+      pairOwners[entry] = entry;
+      int32_t nname = featureNeighborList[j];
+      if(nname <= 0 || static_cast<size_t>(nname) >= i)
       {
-        OrientationD axisAngle = m_OrientationOps[xtalType1]->calculateMisorientation(q1, q2);
-
-        misorientationlists[i][j] = axisAngle[3] * SIMPLib::Constants::k_180OverPiD;
-        if(m_FindAvgMisors)
+        continue;
+      }
+      NeighborList<int32_t>::VectorType& mirrorNeighborList = neighborlist[nname];
+      for(size_t k = 0; k < mirrorNeighborList.size(); k++)
+      {
+        if(static_cast<size_t>(mirrorNeighborList[k]) == i)
         {
-          m_AvgMisorientations[i] += misorientationlists[i][j];
+          pairOwners[entry] = entryOffsets[nname] + k;
+          break;
         }
       }
-      else
+    }
+  }
+
+  std::vector<float> misorientations(entryOffsets[totalFeatures], -1.0f);
+  if(totalFeatures > 1)
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(1ULL, totalFeatures);
+    dataAlg.execute(FeaturePairMisorientationsImpl(neighborlist, entryOffsets, pairOwners, m_AvgQuats, m_FeaturePhases, m_CrystalStructures, m_OrientationOps, misorientations));
+  }
+
+  for(size_t entry = 0; entry < misorientations.size(); entry++)
+  {
+    misorientations[entry] = misorientations[pairOwners[entry]];
+  }
+
+  if(m_FindAvgMisors)
+  {
+    for(size_t i = 1; i < totalFeatures; i++)
+    {
+      size_t tempMisoList = neighborlist[i].size();
+      for(size_t entry = entryOffsets[i]; entry < entryOffsets[i + 1]; entry++)
       {
-        if(m_FindAvgMisors)
+        if(std::isnan(misorientations[entry]))
         {
           tempMisoList--;
         }
-        misorientationlists[i][j] = NAN;
+        else
+        {
+          m_AvgMisorientations[i] += misorientations[entry];
+        }
       }
-    }
-    if(m_FindAvgMisors)
-    {
       if(tempMisoList != 0)
       {
         m_AvgMisorientations[i] /= tempMisoList;
@@ -277,7 +367,6 @@ void FindMisorientations::execute()
       {
         m_AvgMisorientations[i] = NAN;
       }
-      tempMisoList = 0;
     }
   }
 
@@ -285,7 +374,7 @@ void FindMisorientations::execute()
   {
     // Set the vector for each list into the NeighborList Object
     NeighborList<float>::SharedVectorType misoL(new std::vector<float>);
-    misoL->assign(misorientationlists[i].begin(), misorientationlists[i].end());
+    misoL->assign(misorientations.begin() + entryOffsets[i], misorientations.begin() + entryOffsets[i + 1]);
     m_MisorientationList.lock()->setList(static_cast<int32_t>(i), misoL);
   }
 }
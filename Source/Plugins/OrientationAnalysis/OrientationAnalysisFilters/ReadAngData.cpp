@@ -56,6 +56,22 @@
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+namespace
+{
+/**
+ * @brief wrapReaderArray Hands the buffer that the reader loaded for a column over to a new DataArray
+ * instead of copying it. The reader no longer frees that buffer.
+ */
+template <typename T, class Reader>
+typename DataArray<T>::Pointer wrapReaderArray(Reader* reader, const std::string& name, size_t totalPoints, const std::vector<size_t>& cDims, const QString& arrayName)
+{
+  T* ptr = reinterpret_cast<T*>(reader->getPointerByName(name));
+  typename DataArray<T>::Pointer dataArray = DataArray<T>::WrapPointer(ptr, totalPoints, cDims, arrayName, true);
+  reader->releaseOwnership(name);
+  return dataArray;
+}
+} // namespace
+
 enum createdPathID : RenameDataPath::DataID_t
 {
   AttributeMatrixID21 = 21,
@@ -512,9 +528,6 @@ int32_t ReadAngData::loadMaterialInfo(AngReader* reader)
 // -----------------------------------------------------------------------------
 void ReadAngData::copyRawEbsdData(AngReader* reader, std::vector<size_t>& tDims, std::vector<size_t>& cDims)
 {
-  float* f1 = nullptr;
-  float* f2 = nullptr;
-  float* f3 = nullptr;
   int* phasePtr = nullptr;
 
   FloatArrayType::Pointer fArray = FloatArrayType::NullPointer();
@@ -542,16 +555,19 @@ void ReadAngData::copyRawEbsdData(AngReader* reader, std::vector<size_t>& tDims,
         phasePtr[i] = 1;
       }
     }
-    iArray = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::Phases, true);
-    ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
+    iArray = wrapReaderArray<int32_t>(reader, EbsdLib::Ang::PhaseData, totalPoints, cDims, SIMPL::CellData::Phases);
     ebsdAttrMat->insertOrAssign(iArray);
   }
 
-  // Condense the Euler Angles from 3 separate arrays into a single 1x3 array
+  // Condense the Euler Angles from 3 separate arrays into a single 1x3 array. The separate arrays are
+  // taken from the reader so they are released as soon as the interleaved copy is made
   {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::Phi1));
-    f2 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::Phi));
-    f3 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::Phi2));
+    FloatArrayType::Pointer phi1 = wrapReaderArray<float>(reader, EbsdLib::Ang::Phi1, totalPoints, cDims, S2Q(EbsdLib::Ang::Phi1));
+    FloatArrayType::Pointer phi = wrapReaderArray<float>(reader, EbsdLib::Ang::Phi, totalPoints, cDims, S2Q(EbsdLib::Ang::Phi));
+    FloatArrayType::Pointer phi2 = wrapReaderArray<float>(reader, EbsdLib::Ang::Phi2, totalPoints, cDims, S2Q(EbsdLib::Ang::Phi2));
+    const float* f1 = phi1->getPointer(0);
+    const float* f2 = phi->getPointer(0);
+    const float* f3 = phi2->getPointer(0);
     cDims[0] = 3;
     fArray = FloatArrayType::CreateArray(tDims, cDims, SIMPL::CellData::EulerAngles, true);
     float* cellEulerAngles = fArray->getPointer(0);
@@ -565,48 +581,14 @@ void ReadAngData::copyRawEbsdData(AngReader* reader, std::vector<size_t>& tDims,
     ebsdAttrMat->insertOrAssign(fArray);
   }
 
+  // The remaining columns are handed over to the DataArrays without copying
   cDims[0] = 1;
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::ImageQuality));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::ImageQuality), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::ConfidenceIndex));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::ConfidenceIndex), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::SEMSignal));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::SEMSignal), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::Fit));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::Fit), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::XPosition));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::XPosition), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ang::YPosition));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::YPosition), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ang::ImageQuality, totalPoints, cDims, S2Q(EbsdLib::Ang::ImageQuality)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ang::ConfidenceIndex, totalPoints, cDims, S2Q(EbsdLib::Ang::ConfidenceIndex)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ang::SEMSignal, totalPoints, cDims, S2Q(EbsdLib::Ang::SEMSignal)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ang::Fit, totalPoints, cDims, S2Q(EbsdLib::Ang::Fit)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ang::XPosition, totalPoints, cDims, S2Q(EbsdLib::Ang::XPosition)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ang::YPosition, totalPoints, cDims, S2Q(EbsdLib::Ang::YPosition)));
 }
 
 // -----------------------------------------------------------------------------
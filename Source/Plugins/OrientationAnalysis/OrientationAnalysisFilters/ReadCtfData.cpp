@@ -58,6 +58,22 @@
 #include "OrientationAnalysis/OrientationAnalysisFilters/ChangeAngleRepresentation.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+namespace
+{
+/**
+ * @brief wrapReaderArray Hands the buffer that the reader loaded for a column over to a new DataArray
+ * instead of copying it. The reader no longer frees that buffer.
+ */
+template <typename T, class Reader>
+typename DataArray<T>::Pointer wrapReaderArray(Reader* reader, const std::string& name, size_t totalPoints, const std::vector<size_t>& cDims, const QString& arrayName)
+{
+  T* ptr = reinterpret_cast<T*>(reader->getPointerByName(name));
+  typename DataArray<T>::Pointer dataArray = DataArray<T>::WrapPointer(ptr, totalPoints, cDims, arrayName, true);
+  reader->releaseOwnership(name);
+  return dataArray;
+}
+} // namespace
+
 enum createdPathID : RenameDataPath::DataID_t
 {
   AttributeMatrixID21 = 21,
@@ -495,9 +511,6 @@ int32_t ReadCtfData::loadMaterialInfo(CtfReader* reader)
 // -----------------------------------------------------------------------------
 void ReadCtfData::copyRawEbsdData(CtfReader* reader, std::vector<size_t>& tDims, std::vector<size_t>& cDims)
 {
-  float* f1 = nullptr;
-  float* f2 = nullptr;
-  float* f3 = nullptr;
   int* phasePtr = nullptr;
 
   FloatArrayType::Pointer fArray = FloatArrayType::NullPointer();
@@ -533,15 +546,17 @@ void ReadCtfData::copyRawEbsdData(CtfReader* reader, std::vector<size_t>& tDims,
         phasePtr[i] = 1;
       }
     }
-    iArray = Int32ArrayType::CreateArray(totalPoints, SIMPL::CellData::Phases, true);
-    ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
+    iArray = wrapReaderArray<int32_t>(reader, EbsdLib::Ctf::Phase, totalPoints, cDims, SIMPL::CellData::Phases);
     ebsdAttrMat->insertOrAssign(iArray);
   }
   {
-    //  radianconversion = M_PI / 180.0;
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ctf::Euler1));
-    f2 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ctf::Euler2));
-    f3 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ctf::Euler3));
+    // The separate Euler arrays are taken from the reader so they are released as soon as the interleaved copy is made
+    FloatArrayType::Pointer euler1 = wrapReaderArray<float>(reader, EbsdLib::Ctf::Euler1, totalPoints, cDims, S2Q(EbsdLib::Ctf::Euler1));
+    FloatArrayType::Pointer euler2 = wrapReaderArray<float>(reader, EbsdLib::Ctf::Euler2, totalPoints, cDims, S2Q(EbsdLib::Ctf::Euler2));
+    FloatArrayType::Pointer euler3 = wrapReaderArray<float>(reader, EbsdLib::Ctf::Euler3, totalPoints, cDims, S2Q(EbsdLib::Ctf::Euler3));
+    const float* f1 = euler1->getPointer(0);
+    const float* f2 = euler2->getPointer(0);
+    const float* f3 = euler3->getPointer(0);
     std::vector<size_t> dims(1, 3);
     fArray = FloatArrayType::CreateArray(totalPoints, dims, SIMPL::CellData::EulerAngles, true);
     float* cellEulerAngles = fArray->getPointer(0);
@@ -567,54 +582,14 @@ void ReadCtfData::copyRawEbsdData(CtfReader* reader, std::vector<size_t>& tDims,
     ebsdAttrMat->insertOrAssign(fArray);
   }
 
-  {
-    phasePtr = reinterpret_cast<int32_t*>(reader->getPointerByName(EbsdLib::Ctf::Bands));
-    iArray = Int32ArrayType::CreateArray(totalPoints, EbsdLib::Ctf::Bands, true);
-    ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
-    ebsdAttrMat->insertOrAssign(iArray);
-  }
-
-  {
-    phasePtr = reinterpret_cast<int32_t*>(reader->getPointerByName(EbsdLib::Ctf::Error));
-    iArray = Int32ArrayType::CreateArray(totalPoints, EbsdLib::Ctf::Error, true);
-    ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
-    ebsdAttrMat->insertOrAssign(iArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ctf::MAD));
-    fArray = FloatArrayType::CreateArray(totalPoints, EbsdLib::Ctf::MAD, true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    phasePtr = reinterpret_cast<int32_t*>(reader->getPointerByName(EbsdLib::Ctf::BC));
-    iArray = Int32ArrayType::CreateArray(totalPoints, EbsdLib::Ctf::BC, true);
-    ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
-    ebsdAttrMat->insertOrAssign(iArray);
-  }
-
-  {
-    phasePtr = reinterpret_cast<int32_t*>(reader->getPointerByName(EbsdLib::Ctf::BS));
-    iArray = Int32ArrayType::CreateArray(totalPoints, EbsdLib::Ctf::BS, true);
-    ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
-    ebsdAttrMat->insertOrAssign(iArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ctf::X));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::X), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
-
-  {
-    f1 = reinterpret_cast<float*>(reader->getPointerByName(EbsdLib::Ctf::Y));
-    fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::Y), true);
-    ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
-    ebsdAttrMat->insertOrAssign(fArray);
-  }
+  // The remaining columns are handed over to the DataArrays without copying
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<int32_t>(reader, EbsdLib::Ctf::Bands, totalPoints, cDims, S2Q(EbsdLib::Ctf::Bands)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<int32_t>(reader, EbsdLib::Ctf::Error, totalPoints, cDims, S2Q(EbsdLib::Ctf::Error)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ctf::MAD, totalPoints, cDims, S2Q(EbsdLib::Ctf::MAD)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<int32_t>(reader, EbsdLib::Ctf::BC, totalPoints, cDims, S2Q(EbsdLib::Ctf::BC)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<int32_t>(reader, EbsdLib::Ctf::BS, totalPoints, cDims, S2Q(EbsdLib::Ctf::BS)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ctf::X, totalPoints, cDims, S2Q(EbsdLib::Ctf::X)));
+  ebsdAttrMat->insertOrAssign(wrapReaderArray<float>(reader, EbsdLib::Ctf::Y, totalPoints, cDims, S2Q(EbsdLib::Ctf::Y)));
 }
 
 // -----------------------------------------------------------------------------
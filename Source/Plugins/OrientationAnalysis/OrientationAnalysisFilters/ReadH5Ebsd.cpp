@@ -34,6 +34,8 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ReadH5Ebsd.h"
 
+#include <map>
+
 #include <QtCore/QFileInfo>
 #include <QtCore/QTextStream>
 
@@ -43,6 +45,8 @@
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataContainerCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
@@ -125,6 +129,14 @@ void ReadH5Ebsd::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(ReadH5EbsdFilterParameter::Create("Import H5Ebsd File", "ReadH5Ebsd", "__NULL__", FilterParameter::Category::Parameter, this, "h5ebsd", "H5Ebsd"));
+  {
+    std::vector<QString> linkedProps = {"XMinIndex", "XMaxIndex", "YMinIndex", "YMaxIndex"};
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Read Region of Interest", ReadRegionOfInterest, FilterParameter::Category::Parameter, ReadH5Ebsd, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("X Min (Column)", XMinIndex, FilterParameter::Category::Parameter, ReadH5Ebsd));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("X Max (Column)", XMaxIndex, FilterParameter::Category::Parameter, ReadH5Ebsd));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Y Min (Row)", YMinIndex, FilterParameter::Category::Parameter, ReadH5Ebsd));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Y Max (Row)", YMaxIndex, FilterParameter::Category::Parameter, ReadH5Ebsd));
   parameters.push_back(SIMPL_NEW_DC_CREATION_FP("Data Container", DataContainerName, FilterParameter::Category::CreatedArray, ReadH5Ebsd));
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
   parameters.push_back(SIMPL_NEW_AM_WITH_LINKED_DC_FP("Cell Attribute Matrix", CellAttributeMatrixName, DataContainerName, FilterParameter::Category::CreatedArray, ReadH5Ebsd));
@@ -147,6 +159,11 @@ void ReadH5Ebsd::readFilterParameters(AbstractFilterParametersReader* reader, in
   setUseTransformations(reader->readValue("UseTransformations", getUseTransformations()));
   setSelectedArrayNames(reader->readArraySelections("SelectedArrayNames", getSelectedArrayNames()));
   setAngleRepresentation(reader->readValue("AngleRepresentation", getAngleRepresentation()));
+  setReadRegionOfInterest(reader->readValue("ReadRegionOfInterest", getReadRegionOfInterest()));
+  setXMinIndex(reader->readValue("XMinIndex", getXMinIndex()));
+  setXMaxIndex(reader->readValue("XMaxIndex", getXMaxIndex()));
+  setYMinIndex(reader->readValue("YMinIndex", getYMinIndex()));
+  setYMaxIndex(reader->readValue("YMaxIndex", getYMaxIndex()));
   reader->closeFilterGroup();
 }
 
@@ -359,9 +376,28 @@ void ReadH5Ebsd::dataCheck()
     return;
   }
 
+  if(m_ReadRegionOfInterest && (m_XMinIndex < 0 || m_XMaxIndex < m_XMinIndex || m_XMaxIndex >= dims[0] || m_YMinIndex < 0 || m_YMaxIndex < m_YMinIndex || m_YMaxIndex >= dims[1]))
+  {
+    QString ss = QObject::tr("The region of interest X [%1, %2] Y [%3, %4] must lie inside the slice dimensions of %5 x %6")
+                     .arg(m_XMinIndex)
+                     .arg(m_XMaxIndex)
+                     .arg(m_YMinIndex)
+                     .arg(m_YMaxIndex)
+                     .arg(dims[0])
+                     .arg(dims[1]);
+    setErrorCondition(-13, ss);
+    return;
+  }
+
   size_t dcDims[3] = {static_cast<size_t>(dims[0]), static_cast<size_t>(dims[1]), static_cast<size_t>(dims[2])};
   // Now Calculate our "subvolume" of slices, ie, those start and end values that the user selected from the GUI
   dcDims[2] = m_ZEndIndex - m_ZStartIndex + 1;
+  if(m_ReadRegionOfInterest)
+  {
+    dcDims[0] = static_cast<size_t>(m_XMaxIndex - m_XMinIndex + 1);
+    dcDims[1] = static_cast<size_t>(m_YMaxIndex - m_YMinIndex + 1);
+    m->getGeometryAs<ImageGeom>()->setOrigin(FloatVec3Type(m_XMinIndex * res[0], m_YMinIndex * res[1], 0.0f));
+  }
   m->getGeometryAs<ImageGeom>()->setDimensions(dcDims);
   m->getGeometryAs<ImageGeom>()->setSpacing(res);
 
@@ -497,6 +533,7 @@ void ReadH5Ebsd::execute()
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
 
   std::string manufacturer;
+  int64_t sliceDims[2] = {0, 0};
   // Get the Size and Spacing of the Volume
   {
     H5EbsdVolumeInfo::Pointer volumeInfoReader = H5EbsdVolumeInfo::New();
@@ -516,6 +553,13 @@ void ReadH5Ebsd::execute()
     m->getGeometryAs<ImageGeom>()->setSpacing(res);
     // Now Calculate our "subvolume" of slices, ie, those start and end values that the user selected from the GUI
     dcDims[2] = m_ZEndIndex - m_ZStartIndex + 1;
+    sliceDims[0] = dims[0];
+    sliceDims[1] = dims[1];
+    if(m_ReadRegionOfInterest)
+    {
+      dcDims[0] = static_cast<size_t>(m_XMaxIndex - m_XMinIndex + 1);
+      dcDims[1] = static_cast<size_t>(m_YMaxIndex - m_YMinIndex + 1);
+    }
     m->getGeometryAs<ImageGeom>()->setDimensions(dcDims);
     manufacturer = volumeInfoReader->getManufacturer();
     m_RefFrameZDir = volumeInfoReader->getStackingOrder();
@@ -566,31 +610,42 @@ void ReadH5Ebsd::execute()
   ebsdReader->setSliceEnd(m_ZEndIndex);
   ebsdReader->readAllArrays(false);
   ebsdReader->setArraysToRead(::convertToStl(m_SelectedArrayNames));
-  int err = ebsdReader->loadData(m->getGeometryAs<ImageGeom>()->getXPoints(), m->getGeometryAs<ImageGeom>()->getYPoints(), m->getGeometryAs<ImageGeom>()->getZPoints(), m_RefFrameZDir);
-  if(err < 0)
-  {
-    setErrorCondition(err, S2Q(ebsdReader->getErrorMessage()));
-    setErrorCondition(-1, "Error Loading Data from Ebsd Data file.");
-    return;
-  }
-
-  // Copy the data from the pointers embedded in the reader object into our data container (Cell array).
-  if(manufacturer == EbsdLib::Ang::Manufacturer)
+  if(m_ReadRegionOfInterest)
   {
-    copyTSLArrays(ebsdReader.get());
-  }
-  else if(manufacturer == EbsdLib::Ctf::Manufacturer)
-  {
-    copyHKLArrays(ebsdReader.get());
+    readRegionOfInterest(ebsdReader.get(), manufacturer, sliceDims);
+    if(getErrorCode() < 0 || getCancel())
+    {
+      return;
+    }
   }
-
   else
   {
-    QString ss = QObject::tr("Could not determine or match a supported manufacturer from the data file. Supported manufacturer codes are: %1 and %2")
-                     .arg(S2Q(EbsdLib::Ctf::Manufacturer))
-                     .arg(S2Q(EbsdLib::Ang::Manufacturer));
-    setErrorCondition(-109875, ss);
-    return;
+    int err = ebsdReader->loadData(m->getGeometryAs<ImageGeom>()->getXPoints(), m->getGeometryAs<ImageGeom>()->getYPoints(), m->getGeometryAs<ImageGeom>()->getZPoints(), m_RefFrameZDir);
+    if(err < 0)
+    {
+      setErrorCondition(err, S2Q(ebsdReader->getErrorMessage()));
+      setErrorCondition(-1, "Error Loading Data from Ebsd Data file.");
+      return;
+    }
+
+    // Copy the data from the pointers embedded in the reader object into our data container (Cell array).
+    if(manufacturer == EbsdLib::Ang::Manufacturer)
+    {
+      copyTSLArrays(ebsdReader.get());
+    }
+    else if(manufacturer == EbsdLib::Ctf::Manufacturer)
+    {
+      copyHKLArrays(ebsdReader.get());
+    }
+
+    else
+    {
+      QString ss = QObject::tr("Could not determine or match a supported manufacturer from the data file. Supported manufacturer codes are: %1 and %2")
+                       .arg(S2Q(EbsdLib::Ctf::Manufacturer))
+                       .arg(S2Q(EbsdLib::Ang::Manufacturer));
+      setErrorCondition(-109875, ss);
+      return;
+    }
   }
 
   if(m_UseTransformations)
@@ -755,6 +810,14 @@ H5EbsdVolumeReader::Pointer ReadH5Ebsd::initHKLEbsdVolumeReader()
 //
 // -----------------------------------------------------------------------------
 void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
+{
+  copyTSLArrays([ebsdReader](const std::string& name) { return ebsdReader->getPointerByName(name); });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::copyTSLArrays(const EbsdPointerLookup& getPointerByName)
 {
   float* f1 = nullptr;
   float* f2 = nullptr;
@@ -776,7 +839,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
   std::vector<size_t> cDims(1, 1);
   if(m_SelectedArrayNames.find(m_CellPhasesArrayName) != m_SelectedArrayNames.end())
   {
-    phasePtr = reinterpret_cast<int32_t*>(ebsdReader->getPointerByName(EbsdLib::Ang::PhaseData));
+    phasePtr = reinterpret_cast<int32_t*>(getPointerByName(EbsdLib::Ang::PhaseData));
     iArray = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::Phases, true);
     ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
     cellAttrMatrix->insertOrAssign(iArray);
@@ -784,9 +847,9 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(m_CellEulerAnglesArrayName) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::Phi1));
-    f2 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::Phi));
-    f3 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::Phi2));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::Phi1));
+    f2 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::Phi));
+    f3 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::Phi2));
     cDims[0] = 3;
     fArray = FloatArrayType::CreateArray(tDims, cDims, SIMPL::CellData::EulerAngles, true);
     float* cellEulerAngles = fArray->getPointer(0);
@@ -809,7 +872,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ang::ImageQuality)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::ImageQuality));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::ImageQuality));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::ImageQuality), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -817,7 +880,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ang::ConfidenceIndex)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::ConfidenceIndex));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::ConfidenceIndex));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::ConfidenceIndex), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -825,7 +888,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ang::SEMSignal)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::SEMSignal));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::SEMSignal));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::SEMSignal), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -833,7 +896,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ang::Fit)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::Fit));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::Fit));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::Fit), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -841,7 +904,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ang::XPosition)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::XPosition));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::XPosition));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::XPosition), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -849,7 +912,7 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ang::YPosition)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ang::YPosition));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ang::YPosition));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ang::YPosition), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -860,6 +923,14 @@ void ReadH5Ebsd::copyTSLArrays(H5EbsdVolumeReader* ebsdReader)
 //
 // -----------------------------------------------------------------------------
 void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
+{
+  copyHKLArrays([ebsdReader](const std::string& name) { return ebsdReader->getPointerByName(name); });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::copyHKLArrays(const EbsdPointerLookup& getPointerByName)
 {
   float* f1 = nullptr;
   float* f2 = nullptr;
@@ -878,7 +949,7 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
 
   size_t totalPoints = m->getGeometryAs<ImageGeom>()->getNumberOfElements();
   std::vector<size_t> cDims(1, 1);
-  phasePtr = reinterpret_cast<int32_t*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Phase));
+  phasePtr = reinterpret_cast<int32_t*>(getPointerByName(EbsdLib::Ctf::Phase));
   iArray = Int32ArrayType::CreateArray(tDims, cDims, SIMPL::CellData::Phases, true);
   ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
   cellAttrMatrix->insertOrAssign(iArray);
@@ -886,9 +957,9 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
   if(m_SelectedArrayNames.find(m_CellEulerAnglesArrayName) != m_SelectedArrayNames.end())
   {
     //  radianconversion = M_PI / 180.0;
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Euler1));
-    f2 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Euler2));
-    f3 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Euler3));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ctf::Euler1));
+    f2 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ctf::Euler2));
+    f3 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ctf::Euler3));
     cDims[0] = 3;
     fArray = FloatArrayType::CreateArray(tDims, cDims, SIMPL::CellData::EulerAngles, true);
     float* cellEulerAngles = fArray->getPointer(0);
@@ -914,7 +985,7 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
   cDims[0] = 1;
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::Bands)) != m_SelectedArrayNames.end())
   {
-    phasePtr = reinterpret_cast<int32_t*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Bands));
+    phasePtr = reinterpret_cast<int32_t*>(getPointerByName(EbsdLib::Ctf::Bands));
     iArray = Int32ArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::Bands), true);
     ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
     cellAttrMatrix->insertOrAssign(iArray);
@@ -922,7 +993,7 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::Error)) != m_SelectedArrayNames.end())
   {
-    phasePtr = reinterpret_cast<int32_t*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Error));
+    phasePtr = reinterpret_cast<int32_t*>(getPointerByName(EbsdLib::Ctf::Error));
     iArray = Int32ArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::Error), true);
     ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
     cellAttrMatrix->insertOrAssign(iArray);
@@ -930,7 +1001,7 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::MAD)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ctf::MAD));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ctf::MAD));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::MAD), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
@@ -938,7 +1009,7 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::BC)) != m_SelectedArrayNames.end())
   {
-    phasePtr = reinterpret_cast<int32_t*>(ebsdReader->getPointerByName(EbsdLib::Ctf::BC));
+    phasePtr = reinterpret_cast<int32_t*>(getPointerByName(EbsdLib::Ctf::BC));
     iArray = Int32ArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::BC), true);
     ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
     cellAttrMatrix->insertOrAssign(iArray);
@@ -946,27 +1017,113 @@ void ReadH5Ebsd::copyHKLArrays(H5EbsdVolumeReader* ebsdReader)
 
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::BS)) != m_SelectedArrayNames.end())
   {
-    phasePtr = reinterpret_cast<int32_t*>(ebsdReader->getPointerByName(EbsdLib::Ctf::BS));
+    phasePtr = reinterpret_cast<int32_t*>(getPointerByName(EbsdLib::Ctf::BS));
     iArray = Int32ArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::BS), true);
     ::memcpy(iArray->getPointer(0), phasePtr, sizeof(int32_t) * totalPoints);
     cellAttrMatrix->insertOrAssign(iArray);
   }
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::X)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ctf::X));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ctf::X));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::X), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
   }
   if(m_SelectedArrayNames.find(S2Q(EbsdLib::Ctf::Y)) != m_SelectedArrayNames.end())
   {
-    f1 = reinterpret_cast<float*>(ebsdReader->getPointerByName(EbsdLib::Ctf::Y));
+    f1 = reinterpret_cast<float*>(getPointerByName(EbsdLib::Ctf::Y));
     fArray = FloatArrayType::CreateArray(tDims, cDims, S2Q(EbsdLib::Ctf::Y), true);
     ::memcpy(fArray->getPointer(0), f1, sizeof(float) * totalPoints);
     cellAttrMatrix->insertOrAssign(fArray);
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t ReadH5Ebsd::readRegionOfInterest(H5EbsdVolumeReader* ebsdReader, const std::string& manufacturer, const int64_t sliceDims[2])
+{
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  const size_t roiXPoints = image->getXPoints();
+  const size_t roiYPoints = image->getYPoints();
+  const size_t zPoints = image->getZPoints();
+  const size_t roiSlicePoints = roiXPoints * roiYPoints;
+  const size_t xPoints = static_cast<size_t>(sliceDims[0]);
+
+  // Stage each selected raw array at the size of the region of interest
+  std::map<std::string, IDataArray::Pointer> stagedArrays;
+  for(const auto& name : m_SelectedArrayNames)
+  {
+    std::string arrayName = name.toStdString();
+    EbsdLib::NumericTypes::Type type = ebsdReader->getPointerType(arrayName);
+    if(type == EbsdLib::NumericTypes::Type::Int32)
+    {
+      stagedArrays[arrayName] = Int32ArrayType::CreateArray(roiSlicePoints * zPoints, name, true);
+    }
+    else if(type == EbsdLib::NumericTypes::Type::Float)
+    {
+      stagedArrays[arrayName] = FloatArrayType::CreateArray(roiSlicePoints * zPoints, name, true);
+    }
+  }
+
+  for(size_t slice = 0; slice < zPoints; slice++)
+  {
+    QString ss = QObject::tr("Reading slice %1 of %2").arg(slice + 1).arg(zPoints);
+    notifyStatusMessage(ss);
+
+    // Load exactly one full slice into the reader and keep the rows of the region of interest
+    int64_t sliceIndex = m_ZStartIndex + static_cast<int64_t>(slice);
+    ebsdReader->setSliceStart(sliceIndex);
+    ebsdReader->setSliceEnd(sliceIndex);
+    int32_t err = ebsdReader->loadData(sliceDims[0], sliceDims[1], 1, m_RefFrameZDir);
+    if(err < 0)
+    {
+      setErrorCondition(err, S2Q(ebsdReader->getErrorMessage()));
+      setErrorCondition(-1, "Error Loading Data from Ebsd Data file.");
+      return err;
+    }
+
+    size_t zIndex = (m_RefFrameZDir == SIMPL::RefFrameZDir::HightoLow) ? zPoints - 1 - slice : slice;
+    for(auto& staged : stagedArrays)
+    {
+      const uint8_t* source = reinterpret_cast<const uint8_t*>(ebsdReader->getPointerByName(staged.first));
+      if(nullptr == source)
+      {
+        continue;
+      }
+      const size_t typeSize = static_cast<size_t>(staged.second->getTypeSize());
+      uint8_t* destination = reinterpret_cast<uint8_t*>(staged.second->getVoidPointer(zIndex * roiSlicePoints));
+      for(size_t y = 0; y < roiYPoints; y++)
+      {
+        size_t sourceIndex = (y + static_cast<size_t>(m_YMinIndex)) * xPoints + static_cast<size_t>(m_XMinIndex);
+        ::memcpy(destination + y * roiXPoints * typeSize, source + sourceIndex * typeSize, roiXPoints * typeSize);
+      }
+    }
+
+    if(getCancel())
+    {
+      return 0;
+    }
+  }
+  ebsdReader->setSliceStart(m_ZStartIndex);
+  ebsdReader->setSliceEnd(m_ZEndIndex);
+
+  EbsdPointerLookup getStagedPointer = [&stagedArrays](const std::string& name) -> void* {
+    auto iter = stagedArrays.find(name);
+    return iter == stagedArrays.end() ? nullptr : iter->second->getVoidPointer(0);
+  };
+  if(manufacturer == EbsdLib::Ang::Manufacturer)
+  {
+    copyTSLArrays(getStagedPointer);
+  }
+  else
+  {
+    copyHKLArrays(getStagedPointer);
+  }
+  return 0;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -991,6 +1148,11 @@ AbstractFilter::Pointer ReadH5Ebsd::newFilterInstance(bool copyFilterParameters)
     filter->setSelectedArrayNames(getSelectedArrayNames());
     filter->setDataArrayNames(getDataArrayNames());
     filter->setAngleRepresentation(getAngleRepresentation());
+    filter->setReadRegionOfInterest(getReadRegionOfInterest());
+    filter->setXMinIndex(getXMinIndex());
+    filter->setXMaxIndex(getXMaxIndex());
+    filter->setYMinIndex(getYMinIndex());
+    filter->setYMaxIndex(getYMaxIndex());
   }
   return filter;
 }
@@ -1202,6 +1364,66 @@ QSet<QString> ReadH5Ebsd::getSelectedArrayNames() const
   return m_SelectedArrayNames;
 }
 
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::setReadRegionOfInterest(bool value)
+{
+  m_ReadRegionOfInterest = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ReadH5Ebsd::getReadRegionOfInterest() const
+{
+  return m_ReadRegionOfInterest;
+}
+
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::setXMinIndex(int value)
+{
+  m_XMinIndex = value;
+}
+
+// -----------------------------------------------------------------------------
+int ReadH5Ebsd::getXMinIndex() const
+{
+  return m_XMinIndex;
+}
+
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::setXMaxIndex(int value)
+{
+  m_XMaxIndex = value;
+}
+
+// -----------------------------------------------------------------------------
+int ReadH5Ebsd::getXMaxIndex() const
+{
+  return m_XMaxIndex;
+}
+
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::setYMinIndex(int value)
+{
+  m_YMinIndex = value;
+}
+
+// -----------------------------------------------------------------------------
+int ReadH5Ebsd::getYMinIndex() const
+{
+  return m_YMinIndex;
+}
+
+// -----------------------------------------------------------------------------
+void ReadH5Ebsd::setYMaxIndex(int value)
+{
+  m_YMaxIndex = value;
+}
+
+// -----------------------------------------------------------------------------
+int ReadH5Ebsd::getYMaxIndex() const
+{
+  return m_YMaxIndex;
+}
+
 // -----------------------------------------------------------------------------
 void ReadH5Ebsd::setDataArrayNames(const QSet<QString>& value)
 {
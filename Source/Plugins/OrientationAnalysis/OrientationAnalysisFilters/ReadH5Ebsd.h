@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "SIMPLib/SIMPLib.h"
@@ -73,6 +74,11 @@ class OrientationAnalysis_EXPORT ReadH5Ebsd : public AbstractFilter
   PYB11_PROPERTY(bool UseTransformations READ getUseTransformations WRITE setUseTransformations)
   PYB11_PROPERTY(int AngleRepresentation READ getAngleRepresentation WRITE setAngleRepresentation)
   PYB11_PROPERTY(QSet<QString> SelectedArrayNames READ getSelectedArrayNames WRITE setSelectedArrayNames)
+  PYB11_PROPERTY(bool ReadRegionOfInterest READ getReadRegionOfInterest WRITE setReadRegionOfInterest)
+  PYB11_PROPERTY(int XMinIndex READ getXMinIndex WRITE setXMinIndex)
+  PYB11_PROPERTY(int XMaxIndex READ getXMaxIndex WRITE setXMaxIndex)
+  PYB11_PROPERTY(int YMinIndex READ getYMinIndex WRITE setYMinIndex)
+  PYB11_PROPERTY(int YMaxIndex READ getYMaxIndex WRITE setYMaxIndex)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -214,6 +220,61 @@ public:
   QSet<QString> getSelectedArrayNames() const;
   Q_PROPERTY(QSet<QString> SelectedArrayNames READ getSelectedArrayNames WRITE setSelectedArrayNames)
 
+  /**
+   * @brief Setter property for ReadRegionOfInterest
+   */
+  void setReadRegionOfInterest(bool value);
+  /**
+   * @brief Getter property for ReadRegionOfInterest
+   * @return Value of ReadRegionOfInterest
+   */
+  bool getReadRegionOfInterest() const;
+  Q_PROPERTY(bool ReadRegionOfInterest READ getReadRegionOfInterest WRITE setReadRegionOfInterest)
+
+  /**
+   * @brief Setter property for XMinIndex
+   */
+  void setXMinIndex(int value);
+  /**
+   * @brief Getter property for XMinIndex
+   * @return Value of XMinIndex
+   */
+  int getXMinIndex() const;
+  Q_PROPERTY(int XMinIndex READ getXMinIndex WRITE setXMinIndex)
+
+  /**
+   * @brief Setter property for XMaxIndex
+   */
+  void setXMaxIndex(int value);
+  /**
+   * @brief Getter property for XMaxIndex
+   * @return Value of XMaxIndex
+   */
+  int getXMaxIndex() const;
+  Q_PROPERTY(int XMaxIndex READ getXMaxIndex WRITE setXMaxIndex)
+
+  /**
+   * @brief Setter property for YMinIndex
+   */
+  void setYMinIndex(int value);
+  /**
+   * @brief Getter property for YMinIndex
+   * @return Value of YMinIndex
+   */
+  int getYMinIndex() const;
+  Q_PROPERTY(int YMinIndex READ getYMinIndex WRITE setYMinIndex)
+
+  /**
+   * @brief Setter property for YMaxIndex
+   */
+  void setYMaxIndex(int value);
+  /**
+   * @brief Getter property for YMaxIndex
+   * @return Value of YMaxIndex
+   */
+  int getYMaxIndex() const;
+  Q_PROPERTY(int YMaxIndex READ getYMaxIndex WRITE setYMaxIndex)
+
   /**
    * @brief Setter property for DataArrayNames
    */
@@ -423,18 +484,45 @@ protected:
    */
   H5EbsdVolumeReader::Pointer initHKLEbsdVolumeReader();
 
+  /**
+   * @brief Returns the raw data of a named EBSD array, either from a volume reader or from a staged region of interest
+   */
+  using EbsdPointerLookup = std::function<void*(const std::string&)>;
+
   /**
    * @brief copyTSLArrays Copies the read arrays into the data container structure (TSL variant)
    * @param ebsdReader H5EbsdVolumeReader instance pointer
    */
   void copyTSLArrays(H5EbsdVolumeReader* ebsdReader);
 
+  /**
+   * @brief copyTSLArrays Copies the arrays returned by the lookup into the data container structure (TSL variant)
+   * @param getPointerByName Lookup for the raw EBSD arrays
+   */
+  void copyTSLArrays(const EbsdPointerLookup& getPointerByName);
+
   /**
    * @brief copyHKLArrays Copies the read arrays into the data container structure (HKL variant)
    * @param ebsdReader H5EbsdVolumeReader instance pointer
    */
   void copyHKLArrays(H5EbsdVolumeReader* ebsdReader);
 
+  /**
+   * @brief copyHKLArrays Copies the arrays returned by the lookup into the data container structure (HKL variant)
+   * @param getPointerByName Lookup for the raw EBSD arrays
+   */
+  void copyHKLArrays(const EbsdPointerLookup& getPointerByName);
+
+  /**
+   * @brief readRegionOfInterest Reads the selected slices one at a time and keeps only the XY region of
+   * interest of the selected arrays, so the full slices are never held in memory for the whole volume.
+   * @param ebsdReader H5EbsdVolumeReader instance pointer
+   * @param manufacturer Manufacturer string from the H5Ebsd file
+   * @param sliceDims Full X and Y dimensions of the slices in the file
+   * @return Integer error value
+   */
+  int32_t readRegionOfInterest(H5EbsdVolumeReader* ebsdReader, const std::string& manufacturer, const int64_t sliceDims[2]);
+
   /**
    * @brief loadInfo Reads the values for the phase type, crystal structure
    * and precipitate fractions from the EBSD file.
@@ -532,6 +620,11 @@ private:
   int m_ZEndIndex = {0};
   bool m_UseTransformations = {true};
   QSet<QString> m_SelectedArrayNames = {};
+  bool m_ReadRegionOfInterest = {false};
+  int m_XMinIndex = {0};
+  int m_XMaxIndex = {0};
+  int m_YMinIndex = {0};
+  int m_YMaxIndex = {0};
   QSet<QString> m_DataArrayNames = {};
   int m_AngleRepresentation = {EbsdLib::AngleRepresentation::Radians};
   uint32_t m_RefFrameZDir = {SIMPL::RefFrameZDir::UnknownRefFrameZDirection};
@@ -35,7 +35,9 @@
 
 #include "WritePoleFigure.h"
 
+#include <algorithm>
 #include <csetjmp>
+#include <thread>
 #include <vector>
 
 #include <QtCore/QDir>
@@ -76,6 +78,12 @@
 
 #include "hpdf.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 jmp_buf env;
 
 void error_handler(HPDF_STATUS error_no, HPDF_STATUS detail_no, void* /* user_data */)
@@ -598,6 +606,184 @@ void drawDiscreteInfoArea(HPDF_Page page, const PoleFigureConfiguration_t& confi
   HPDF_Page_EndText(page);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<EbsdLib::UInt8ArrayType::Pointer> makePoleFigures(uint32_t crystalStructure, PoleFigureConfiguration_t& config)
+{
+  std::vector<EbsdLib::UInt8ArrayType::Pointer> figures;
+  switch(crystalStructure)
+  {
+  case EbsdLib::CrystalStructure::Cubic_High:
+    figures = makePoleFigures<CubicOps>(config);
+    break;
+  case EbsdLib::CrystalStructure::Cubic_Low:
+    figures = makePoleFigures<CubicLowOps>(config);
+    break;
+  case EbsdLib::CrystalStructure::Hexagonal_High:
+    figures = makePoleFigures<HexagonalOps>(config);
+    break;
+  case EbsdLib::CrystalStructure::Hexagonal_Low:
+    figures = makePoleFigures<HexagonalLowOps>(config);
+    break;
+  case EbsdLib::CrystalStructure::Trigonal_High:
+    figures = makePoleFigures<TrigonalOps>(config);
+    //   setWarningCondition(-1010, "Trigonal High Symmetry is not supported for Pole figures. This phase will be omitted from results");
+    break;
+  case EbsdLib::CrystalStructure::Trigonal_Low:
+    figures = makePoleFigures<TrigonalLowOps>(config);
+    //  setWarningCondition(-1010, "Trigonal Low Symmetry is not supported for Pole figures. This phase will be omitted from results");
+    break;
+  case EbsdLib::CrystalStructure::Tetragonal_High:
+    figures = makePoleFigures<TetragonalOps>(config);
+    //  setWarningCondition(-1010, "Tetragonal High Symmetry is not supported for Pole figures. This phase will be omitted from results");
+    break;
+  case EbsdLib::CrystalStructure::Tetragonal_Low:
+    figures = makePoleFigures<TetragonalLowOps>(config);
+    // setWarningCondition(-1010, "Tetragonal Low Symmetry is not supported for Pole figures. This phase will be omitted from results");
+    break;
+  case EbsdLib::CrystalStructure::OrthoRhombic:
+    figures = makePoleFigures<OrthoRhombicOps>(config);
+    break;
+  case EbsdLib::CrystalStructure::Monoclinic:
+    figures = makePoleFigures<MonoclinicOps>(config);
+    break;
+  case EbsdLib::CrystalStructure::Triclinic:
+    figures = makePoleFigures<TriclinicOps>(config);
+    break;
+  default:
+    break;
+  }
+  return figures;
+}
+
+/**
+ * @brief The GatherPhaseEulersImpl class sorts the Euler angles of the cells by phase. The cells are split into fixed
+ * blocks; the first pass counts the cells of each phase in every block and the second pass copies each block into its
+ * own precomputed range of the per phase arrays, so the cells keep their original order without any locking.
+ */
+class GatherPhaseEulersImpl
+{
+public:
+  GatherPhaseEulersImpl(const float* cellEulerAngles, const int32_t* cellPhases, const bool* goodVoxels, size_t numPoints, size_t numPhases, size_t blockSize, std::vector<size_t>& blockCounts,
+                        std::vector<float*>& phaseEulers)
+  : m_CellEulerAngles(cellEulerAngles)
+  , m_CellPhases(cellPhases)
+  , m_GoodVoxels(goodVoxels)
+  , m_NumPoints(numPoints)
+  , m_NumPhases(numPhases)
+  , m_BlockSize(blockSize)
+  , m_BlockCounts(blockCounts)
+  , m_PhaseEulers(phaseEulers)
+  {
+  }
+  virtual ~GatherPhaseEulersImpl() = default;
+
+  /**
+   * @brief Selects between counting the cells of each block (before the per phase arrays exist) and copying them
+   * @param copy
+   */
+  void setCopy(bool copy)
+  {
+    m_Copy = copy;
+  }
+
+  void gather(size_t start, size_t end) const
+  {
+    for(size_t block = start; block < end; block++)
+    {
+      size_t* slots = m_BlockCounts.data() + block * m_NumPhases;
+      size_t blockEnd = std::min(m_NumPoints, (block + 1) * m_BlockSize);
+      for(size_t i = block * m_BlockSize; i < blockEnd; ++i)
+      {
+        int32_t phase = m_CellPhases[i];
+        if(phase < 1 || static_cast<size_t>(phase) >= m_NumPhases)
+        {
+          continue;
+        }
+        if(nullptr != m_GoodVoxels && !m_GoodVoxels[i])
+        {
+          continue;
+        }
+        if(m_Copy)
+        {
+          float* eu = m_PhaseEulers[phase] + slots[phase] * 3;
+          eu[0] = m_CellEulerAngles[i * 3];
+          eu[1] = m_CellEulerAngles[i * 3 + 1];
+          eu[2] = m_CellEulerAngles[i * 3 + 2];
+        }
+        slots[phase]++;
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    gather(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const float* m_CellEulerAngles;
+  const int32_t* m_CellPhases;
+  const bool* m_GoodVoxels;
+  size_t m_NumPoints;
+  size_t m_NumPhases;
+  size_t m_BlockSize;
+  std::vector<size_t>& m_BlockCounts;
+  std::vector<float*>& m_PhaseEulers;
+  bool m_Copy = false;
+};
+
+/**
+ * @brief The GeneratePoleFiguresImpl class generates, flips and mirrors the pole figures of several phases at once.
+ * Each phase only touches its own configuration and output slot.
+ */
+class GeneratePoleFiguresImpl
+{
+public:
+  GeneratePoleFiguresImpl(const std::vector<uint32_t>& crystalStructures, std::vector<PoleFigureConfiguration_t>& configs, std::vector<std::vector<EbsdLib::UInt8ArrayType::Pointer>>& figures)
+  : m_CrystalStructures(crystalStructures)
+  , m_Configs(configs)
+  , m_Figures(figures)
+  {
+  }
+  virtual ~GeneratePoleFiguresImpl() = default;
+
+  void generate(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      if(nullptr == m_Configs[i].eulers)
+      {
+        continue;
+      }
+      std::vector<EbsdLib::UInt8ArrayType::Pointer> figures = makePoleFigures(m_CrystalStructures[i], m_Configs[i]);
+      if(figures.size() == 3)
+      {
+        for(auto& figure : figures)
+        {
+          figure = flipAndMirrorPoleFigure(figure.get(), m_Configs[i]);
+        }
+      }
+      m_Figures[i] = figures;
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    generate(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const std::vector<uint32_t>& m_CrystalStructures;
+  std::vector<PoleFigureConfiguration_t>& m_Configs;
+  std::vector<std::vector<EbsdLib::UInt8ArrayType::Pointer>>& m_Figures;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -628,310 +814,302 @@ void WritePoleFigure::execute()
   // Find how many phases we have by getting the number of Crystal Structures
   size_t numPhases = m_CrystalStructuresPtr.lock()->getNumberOfTuples();
 
-  // Loop over all the voxels gathering the Eulers for a specific phase into an array
-  for(size_t phase = 1; phase < numPhases; ++phase)
+  // Sort the Eulers of every phase into their own arrays with a counting sort over blocks of cells. This reads the
+  // cells twice in total instead of twice per phase.
+  size_t blockSize = 65536;
+  size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+  std::vector<size_t> blockCounts(numBlocks * numPhases, 0);
+  std::vector<float*> phaseEulers(numPhases, nullptr);
+  GatherPhaseEulersImpl gatherImpl(m_CellEulerAngles, m_CellPhases, m_UseGoodVoxels ? m_GoodVoxels : nullptr, numPoints, numPhases, blockSize, blockCounts, phaseEulers);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numBlocks), gatherImpl, tbb::auto_partitioner());
+#else
+  gatherImpl.gather(0, numBlocks);
+#endif
+
+  // Turn the per block counts into the offset of each block inside the array of its phase
+  std::vector<size_t> phaseCounts(numPhases, 0);
+  for(size_t block = 0; block < numBlocks; block++)
   {
-    size_t count = 0;
-    // First find out how many voxels we are going to have. This is probably faster to loop twice than to
-    // keep allocating memory everytime we find one.
-    for(size_t i = 0; i < numPoints; ++i)
+    for(size_t phase = 1; phase < numPhases; ++phase)
     {
-      if(m_CellPhases[i] == phase)
-      {
-        if(!m_UseGoodVoxels || m_GoodVoxels[i])
-        {
-          count++;
-        }
-      }
+      size_t count = blockCounts[block * numPhases + phase];
+      blockCounts[block * numPhases + phase] = phaseCounts[phase];
+      phaseCounts[phase] += count;
     }
-    std::vector<size_t> eulerCompDim(1, 3);
-    EbsdLib::FloatArrayType::Pointer subEulers = EbsdLib::FloatArrayType::CreateArray(count, eulerCompDim, "Eulers_Per_Phase", true);
-    subEulers->initializeWithValue(std::numeric_limits<float>::signaling_NaN());
-    float* eu = subEulers->getPointer(0);
+  }
 
-    // Now loop through the eulers again and this time add them to the subEulers Array
-    count = 0;
-    for(size_t i = 0; i < numPoints; ++i)
-    {
-      if(m_CellPhases[i] == phase)
-      {
-        if(!m_UseGoodVoxels || m_GoodVoxels[i])
-        {
-          eu[count * 3] = m_CellEulerAngles[i * 3];
-          eu[count * 3 + 1] = m_CellEulerAngles[i * 3 + 1];
-          eu[count * 3 + 2] = m_CellEulerAngles[i * 3 + 2];
-          count++;
-        }
-      }
-    }
-    if(subEulers->getNumberOfTuples() == 0)
+  std::vector<EbsdLib::FloatArrayType::Pointer> subEulers(numPhases);
+  for(size_t phase = 1; phase < numPhases; ++phase)
+  {
+    if(phaseCounts[phase] == 0)
     {
       continue;
     } // Skip because we have no Pole Figure data
+    std::vector<size_t> eulerCompDim(1, 3);
+    subEulers[phase] = EbsdLib::FloatArrayType::CreateArray(phaseCounts[phase], eulerCompDim, "Eulers_Per_Phase", true);
+    phaseEulers[phase] = subEulers[phase]->getPointer(0);
+  }
 
-    std::vector<EbsdLib::UInt8ArrayType::Pointer> figures;
+  gatherImpl.setCopy(true);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numBlocks), gatherImpl, tbb::auto_partitioner());
+#else
+  gatherImpl.gather(0, numBlocks);
+#endif
 
-    PoleFigureConfiguration_t config;
-    config.eulers = subEulers.get();
-    config.imageDim = getImageSize();
-    config.lambertDim = getLambertSize();
-    config.numColors = getNumColors();
-    if(static_cast<WritePoleFigure::Algorithm>(getGenerationAlgorithm()) == WritePoleFigure::Algorithm::LambertProjection)
-    {
-      config.discrete = false;
-    }
-    else
-    {
-      config.discrete = true;
-    }
+  // The pole figures of a batch of phases are generated concurrently. Only that batch of images is held in memory
+  // at once, and the PDF files are still written one at a time because the libharu error handler shares one jmp_buf.
+  size_t batchSize = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  batchSize = std::max(1U, std::thread::hardware_concurrency());
+#endif
+  for(size_t batchStart = 1; batchStart < numPhases; batchStart += batchSize)
+  {
+    size_t batchEnd = std::min(numPhases, batchStart + batchSize);
+    std::vector<uint32_t> batchCrystalStructures(batchEnd - batchStart, 0);
+    std::vector<PoleFigureConfiguration_t> batchConfigs(batchEnd - batchStart);
+    std::vector<std::vector<EbsdLib::UInt8ArrayType::Pointer>> batchFigures(batchEnd - batchStart);
 
-    config.discreteHeatMap = m_UseDiscreteHeatMap;
+    for(size_t phase = batchStart; phase < batchEnd; ++phase)
+    {
+      PoleFigureConfiguration_t& config = batchConfigs[phase - batchStart];
+      config.eulers = subEulers[phase].get();
+      if(nullptr == config.eulers)
+      {
+        continue;
+      } // Skip because we have no Pole Figure data
 
-    QString label("Phase_");
-    label.append(QString::number(phase));
+      config.imageDim = getImageSize();
+      config.lambertDim = getLambertSize();
+      config.numColors = getNumColors();
+      if(static_cast<WritePoleFigure::Algorithm>(getGenerationAlgorithm()) == WritePoleFigure::Algorithm::LambertProjection)
+      {
+        config.discrete = false;
+      }
+      else
+      {
+        config.discrete = true;
+      }
 
-    QString ss = QObject::tr("Generating Pole Figures for Phase %1").arg(phase);
-    notifyStatusMessage(ss);
+      config.discreteHeatMap = m_UseDiscreteHeatMap;
+      batchCrystalStructures[phase - batchStart] = m_CrystalStructures[phase];
 
-    switch(m_CrystalStructures[phase])
-    {
-    case EbsdLib::CrystalStructure::Cubic_High:
-      figures = makePoleFigures<CubicOps>(config);
-      break;
-    case EbsdLib::CrystalStructure::Cubic_Low:
-      figures = makePoleFigures<CubicLowOps>(config);
-      break;
-    case EbsdLib::CrystalStructure::Hexagonal_High:
-      figures = makePoleFigures<HexagonalOps>(config);
-      break;
-    case EbsdLib::CrystalStructure::Hexagonal_Low:
-      figures = makePoleFigures<HexagonalLowOps>(config);
-      break;
-    case EbsdLib::CrystalStructure::Trigonal_High:
-      figures = makePoleFigures<TrigonalOps>(config);
-      //   setWarningCondition(-1010, "Trigonal High Symmetry is not supported for Pole figures. This phase will be omitted from results");
-      break;
-    case EbsdLib::CrystalStructure::Trigonal_Low:
-      figures = makePoleFigures<TrigonalLowOps>(config);
-      //  setWarningCondition(-1010, "Trigonal Low Symmetry is not supported for Pole figures. This phase will be omitted from results");
-      break;
-    case EbsdLib::CrystalStructure::Tetragonal_High:
-      figures = makePoleFigures<TetragonalOps>(config);
-      //  setWarningCondition(-1010, "Tetragonal High Symmetry is not supported for Pole figures. This phase will be omitted from results");
-      break;
-    case EbsdLib::CrystalStructure::Tetragonal_Low:
-      figures = makePoleFigures<TetragonalLowOps>(config);
-      // setWarningCondition(-1010, "Tetragonal Low Symmetry is not supported for Pole figures. This phase will be omitted from results");
-      break;
-    case EbsdLib::CrystalStructure::OrthoRhombic:
-      figures = makePoleFigures<OrthoRhombicOps>(config);
-      break;
-    case EbsdLib::CrystalStructure::Monoclinic:
-      figures = makePoleFigures<MonoclinicOps>(config);
-      break;
-    case EbsdLib::CrystalStructure::Triclinic:
-      figures = makePoleFigures<TriclinicOps>(config);
-      break;
-    default:
-      break;
+      QString ss = QObject::tr("Generating Pole Figures for Phase %1").arg(phase);
+      notifyStatusMessage(ss);
     }
 
-    if(figures.size() == 3)
-    {
-      QString filename = generateImagePath(label);
+    GeneratePoleFiguresImpl generateImpl(batchCrystalStructures, batchConfigs, batchFigures);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, batchEnd - batchStart, 1), generateImpl, tbb::simple_partitioner());
+#else
+    generateImpl.generate(0, batchEnd - batchStart);
+#endif
 
-      HPDF_Doc pdf = HPDF_New(error_handler, nullptr);
+    for(size_t phase = batchStart; phase < batchEnd; ++phase)
+    {
+      std::vector<EbsdLib::UInt8ArrayType::Pointer>& figures = batchFigures[phase - batchStart];
+      const PoleFigureConfiguration_t& config = batchConfigs[phase - batchStart];
 
-      HPDF_SetCompressionMode(pdf, HPDF_COMP_ALL);
+      QString label("Phase_");
+      label.append(QString::number(phase));
 
-      /* create default-font */
-      HPDF_Font font = HPDF_GetFont(pdf, "Helvetica", nullptr);
+      if(figures.size() == 3)
+      {
+        QString filename = generateImagePath(label);
 
-      HPDF_BYTE buf[1] = {'X'};
+        HPDF_Doc pdf = HPDF_New(error_handler, nullptr);
 
-      HPDF_TextWidth textWidth = HPDF_Font_TextWidth(font, buf, 1);
+        HPDF_SetCompressionMode(pdf, HPDF_COMP_ALL);
 
-      HPDF_REAL pageWidth = 0.0f;
-      HPDF_REAL pageHeight = 0.0f;
+        /* create default-font */
+        HPDF_Font font = HPDF_GetFont(pdf, "Helvetica", nullptr);
 
-      HPDF_UINT imageWidth = static_cast<HPDF_UINT>(config.imageDim);
-      HPDF_UINT imageHeight = static_cast<HPDF_UINT>(config.imageDim);
-      HPDF_REAL fontPtSize = imageHeight / 16.0f;
-      HPDF_REAL margins = imageHeight / 32.0f;
+        HPDF_BYTE buf[1] = {'X'};
 
-      HPDF_REAL xCharWidth = textWidth.width * fontPtSize / 1000;
+        HPDF_TextWidth textWidth = HPDF_Font_TextWidth(font, buf, 1);
 
-      // Each Pole Figure gets it's own Square mini canvas to draw into.
-      HPDF_REAL subCanvasWidth = margins + imageWidth + xCharWidth + margins;
-      HPDF_REAL subCanvasHeight = margins + fontPtSize + imageHeight + fontPtSize * 2 + margins * 2;
+        HPDF_REAL pageWidth = 0.0f;
+        HPDF_REAL pageHeight = 0.0f;
 
-      QVector<std::pair<HPDF_REAL, HPDF_REAL>> imagePositions(4);
-      if(m_ImageLayout == SIMPL::Layout::Horizontal)
-      {
-        pageWidth = subCanvasWidth * 4;
-        pageHeight = subCanvasHeight;
-        imagePositions[0] = std::make_pair(0.0f, 0.0f);
-        imagePositions[1] = std::make_pair(subCanvasWidth, 0.0f);
-        imagePositions[2] = std::make_pair(subCanvasWidth * 2.0f, 0.0f);
-        imagePositions[3] = std::make_pair(subCanvasWidth * 3.0f, 0.0f);
-      }
-      else if(m_ImageLayout == SIMPL::Layout::Vertical)
-      {
-        pageWidth = subCanvasWidth;
-        pageHeight = subCanvasHeight * 4.0f;
-        imagePositions[0] = std::make_pair(0.0f, subCanvasHeight * 3.0f);
-        imagePositions[1] = std::make_pair(0.0f, subCanvasHeight * 2.0f);
-        imagePositions[2] = std::make_pair(0.0f, subCanvasHeight * 1.0f);
-        imagePositions[3] = std::make_pair(0.0f, 0.0f);
-      }
-      else if(m_ImageLayout == SIMPL::Layout::Square)
-      {
-        pageWidth = subCanvasWidth * 2.0f;
-        pageHeight = subCanvasHeight * 2.0f;
-        imagePositions[0] = std::make_pair(0.0f, subCanvasHeight);           // Upper Left
-        imagePositions[1] = std::make_pair(subCanvasWidth, subCanvasHeight); // Upper Right
-        imagePositions[2] = std::make_pair(0.0f, 0.0f);                      // Lower Left
-        imagePositions[3] = std::make_pair(subCanvasWidth, 0.0f);            // Lower Right
-      }
+        HPDF_UINT imageWidth = static_cast<HPDF_UINT>(config.imageDim);
+        HPDF_UINT imageHeight = static_cast<HPDF_UINT>(config.imageDim);
+        HPDF_REAL fontPtSize = imageHeight / 16.0f;
+        HPDF_REAL margins = imageHeight / 32.0f;
 
-      pageHeight = pageHeight + margins + fontPtSize;
+        HPDF_REAL xCharWidth = textWidth.width * fontPtSize / 1000;
 
-      /* add a new page object. */
-      HPDF_Page page = HPDF_AddPage(pdf);
-      HPDF_Page_SetWidth(page, pageWidth);
-      HPDF_Page_SetHeight(page, pageHeight);
+        // Each Pole Figure gets it's own Square mini canvas to draw into.
+        HPDF_REAL subCanvasWidth = margins + imageWidth + xCharWidth + margins;
+        HPDF_REAL subCanvasHeight = margins + fontPtSize + imageHeight + fontPtSize * 2 + margins * 2;
 
-      QVector<HPDF_Image> pdfImages(figures.size());
-      HPDF_ColorSpace colorSpace = HPDF_CS_DEVICE_RGB;
-      for(int a = 0; a < figures.size(); a++)
-      {
-        figures[a] = flipAndMirrorPoleFigure(figures[a].get(), config);
-        HPDF_Image image = HPDF_LoadRawImageFromMem(pdf, figures[a]->getPointer(0), static_cast<HPDF_UINT>(config.imageDim), static_cast<HPDF_UINT>(config.imageDim), colorSpace, 8);
-        pdfImages[a] = image;
-      }
+        QVector<std::pair<HPDF_REAL, HPDF_REAL>> imagePositions(4);
+        if(m_ImageLayout == SIMPL::Layout::Horizontal)
+        {
+          pageWidth = subCanvasWidth * 4;
+          pageHeight = subCanvasHeight;
+          imagePositions[0] = std::make_pair(0.0f, 0.0f);
+          imagePositions[1] = std::make_pair(subCanvasWidth, 0.0f);
+          imagePositions[2] = std::make_pair(subCanvasWidth * 2.0f, 0.0f);
+          imagePositions[3] = std::make_pair(subCanvasWidth * 3.0f, 0.0f);
+        }
+        else if(m_ImageLayout == SIMPL::Layout::Vertical)
+        {
+          pageWidth = subCanvasWidth;
+          pageHeight = subCanvasHeight * 4.0f;
+          imagePositions[0] = std::make_pair(0.0f, subCanvasHeight * 3.0f);
+          imagePositions[1] = std::make_pair(0.0f, subCanvasHeight * 2.0f);
+          imagePositions[2] = std::make_pair(0.0f, subCanvasHeight * 1.0f);
+          imagePositions[3] = std::make_pair(0.0f, 0.0f);
+        }
+        else if(m_ImageLayout == SIMPL::Layout::Square)
+        {
+          pageWidth = subCanvasWidth * 2.0f;
+          pageHeight = subCanvasHeight * 2.0f;
+          imagePositions[0] = std::make_pair(0.0f, subCanvasHeight);           // Upper Left
+          imagePositions[1] = std::make_pair(subCanvasWidth, subCanvasHeight); // Upper Right
+          imagePositions[2] = std::make_pair(0.0f, 0.0f);                      // Lower Left
+          imagePositions[3] = std::make_pair(subCanvasWidth, 0.0f);            // Lower Right
+        }
 
-      // Create the Scalar Bar image
-      // QImage scalarBar = PoleFigureImageUtilities::GenerateScalarBar(img0.width(), imageHeight, config);
+        pageHeight = pageHeight + margins + fontPtSize;
 
-      for(int i = 0; i < 3; i++)
-      {
-        HPDF_REAL x = 0.0f;
-        HPDF_REAL y = 0.0f;
+        /* add a new page object. */
+        HPDF_Page page = HPDF_AddPage(pdf);
+        HPDF_Page_SetWidth(page, pageWidth);
+        HPDF_Page_SetHeight(page, pageHeight);
 
-        std::tie(x, y) = imagePositions[i];
+        QVector<HPDF_Image> pdfImages(figures.size());
+        HPDF_ColorSpace colorSpace = HPDF_CS_DEVICE_RGB;
+        for(int a = 0; a < figures.size(); a++)
+        {
+          HPDF_Image image = HPDF_LoadRawImageFromMem(pdf, figures[a]->getPointer(0), static_cast<HPDF_UINT>(config.imageDim), static_cast<HPDF_UINT>(config.imageDim), colorSpace, 8);
+          pdfImages[a] = image;
+        }
 
-        /* Draw image to the canvas. (normal-mode with actual size.)*/
-        HPDF_Page_DrawImage(page, pdfImages[i], x + margins, y + margins + fontPtSize, imageWidth, imageHeight);
+        // Create the Scalar Bar image
+        // QImage scalarBar = PoleFigureImageUtilities::GenerateScalarBar(img0.width(), imageHeight, config);
 
-        QString text = S2Q(figures[i]->getName());
-        std::vector<uint8_t> buffer;
-        QString modText;
-        int k = 0;
-        while(k < text.length())
+        for(int i = 0; i < 3; i++)
         {
-          if(text.at(k) == '-')
-          {
-            HPDF_TextWidth tw = HPDF_Font_TextWidth(font, buffer.data(), static_cast<HPDF_UINT>(buffer.size()));
-            int32_t scaledOffset = static_cast<int32_t>(tw.width * fontPtSize / 1000);
-
-            buffer.push_back(static_cast<uint8_t>(text.at(k + 1).toLatin1()));
-            tw = HPDF_Font_TextWidth(font, buffer.data(), static_cast<HPDF_UINT>(buffer.size()));
-            int32_t scaledOffset2 = static_cast<int32_t>(tw.width * fontPtSize / 1000);
-            buffer.pop_back();
-
-            int32_t diff = (scaledOffset2 - scaledOffset);
-
-            buf[0] = '-';
-            tw = HPDF_Font_TextWidth(font, buf, 1);
-            int32_t charWidth = static_cast<int32_t>(tw.width * fontPtSize / 1000.0f);
-            scaledOffset = scaledOffset + (diff - charWidth) / 2;
-            // Draw the bar at the correct location...
-            std::string underScore("-");
-            HPDF_Page_BeginText(page);
-            HPDF_Page_SetFontAndSize(page, font, fontPtSize);
-            HPDF_Page_MoveTextPos(page, x + margins + scaledOffset, y + margins + fontPtSize + imageHeight + fontPtSize * 1.60f + margins);
-            HPDF_Page_ShowText(page, underScore.c_str());
-            HPDF_Page_EndText(page);
+          HPDF_REAL x = 0.0f;
+          HPDF_REAL y = 0.0f;
+
+          std::tie(x, y) = imagePositions[i];
+
+          /* Draw image to the canvas. (normal-mode with actual size.)*/
+          HPDF_Page_DrawImage(page, pdfImages[i], x + margins, y + margins + fontPtSize, imageWidth, imageHeight);
 
+          QString text = S2Q(figures[i]->getName());
+          std::vector<uint8_t> buffer;
+          QString modText;
+          int k = 0;
+          while(k < text.length())
+          {
+            if(text.at(k) == '-')
+            {
+              HPDF_TextWidth tw = HPDF_Font_TextWidth(font, buffer.data(), static_cast<HPDF_UINT>(buffer.size()));
+              int32_t scaledOffset = static_cast<int32_t>(tw.width * fontPtSize / 1000);
+
+              buffer.push_back(static_cast<uint8_t>(text.at(k + 1).toLatin1()));
+              tw = HPDF_Font_TextWidth(font, buffer.data(), static_cast<HPDF_UINT>(buffer.size()));
+              int32_t scaledOffset2 = static_cast<int32_t>(tw.width * fontPtSize / 1000);
+              buffer.pop_back();
+
+              int32_t diff = (scaledOffset2 - scaledOffset);
+
+              buf[0] = '-';
+              tw = HPDF_Font_TextWidth(font, buf, 1);
+              int32_t charWidth = static_cast<int32_t>(tw.width * fontPtSize / 1000.0f);
+              scaledOffset = scaledOffset + (diff - charWidth) / 2;
+              // Draw the bar at the correct location...
+              std::string underScore("-");
+              HPDF_Page_BeginText(page);
+              HPDF_Page_SetFontAndSize(page, font, fontPtSize);
+              HPDF_Page_MoveTextPos(page, x + margins + scaledOffset, y + margins + fontPtSize + imageHeight + fontPtSize * 1.60f + margins);
+              HPDF_Page_ShowText(page, underScore.c_str());
+              HPDF_Page_EndText(page);
+
+              k++;
+            }
+            // Keep building up the string to finally print.
+            if(text.at(k) != '-')
+            {
+              modText = modText + text.at(k);
+              buffer.push_back(static_cast<uint8_t>(text.at(k).toLatin1()));
+            }
             k++;
           }
-          // Keep building up the string to finally print.
-          if(text.at(k) != '-')
+
+          HPDF_Page_BeginText(page);
+          HPDF_Page_SetFontAndSize(page, font, fontPtSize);
+
+          HPDF_Page_MoveTextPos(page, x + margins, y + margins + fontPtSize + imageHeight + fontPtSize + margins);
+          HPDF_Page_ShowText(page, modText.toLatin1());
+          HPDF_Page_EndText(page);
+
+          HPDF_REAL lineWidth = imageWidth / 512.0f;
+          if(lineWidth < 1.0f)
           {
-            modText = modText + text.at(k);
-            buffer.push_back(static_cast<uint8_t>(text.at(k).toLatin1()));
+            lineWidth = 1.0f;
           }
-          k++;
+
+          HPDF_Page_SetLineWidth(page, lineWidth);
+          HPDF_Page_SetRGBStroke(page, 0.0f, 0.0f, 0.0f);
+          HPDF_Page_SetGrayStroke(page, 0.30f);
+
+          // Draw
+          HPDF_Page_Circle(page, x + margins + imageWidth / 2.0f, y + margins + fontPtSize + imageWidth / 2.0f, imageWidth / 2.0f);
+          // Draw the Horizontal Axis
+          HPDF_Page_MoveTo(page, x + margins, y + margins + fontPtSize + imageWidth / 2.0f);
+          HPDF_Page_LineTo(page, x + margins + imageWidth, y + margins + fontPtSize + imageWidth / 2.0f);
+          // Draw the Vertical Axis
+          HPDF_Page_MoveTo(page, x + margins + imageWidth / 2.0f, y + margins + fontPtSize);
+          HPDF_Page_LineTo(page, x + margins + imageWidth / 2.0f, y + margins + fontPtSize + imageHeight);
+          HPDF_Page_Stroke(page);
+
+          // Label the X Axis
+          HPDF_Page_BeginText(page);
+          HPDF_Page_SetFontAndSize(page, font, fontPtSize);
+          HPDF_Page_MoveTextPos(page, x + margins + imageWidth, y + margins + fontPtSize + imageHeight / 2.0f - fontPtSize * .33f);
+          HPDF_Page_ShowText(page, " X");
+          HPDF_Page_EndText(page);
+
+          // Label the Y Axis
+          HPDF_Page_BeginText(page);
+          HPDF_Page_SetFontAndSize(page, font, fontPtSize);
+          HPDF_Page_MoveTextPos(page, x + margins + imageWidth / 2.0f - xCharWidth / 2.0f, y + margins + fontPtSize + imageHeight + fontPtSize * 0.10f);
+          HPDF_Page_ShowText(page, "Y");
+          HPDF_Page_EndText(page);
         }
 
+        std::vector<std::string> laueNames = LaueOps::GetLaueNames();
+        uint32_t laueIndex = m_CrystalStructures[phase];
+        // Draw the title onto the canvas
+        QString materialName = m_MaterialNames->getValue(phase);
+        QString fullTitle = QString("%1").arg(getTitle());
         HPDF_Page_BeginText(page);
-        HPDF_Page_SetFontAndSize(page, font, fontPtSize);
-
-        HPDF_Page_MoveTextPos(page, x + margins, y + margins + fontPtSize + imageHeight + fontPtSize + margins);
-        HPDF_Page_ShowText(page, modText.toLatin1());
+        HPDF_Page_SetFontAndSize(page, font, imageHeight / 12.0f);
+        HPDF_Page_MoveTextPos(page, margins, pageHeight - margins / 2.0f - fontPtSize);
+        HPDF_Page_ShowText(page, fullTitle.toLatin1());
         HPDF_Page_EndText(page);
 
-        HPDF_REAL lineWidth = imageWidth / 512.0f;
-        if(lineWidth < 1.0f)
+        // Now draw the Color Scalar Bar if needed.
+        if(config.discrete)
         {
-          lineWidth = 1.0f;
+          drawDiscreteInfoArea(page, config, imagePositions[3], margins, imageHeight / 20.0f, font, static_cast<int32_t>(phase), S2Q(laueNames[laueIndex]), materialName);
+        }
+        else
+        {
+          drawScalarBar(page, config, imagePositions[3], margins, imageHeight / 20.0f, font, static_cast<int32_t>(phase), S2Q(laueNames[laueIndex]), materialName);
         }
 
-        HPDF_Page_SetLineWidth(page, lineWidth);
-        HPDF_Page_SetRGBStroke(page, 0.0f, 0.0f, 0.0f);
-        HPDF_Page_SetGrayStroke(page, 0.30f);
-
-        // Draw
-        HPDF_Page_Circle(page, x + margins + imageWidth / 2.0f, y + margins + fontPtSize + imageWidth / 2.0f, imageWidth / 2.0f);
-        // Draw the Horizontal Axis
-        HPDF_Page_MoveTo(page, x + margins, y + margins + fontPtSize + imageWidth / 2.0f);
-        HPDF_Page_LineTo(page, x + margins + imageWidth, y + margins + fontPtSize + imageWidth / 2.0f);
-        // Draw the Vertical Axis
-        HPDF_Page_MoveTo(page, x + margins + imageWidth / 2.0f, y + margins + fontPtSize);
-        HPDF_Page_LineTo(page, x + margins + imageWidth / 2.0f, y + margins + fontPtSize + imageHeight);
-        HPDF_Page_Stroke(page);
-
-        // Label the X Axis
-        HPDF_Page_BeginText(page);
-        HPDF_Page_SetFontAndSize(page, font, fontPtSize);
-        HPDF_Page_MoveTextPos(page, x + margins + imageWidth, y + margins + fontPtSize + imageHeight / 2.0f - fontPtSize * .33f);
-        HPDF_Page_ShowText(page, " X");
-        HPDF_Page_EndText(page);
-
-        // Label the Y Axis
-        HPDF_Page_BeginText(page);
-        HPDF_Page_SetFontAndSize(page, font, fontPtSize);
-        HPDF_Page_MoveTextPos(page, x + margins + imageWidth / 2.0f - xCharWidth / 2.0f, y + margins + fontPtSize + imageHeight + fontPtSize * 0.10f);
-        HPDF_Page_ShowText(page, "Y");
-        HPDF_Page_EndText(page);
-      }
+        /* save the document to a file */
+        HPDF_SaveToFile(pdf, filename.toLatin1());
 
-      std::vector<std::string> laueNames = LaueOps::GetLaueNames();
-      uint32_t laueIndex = m_CrystalStructures[phase];
-      // Draw the title onto the canvas
-      QString materialName = m_MaterialNames->getValue(phase);
-      QString fullTitle = QString("%1").arg(getTitle());
-      HPDF_Page_BeginText(page);
-      HPDF_Page_SetFontAndSize(page, font, imageHeight / 12.0f);
-      HPDF_Page_MoveTextPos(page, margins, pageHeight - margins / 2.0f - fontPtSize);
-      HPDF_Page_ShowText(page, fullTitle.toLatin1());
-      HPDF_Page_EndText(page);
-
-      // Now draw the Color Scalar Bar if needed.
-      if(config.discrete)
-      {
-        drawDiscreteInfoArea(page, config, imagePositions[3], margins, imageHeight / 20.0f, font, static_cast<int32_t>(phase), S2Q(laueNames[laueIndex]), materialName);
-      }
-      else
-      {
-        drawScalarBar(page, config, imagePositions[3], margins, imageHeight / 20.0f, font, static_cast<int32_t>(phase), S2Q(laueNames[laueIndex]), materialName);
+        /* clean up */
+        HPDF_Free(pdf);
       }
-
-      /* save the document to a file */
-      HPDF_SaveToFile(pdf, filename.toLatin1());
-
-      /* clean up */
-      HPDF_Free(pdf);
     }
   }
 }
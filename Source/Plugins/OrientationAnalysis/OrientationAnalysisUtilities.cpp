@@ -1,5 +1,9 @@
 #include "OrientationAnalysisUtilities.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "EbsdLib/LaueOps/LaueOps.h"
 
 namespace OrientationUtilities {
@@ -31,4 +35,55 @@ namespace OrientationUtilities {
     }
 
 
+    // -----------------------------------------------------------------------------
+    UnitVectorGrid::UnitVectorGrid(const std::vector<float>& vectors, double maxAngle) {
+        // Two unit vectors within maxAngle of each other are closer than this chord length. The small margin covers
+        // round off in the callers' own angle tests. With cells at least one chord wide, every vector near a query
+        // lies in the cell of the query or one of its 26 neighbors.
+        double halfAngle = std::min(maxAngle * 0.5, std::acos(0.0));
+        double chord = 2.0 * std::sin(halfAngle) * 1.001 + 1.0E-6;
+        m_Dim = static_cast<size_t>(std::max(1.0, std::min(64.0, std::floor(2.0 / chord))));
+
+        size_t numVectors = vectors.size() / 3;
+        std::vector<size_t> cells(numVectors);
+        m_CellOffsets.assign(m_Dim * m_Dim * m_Dim + 1, 0);
+        for (size_t i = 0; i < numVectors; i++) {
+            cells[i] = (cellIndex(vectors[3 * i + 2]) * m_Dim + cellIndex(vectors[3 * i + 1])) * m_Dim + cellIndex(vectors[3 * i]);
+            m_CellOffsets[cells[i] + 1]++;
+        }
+        for (size_t c = 0; c < m_Dim * m_Dim * m_Dim; c++) {
+            m_CellOffsets[c + 1] += m_CellOffsets[c];
+        }
+        m_Ids.resize(numVectors);
+        std::vector<size_t> fill(m_CellOffsets.begin(), m_CellOffsets.end() - 1);
+        for (size_t i = 0; i < numVectors; i++) {
+            m_Ids[fill[cells[i]]++] = i;
+        }
+    }
+
+    // -----------------------------------------------------------------------------
+    size_t UnitVectorGrid::cellIndex(double value) const {
+        double scaled = (std::min(1.0, std::max(-1.0, value)) + 1.0) * 0.5 * static_cast<double>(m_Dim);
+        return std::min(m_Dim - 1, static_cast<size_t>(scaled));
+    }
+
+    // -----------------------------------------------------------------------------
+    void UnitVectorGrid::findCandidates(double x, double y, double z, std::vector<size_t>& candidates) const {
+        std::array<size_t, 3> center = {cellIndex(x), cellIndex(y), cellIndex(z)};
+        std::array<size_t, 3> lower = {0, 0, 0};
+        std::array<size_t, 3> upper = {0, 0, 0};
+        for (size_t i = 0; i < 3; i++) {
+            lower[i] = (center[i] > 0) ? center[i] - 1 : 0;
+            upper[i] = std::min(m_Dim - 1, center[i] + 1);
+        }
+        for (size_t cz = lower[2]; cz <= upper[2]; cz++) {
+            for (size_t cy = lower[1]; cy <= upper[1]; cy++) {
+                for (size_t cx = lower[0]; cx <= upper[0]; cx++) {
+                    size_t cell = (cz * m_Dim + cy) * m_Dim + cx;
+                    candidates.insert(candidates.end(), m_Ids.begin() + m_CellOffsets[cell], m_Ids.begin() + m_CellOffsets[cell + 1]);
+                }
+            }
+        }
+    }
+
 } // namespace OrientationUtilities
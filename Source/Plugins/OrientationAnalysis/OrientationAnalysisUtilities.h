@@ -3,6 +3,9 @@
 #include "EbsdLib/Core/EbsdLibConstants.h"
 #include "EbsdLib/Core/Orientation.hpp"
 
+#include <cstddef>
+#include <vector>
+
 #include <Eigen/Dense>
 
 namespace OrientationUtilities {
@@ -45,4 +48,35 @@ namespace OrientationUtilities {
         eigenMatrix(2, 2) = ebsdMatrix[8];
         return eigenMatrix;
     }
+
+    /**
+     * @brief The UnitVectorGrid class buckets a set of unit vectors into a uniform grid over the cube [-1, 1]^3 so
+     * that the vectors lying within a fixed angle of a query direction can be found without visiting all of them.
+     */
+    class UnitVectorGrid {
+    public:
+        /**
+         * @brief UnitVectorGrid
+         * @param vectors The x, y, z components of the vectors, 3 values per vector
+         * @param maxAngle The largest angle (in radians) between a vector and a query direction that will be asked for
+         */
+        UnitVectorGrid(const std::vector<float>& vectors, double maxAngle);
+
+        /**
+         * @brief Appends the index of every vector that may lie within maxAngle of the direction. Vectors that are
+         * slightly further away can be included, but no vector within maxAngle is ever left out.
+         * @param x
+         * @param y
+         * @param z
+         * @param candidates
+         */
+        void findCandidates(double x, double y, double z, std::vector<size_t>& candidates) const;
+
+    private:
+        size_t cellIndex(double value) const;
+
+        size_t m_Dim = 1;
+        std::vector<size_t> m_CellOffsets;
+        std::vector<size_t> m_Ids;
+    };
 } // namespace OrientationUtilities
@@ -2,6 +2,10 @@
 // Insert your license & copyright information here
 // -----------------------------------------------------------------------------
 
+#include <array>
+#include <cmath>
+#include <random>
+
 #include <QtCore/QFile>
 
 #include "SIMPLib/SIMPLib.h"
@@ -20,15 +24,23 @@
 #include "SIMPLib/Filtering/FilterManager.h"
 #include "SIMPLib/Filtering/FilterPipeline.h"
 #include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Messages/FilterStatusMessage.h"
 #include "SIMPLib/Plugin/ISIMPLibPlugin.h"
 #include "SIMPLib/Plugin/SIMPLibPluginLoader.h"
 #include "UnitTestSupport.hpp"
 
+#include "EbsdLib/Core/EbsdLibConstants.h"
+
 #include "OrientationAnalysis/OrientationAnalysisFilters/CreateEnsembleInfo.h"
 #include "OrientationAnalysis/OrientationAnalysisFilters/FindAvgOrientations.h"
+#include "OrientationAnalysis/OrientationAnalysisFilters/FindKernelAvgMisorientations.h"
 #include "OrientationAnalysisTestFileLocations.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_arena.h>
+#endif
+
 #define CREATE_FILTER_STATUS(var, index) FilterStatusMessage::New(var->getNameOfClass(), var->getHumanLabel(), index, var->getHumanLabel() + " Complete")
 
 class FindFeatureValuesTest
@@ -53,11 +65,8 @@ public:
   }
 
   // -----------------------------------------------------------------------------
-  void Test()
+  DataContainerArray::Pointer importTestData(Observer& obs, int32_t& index)
   {
-    Observer obs;
-    int32_t index = 0;
-
     DataContainerArray::Pointer dca = DataContainerArray::New();
 
     CreateDataContainer::Pointer createDataContainer = CreateDataContainer::New();
@@ -161,18 +170,40 @@ public:
     err = createEnsembleInfo->getErrorCode();
     DREAM3D_REQUIRED(err, ==, 0)
 
+    ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+    imageGeom->setDimensions(SizeVec3Type(306, 75, 1));
+    dca->getDataContainer("DataContainer")->setGeometry(imageGeom);
+
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  FindAvgOrientations::Pointer createFindAvgOrientations(DataContainerArray::Pointer dca, Observer& obs, const QString& avgQuatsName, bool useReferenceOrientation)
+  {
     FindAvgOrientations::Pointer findAvgOrient = FindAvgOrientations::New();
     findAvgOrient->connect(findAvgOrient.get(), SIGNAL(messageGenerated(const AbstractMessage::Pointer&)), &obs, SLOT(processPipelineMessage(const AbstractMessage::Pointer&)));
     findAvgOrient->setDataContainerArray(dca);
-    findAvgOrient->setAvgEulerAnglesArrayPath({"DataContainer", "FeatureData", "EulerAngles"});
-    findAvgOrient->setAvgQuatsArrayPath({"DataContainer", "FeatureData", "AvgQuats"});
+    findAvgOrient->setAvgEulerAnglesArrayPath({"DataContainer", "FeatureData", avgQuatsName + "_EulerAngles"});
+    findAvgOrient->setAvgQuatsArrayPath({"DataContainer", "FeatureData", avgQuatsName});
     findAvgOrient->setCellPhasesArrayPath({"DataContainer", "CellData", "Phases"});
     findAvgOrient->setCrystalStructuresArrayPath({"DataContainer", "PhaseData", "CrystalStructures"});
     findAvgOrient->setFeatureIdsArrayPath({"DataContainer", "CellData", "FeatureIds"});
     findAvgOrient->setQuatsArrayPath({"DataContainer", "CellData", "Quats"});
+    findAvgOrient->setUseReferenceOrientation(useReferenceOrientation);
+    return findAvgOrient;
+  }
+
+  // -----------------------------------------------------------------------------
+  void Test()
+  {
+    Observer obs;
+    int32_t index = 0;
+    DataContainerArray::Pointer dca = importTestData(obs, index);
+
+    FindAvgOrientations::Pointer findAvgOrient = createFindAvgOrientations(dca, obs, "AvgQuats", false);
     findAvgOrient->execute();
-    createDataContainer->messageGenerated(CREATE_FILTER_STATUS(findAvgOrient, ++index));
-    err = findAvgOrient->getErrorCode();
+    findAvgOrient->messageGenerated(CREATE_FILTER_STATUS(findAvgOrient, ++index));
+    int32_t err = findAvgOrient->getErrorCode();
     DREAM3D_REQUIRED(err, ==, 0)
 
     FloatArrayType& groundTruthAvgQuats = *(dca->getPrereqArrayFromPath<FloatArrayType>(nullptr, {"DataContainer", "FeatureData", "AvgQuats_GroundTruth"}, {4}));
@@ -184,6 +215,201 @@ public:
     }
   }
 
+  // -----------------------------------------------------------------------------
+  void TestReferenceOrientationAverages()
+  {
+    Observer obs;
+    int32_t index = 0;
+    DataContainerArray::Pointer dca = importTestData(obs, index);
+
+    // The reference orientation mode has to give bit identical averages on one thread and on all of them
+    {
+      FindAvgOrientations::Pointer findAvgOrient = createFindAvgOrientations(dca, obs, "AvgQuats_Reference1", true);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      tbb::task_arena singleThreadArena(1);
+      singleThreadArena.execute([&] { findAvgOrient->execute(); });
+#else
+      findAvgOrient->execute();
+#endif
+      findAvgOrient->messageGenerated(CREATE_FILTER_STATUS(findAvgOrient, ++index));
+      int32_t err = findAvgOrient->getErrorCode();
+      DREAM3D_REQUIRED(err, ==, 0)
+    }
+    {
+      FindAvgOrientations::Pointer findAvgOrient = createFindAvgOrientations(dca, obs, "AvgQuats_Reference2", true);
+      findAvgOrient->execute();
+      findAvgOrient->messageGenerated(CREATE_FILTER_STATUS(findAvgOrient, ++index));
+      int32_t err = findAvgOrient->getErrorCode();
+      DREAM3D_REQUIRED(err, ==, 0)
+    }
+
+    FloatArrayType& groundTruthAvgQuats = *(dca->getPrereqArrayFromPath<FloatArrayType>(nullptr, {"DataContainer", "FeatureData", "AvgQuats_GroundTruth"}, {4}));
+    FloatArrayType& referenceAvgQuats1 = *(dca->getPrereqArrayFromPath<FloatArrayType>(nullptr, {"DataContainer", "FeatureData", "AvgQuats_Reference1"}, {4}));
+    FloatArrayType& referenceAvgQuats2 = *(dca->getPrereqArrayFromPath<FloatArrayType>(nullptr, {"DataContainer", "FeatureData", "AvgQuats_Reference2"}, {4}));
+    size_t size = referenceAvgQuats1.size();
+    for(size_t i = 0; i < size; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(referenceAvgQuats1[i], referenceAvgQuats2[i])
+    }
+
+    // The reference orientation average may only differ slightly from the running average
+    for(size_t i = 1; i < referenceAvgQuats1.getNumberOfTuples(); i++)
+    {
+      float dot = 0.0f;
+      for(size_t c = 0; c < 4; c++)
+      {
+        dot += groundTruthAvgQuats[i * 4 + c] * referenceAvgQuats1[i * 4 + c];
+      }
+      DREAM3D_REQUIRE(std::fabs(dot) > 0.99f)
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  FloatArrayType::Pointer runKernelAvgMisorientations(DataContainerArray::Pointer dca, Observer& obs, int32_t& index, const QString& dcName, const IntVec3Type& kernelSize, bool cacheNeighborPairs,
+                                                      const QString& kamName)
+  {
+    FindKernelAvgMisorientations::Pointer findKam = FindKernelAvgMisorientations::New();
+    findKam->connect(findKam.get(), SIGNAL(messageGenerated(const AbstractMessage::Pointer&)), &obs, SLOT(processPipelineMessage(const AbstractMessage::Pointer&)));
+    findKam->setDataContainerArray(dca);
+    findKam->setFeatureIdsArrayPath({dcName, "CellData", "FeatureIds"});
+    findKam->setCellPhasesArrayPath({dcName, "CellData", "Phases"});
+    findKam->setCrystalStructuresArrayPath({dcName, "PhaseData", "CrystalStructures"});
+    findKam->setQuatsArrayPath({dcName, "CellData", "Quats"});
+    findKam->setKernelSize(kernelSize);
+    findKam->setCacheNeighborPairs(cacheNeighborPairs);
+    findKam->setKernelAverageMisorientationsArrayName(kamName);
+    findKam->execute();
+    findKam->messageGenerated(CREATE_FILTER_STATUS(findKam, ++index));
+    int32_t err = findKam->getErrorCode();
+    DREAM3D_REQUIRED(err, ==, 0)
+
+    return dca->getPrereqArrayFromPath<FloatArrayType>(nullptr, {dcName, "CellData", kamName}, {1});
+  }
+
+  // -----------------------------------------------------------------------------
+  void TestKernelAvgMisorientationPairCaching()
+  {
+    Observer obs;
+    int32_t index = 0;
+    DataContainerArray::Pointer dca = importTestData(obs, index);
+
+    std::vector<IntVec3Type> kernelSizes = {IntVec3Type(1, 1, 1), IntVec3Type(3, 2, 0)};
+    for(size_t k = 0; k < kernelSizes.size(); k++)
+    {
+      // Compute the KAM once cell by cell and once with every neighbor pair evaluated a single time
+      FloatArrayType::Pointer perCellKam = runKernelAvgMisorientations(dca, obs, index, "DataContainer", kernelSizes[k], false, QString("KAM_PerCell_%1").arg(k));
+      FloatArrayType::Pointer pairCachedKam = runKernelAvgMisorientations(dca, obs, index, "DataContainer", kernelSizes[k], true, QString("KAM_PairCached_%1").arg(k));
+
+      // Both modes sum the same misorientations in the same order; a shared pair is only measured from one of its cells
+      size_t size = perCellKam->size();
+      for(size_t i = 0; i < size; i++)
+      {
+        DREAM3D_REQUIRE(std::fabs((*perCellKam)[i] - (*pairCachedKam)[i]) < 1.0E-3f)
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  void createTiledKernelTestData(DataContainerArray::Pointer dca, const QString& dcName, const SizeVec3Type& dims)
+  {
+    DataContainer::Pointer dc = DataContainer::New(dcName);
+    dca->addOrReplaceDataContainer(dc);
+    ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+    imageGeom->setDimensions(dims);
+    dc->setGeometry(imageGeom);
+
+    std::vector<size_t> tDims = {dims[0], dims[1], dims[2]};
+    AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+    dc->addOrReplaceAttributeMatrix(cellAttrMat);
+    size_t totalPoints = dims[0] * dims[1] * dims[2];
+    Int32ArrayType::Pointer featureIdsPtr = Int32ArrayType::CreateArray(totalPoints, std::vector<size_t>(1, 1), "FeatureIds", true);
+    Int32ArrayType::Pointer phasesPtr = Int32ArrayType::CreateArray(totalPoints, std::vector<size_t>(1, 1), "Phases", true);
+    FloatArrayType::Pointer quatsPtr = FloatArrayType::CreateArray(totalPoints, std::vector<size_t>(1, 4), "Quats", true);
+    cellAttrMat->addOrReplaceAttributeArray(featureIdsPtr);
+    cellAttrMat->addOrReplaceAttributeArray(phasesPtr);
+    cellAttrMat->addOrReplaceAttributeArray(quatsPtr);
+
+    // Phase 1 is cubic and phase 2 hexagonal, so neighboring cells of one feature can use different symmetries
+    std::vector<size_t> ensembleDims = {3};
+    AttributeMatrix::Pointer ensembleAttrMat = AttributeMatrix::New(ensembleDims, "PhaseData", AttributeMatrix::Type::CellEnsemble);
+    dc->addOrReplaceAttributeMatrix(ensembleAttrMat);
+    UInt32ArrayType::Pointer crystalStructuresPtr = UInt32ArrayType::CreateArray(3, std::vector<size_t>(1, 1), "CrystalStructures", true);
+    (*crystalStructuresPtr)[0] = EbsdLib::CrystalStructure::UnknownCrystalStructure;
+    (*crystalStructuresPtr)[1] = EbsdLib::CrystalStructure::Cubic_High;
+    (*crystalStructuresPtr)[2] = EbsdLib::CrystalStructure::Hexagonal_High;
+    ensembleAttrMat->addOrReplaceAttributeArray(crystalStructuresPtr);
+
+    // Box shaped features with a base orientation each, perturbed by a few degrees per cell. Some cells have no
+    // feature or an unknown phase, and some take the phase of the neighboring feature
+    std::mt19937 generator(5489U);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<std::array<float, 4>> featureQuats;
+    for(size_t z = 0; z < dims[2]; z++)
+    {
+      for(size_t y = 0; y < dims[1]; y++)
+      {
+        for(size_t x = 0; x < dims[0]; x++)
+        {
+          size_t point = (z * dims[1] + y) * dims[0] + x;
+          int32_t featureId = static_cast<int32_t>(1 + x / 7 + 6 * (y / 5) + 30 * (z / 6));
+          if(generator() % 25 == 0)
+          {
+            featureId = 0;
+          }
+          int32_t phase = 1 + (featureId + static_cast<int32_t>(generator() % 9 == 0)) % 2;
+          if(generator() % 20 == 0)
+          {
+            phase = 0;
+          }
+          (*featureIdsPtr)[point] = featureId;
+          (*phasesPtr)[point] = phase;
+
+          while(featureQuats.size() <= static_cast<size_t>(featureId))
+          {
+            featureQuats.push_back({distribution(generator), distribution(generator), distribution(generator), distribution(generator)});
+          }
+          std::array<float, 4> quat = featureQuats[featureId];
+          float norm = 0.0f;
+          for(float& component : quat)
+          {
+            component += 0.02f * distribution(generator);
+            norm += component * component;
+          }
+          norm = std::sqrt(norm);
+          for(size_t c = 0; c < 4; c++)
+          {
+            (*quatsPtr)[point * 4 + c] = quat[c] / norm;
+          }
+        }
+      }
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  void TestKernelAvgMisorientationPairCachingTiled()
+  {
+    Observer obs;
+    int32_t index = 0;
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    // More than one tile in X and Z, so the tile halos and the cross tile pairs are exercised
+    createTiledKernelTestData(dca, "TiledDataContainer", SizeVec3Type(40, 20, 36));
+
+    std::vector<IntVec3Type> kernelSizes = {IntVec3Type(2, 2, 2), IntVec3Type(3, 2, 4)};
+    for(size_t k = 0; k < kernelSizes.size(); k++)
+    {
+      FloatArrayType::Pointer perCellKam = runKernelAvgMisorientations(dca, obs, index, "TiledDataContainer", kernelSizes[k], false, QString("KAM_PerCell_%1").arg(k));
+      FloatArrayType::Pointer pairCachedKam = runKernelAvgMisorientations(dca, obs, index, "TiledDataContainer", kernelSizes[k], true, QString("KAM_PairCached_%1").arg(k));
+
+      // Within a feature the orientations only differ by a few degrees, where the misorientation angle does not depend
+      // on which cell it is measured from, so the two modes have to agree bit for bit
+      size_t size = perCellKam->size();
+      for(size_t i = 0; i < size; i++)
+      {
+        DREAM3D_REQUIRE_EQUAL((*perCellKam)[i], (*pairCachedKam)[i])
+      }
+    }
+  }
+
   // -----------------------------------------------------------------------------
   void operator()()
   {
@@ -191,6 +417,9 @@ public:
     int err = EXIT_SUCCESS;
 
     DREAM3D_REGISTER_TEST(Test());
+    DREAM3D_REGISTER_TEST(TestReferenceOrientationAverages());
+    DREAM3D_REGISTER_TEST(TestKernelAvgMisorientationPairCaching());
+    DREAM3D_REGISTER_TEST(TestKernelAvgMisorientationPairCachingTiled());
 
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
@@ -49,6 +49,7 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 
 #include "Processing/ProcessingConstants.h"
+#include "Processing/ProcessingFilters/HelperClasses/NeighborFrontierFill.h"
 #include "Processing/ProcessingVersion.h"
 
 // -----------------------------------------------------------------------------
@@ -93,7 +94,6 @@ void FillBadData::setupFilterParameters()
 void FillBadData::initialize()
 {
   m_AlreadyChecked = nullptr;
-  m_Neighbors = nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -150,10 +150,6 @@ void FillBadData::execute()
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
   size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
 
-  Int32ArrayType::Pointer neighborsPtr = Int32ArrayType::CreateArray(totalPoints, std::string("_INTERNAL_USE_ONLY_Neighbors"), true);
-  m_Neighbors = neighborsPtr->getPointer(0);
-  neighborsPtr->initializeWithValue(-1);
-
   BoolArrayType::Pointer alreadCheckedPtr = BoolArrayType::CreateArray(totalPoints, std::string("_INTERNAL_USE_ONLY_AlreadyChecked"), true);
   m_AlreadyChecked = alreadCheckedPtr->getPointer(0);
   alreadCheckedPtr->initializeWithZeros();
@@ -170,22 +166,9 @@ void FillBadData::execute()
   int32_t good = 1;
   int64_t neighbor;
   int64_t index = 0;
-  float x = 0.0f, y = 0.0f, z = 0.0f;
   int64_t column = 0, row = 0, plane = 0;
-  int64_t neighpoint = 0;
-  int32_t featurename = 0, feature = 0;
-  size_t numfeatures = 0;
   size_t maxPhase = 0;
 
-  for(size_t i = 0; i < totalPoints; i++)
-  {
-    featurename = m_FeatureIds[i];
-    if(featurename > numfeatures)
-    {
-      numfeatures = featurename;
-    }
-  }
-
   if(m_StoreAsNewPhase)
   {
     for(size_t i = 0; i < totalPoints; i++)
@@ -285,124 +268,17 @@ void FillBadData::execute()
     }
   }
 
-  int32_t current = 0;
-  int32_t most = 0;
-  std::vector<int32_t> n(numfeatures + 1, 0);
-
-  while(count != 0)
+  // Small defects were flagged with -1 above; grow the surrounding Features into them. Feature 0 (kept defects) never votes.
+  AttributeMatrix::Pointer cellAttrMat = m->getAttributeMatrix(m_FeatureIdsArrayPath.getAttributeMatrixName());
+  QList<QString> voxelArrayNames = cellAttrMat->getAttributeArrayNames();
+  std::vector<IDataArray::Pointer> voxelArrays;
+  for(const auto& arrayName : voxelArrayNames)
   {
-    count = 0;
-    for(size_t i = 0; i < totalPoints; i++)
-    {
-      featurename = m_FeatureIds[i];
-      if(featurename < 0)
-      {
-        count++;
-        current = 0;
-        most = 0;
-        x = static_cast<float>(i % dims[0]);
-        y = static_cast<float>((i / dims[0]) % dims[1]);
-        z = static_cast<float>(i / (dims[0] * dims[1]));
-        for(int32_t j = 0; j < 6; j++)
-        {
-          good = 1;
-          neighpoint = static_cast<int64_t>(i + neighpoints[j]);
-          if(j == 0 && z == 0)
-          {
-            good = 0;
-          }
-          if(j == 5 && z == (dims[2] - 1))
-          {
-            good = 0;
-          }
-          if(j == 1 && y == 0)
-          {
-            good = 0;
-          }
-          if(j == 4 && y == (dims[1] - 1))
-          {
-            good = 0;
-          }
-          if(j == 2 && x == 0)
-          {
-            good = 0;
-          }
-          if(j == 3 && x == (dims[0] - 1))
-          {
-            good = 0;
-          }
-          if(good == 1)
-          {
-            feature = m_FeatureIds[neighpoint];
-            if(feature > 0)
-            {
-              n[feature]++;
-              current = n[feature];
-              if(current > most)
-              {
-                most = current;
-                m_Neighbors[i] = neighpoint;
-              }
-            }
-          }
-        }
-        for(int32_t l = 0; l < 6; l++)
-        {
-          good = 1;
-          neighpoint = i + neighpoints[l];
-          if(l == 0 && z == 0)
-          {
-            good = 0;
-          }
-          if(l == 5 && z == (dims[2] - 1))
-          {
-            good = 0;
-          }
-          if(l == 1 && y == 0)
-          {
-            good = 0;
-          }
-          if(l == 4 && y == (dims[1] - 1))
-          {
-            good = 0;
-          }
-          if(l == 2 && x == 0)
-          {
-            good = 0;
-          }
-          if(l == 3 && x == (dims[0] - 1))
-          {
-            good = 0;
-          }
-          if(good == 1)
-          {
-            feature = m_FeatureIds[neighpoint];
-            if(feature > 0)
-            {
-              n[feature] = 0;
-            }
-          }
-        }
-      }
-    }
-
-    QString attrMatName = m_FeatureIdsArrayPath.getAttributeMatrixName();
-    QList<QString> voxelArrayNames = m->getAttributeMatrix(attrMatName)->getAttributeArrayNames();
-
-    for(size_t j = 0; j < totalPoints; j++)
-    {
-      featurename = m_FeatureIds[j];
-      neighbor = m_Neighbors[j];
-      if(featurename < 0 && neighbor != -1 && m_FeatureIds[neighbor] > 0)
-      {
-        for(const auto& arrayName : voxelArrayNames)
-        {
-          IDataArray::Pointer p = m->getAttributeMatrix(attrMatName)->getAttributeArray(arrayName);
-          p->copyTuple(neighbor, j);
-        }
-      }
-    }
+    voxelArrays.push_back(cellAttrMat->getAttributeArray(arrayName));
   }
+
+  NeighborFrontierFill frontierFill(this, m_FeatureIds, udims, 1);
+  frontierFill.execute(voxelArrays);
 }
 
 // -----------------------------------------------------------------------------
@@ -227,7 +227,6 @@ private:
   std::vector<DataArrayPath> m_IgnoredDataArrayPaths = {};
 
   bool* m_AlreadyChecked;
-  int32_t* m_Neighbors;
 
 public:
   FillBadData(const FillBadData&) = delete;            // Copy Constructor Not Implemented
@@ -0,0 +1,250 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, Data, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the following contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "NeighborFrontierFill.h"
+
+#include <algorithm>
+
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
+namespace
+{
+/**
+ * @brief The FindVoteSourcesImpl class picks, for each Cell of the frontier, the face neighbor whose Feature is the
+ * most common among the valid neighbors, or -1 if no neighbor has a valid Feature yet
+ */
+class FindVoteSourcesImpl
+{
+public:
+  FindVoteSourcesImpl(const int32_t* featureIds, const int64_t* dims, int32_t minimumFeatureId, const int64_t* frontier, int64_t* sources)
+  : m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_MinimumFeatureId(minimumFeatureId)
+  , m_Frontier(frontier)
+  , m_Sources(sources)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t neighborOffsets[6] = {-m_Dims[0] * m_Dims[1], -m_Dims[0], -1, 1, m_Dims[0], m_Dims[0] * m_Dims[1]};
+    for(size_t f = start; f < end; f++)
+    {
+      int64_t voxel = m_Frontier[f];
+      int64_t column = voxel % m_Dims[0];
+      int64_t row = (voxel / m_Dims[0]) % m_Dims[1];
+      int64_t plane = voxel / (m_Dims[0] * m_Dims[1]);
+      const bool isValid[6] = {plane > 0, row > 0, column > 0, column < m_Dims[0] - 1, row < m_Dims[1] - 1, plane < m_Dims[2] - 1};
+
+      // Same counting as a per Feature tally: the first neighbor to push its Feature past the current maximum wins
+      int32_t votedFeatures[6] = {0, 0, 0, 0, 0, 0};
+      int32_t numVotes = 0;
+      int32_t most = 0;
+      int64_t source = -1;
+      for(int32_t l = 0; l < 6; l++)
+      {
+        if(!isValid[l])
+        {
+          continue;
+        }
+        int64_t neighbor = voxel + neighborOffsets[l];
+        int32_t feature = m_FeatureIds[neighbor];
+        if(feature < m_MinimumFeatureId)
+        {
+          continue;
+        }
+        int32_t current = 1 + static_cast<int32_t>(std::count(votedFeatures, votedFeatures + numVotes, feature));
+        votedFeatures[numVotes] = feature;
+        numVotes++;
+        if(current > most)
+        {
+          most = current;
+          source = neighbor;
+        }
+      }
+      m_Sources[f] = source;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  const int64_t* m_Dims;
+  int32_t m_MinimumFeatureId;
+  const int64_t* m_Frontier;
+  int64_t* m_Sources;
+};
+
+/**
+ * @brief The CopyVoteSourcesImpl class copies the Cell data of each chosen neighbor into its frontier Cell. Sources
+ * were assigned before the round started, so no Cell is both read and written during a round.
+ */
+class CopyVoteSourcesImpl
+{
+public:
+  CopyVoteSourcesImpl(const std::vector<IDataArray::Pointer>& voxelArrays, int32_t* featureIds, const int64_t* frontier, const int64_t* sources)
+  : m_VoxelArrays(voxelArrays)
+  , m_FeatureIds(featureIds)
+  , m_Frontier(frontier)
+  , m_Sources(sources)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t f = start; f < end; f++)
+    {
+      int64_t source = m_Sources[f];
+      if(source < 0)
+      {
+        continue;
+      }
+      int64_t voxel = m_Frontier[f];
+      for(const auto& voxelArray : m_VoxelArrays)
+      {
+        voxelArray->copyTuple(static_cast<size_t>(source), static_cast<size_t>(voxel));
+      }
+      // The Feature Ids drive the rounds, so they are updated even if they were not among the copied arrays
+      m_FeatureIds[voxel] = m_FeatureIds[source];
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const std::vector<IDataArray::Pointer>& m_VoxelArrays;
+  int32_t* m_FeatureIds;
+  const int64_t* m_Frontier;
+  const int64_t* m_Sources;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+NeighborFrontierFill::NeighborFrontierFill(AbstractFilter* filter, int32_t* featureIds, const SizeVec3Type& dims, int32_t minimumFeatureId)
+: m_Filter(filter)
+, m_FeatureIds(featureIds)
+, m_Dims{static_cast<int64_t>(dims[0]), static_cast<int64_t>(dims[1]), static_cast<int64_t>(dims[2])}
+, m_MinimumFeatureId(minimumFeatureId)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+NeighborFrontierFill::~NeighborFrontierFill() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t NeighborFrontierFill::execute(const std::vector<IDataArray::Pointer>& voxelArrays)
+{
+  const int64_t totalPoints = m_Dims[0] * m_Dims[1] * m_Dims[2];
+
+  // The first round has to look at every unassigned Cell, later rounds only at the ones next to newly assigned Cells
+  std::vector<int64_t> frontier;
+  for(int64_t voxel = 0; voxel < totalPoints; voxel++)
+  {
+    if(m_FeatureIds[voxel] < 0)
+    {
+      frontier.push_back(voxel);
+    }
+  }
+
+  std::vector<int64_t> sources;
+  std::vector<int64_t> nextFrontier;
+  while(!frontier.empty())
+  {
+    if(m_Filter != nullptr && m_Filter->getCancel())
+    {
+      break;
+    }
+
+    sources.assign(frontier.size(), -1);
+    {
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(0ULL, frontier.size());
+      dataAlg.execute(FindVoteSourcesImpl(m_FeatureIds, m_Dims, m_MinimumFeatureId, frontier.data(), sources.data()));
+    }
+    {
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(0ULL, frontier.size());
+      dataAlg.execute(CopyVoteSourcesImpl(voxelArrays, m_FeatureIds, frontier.data(), sources.data()));
+    }
+
+    gatherNextFrontier(frontier, sources, nextFrontier);
+    frontier.swap(nextFrontier);
+  }
+
+  return static_cast<size_t>(std::count_if(m_FeatureIds, m_FeatureIds + totalPoints, [](int32_t featureId) { return featureId < 0; }));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void NeighborFrontierFill::gatherNextFrontier(const std::vector<int64_t>& frontier, const std::vector<int64_t>& sources, std::vector<int64_t>& nextFrontier) const
+{
+  const int64_t neighborOffsets[6] = {-m_Dims[0] * m_Dims[1], -m_Dims[0], -1, 1, m_Dims[0], m_Dims[0] * m_Dims[1]};
+  nextFrontier.clear();
+  for(size_t f = 0; f < frontier.size(); f++)
+  {
+    if(sources[f] < 0)
+    {
+      continue;
+    }
+    int64_t voxel = frontier[f];
+    int64_t column = voxel % m_Dims[0];
+    int64_t row = (voxel / m_Dims[0]) % m_Dims[1];
+    int64_t plane = voxel / (m_Dims[0] * m_Dims[1]);
+    const bool isValid[6] = {plane > 0, row > 0, column > 0, column < m_Dims[0] - 1, row < m_Dims[1] - 1, plane < m_Dims[2] - 1};
+    for(int32_t l = 0; l < 6; l++)
+    {
+      if(isValid[l] && m_FeatureIds[voxel + neighborOffsets[l]] < 0)
+      {
+        nextFrontier.push_back(voxel + neighborOffsets[l]);
+      }
+    }
+  }
+  std::sort(nextFrontier.begin(), nextFrontier.end());
+  nextFrontier.erase(std::unique(nextFrontier.begin(), nextFrontier.end()), nextFrontier.end());
+}
@@ -0,0 +1,88 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, Data, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the following contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataArrays/IDataArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The NeighborFrontierFill class assigns every Cell with a negative Feature Id the data of the face neighbor
+ * that belongs to the most common Feature around it, one round at a time, until no unassigned Cell touches an
+ * assigned one. Ties go to the first neighbor reaching the highest count in the order -Z, -Y, -X, +X, +Y, +Z. Each
+ * round only visits the unassigned Cells next to the Cells assigned in the previous round, and the votes and copies
+ * of a round are done in parallel. A round only reads Cells that were assigned before it started, so the result is
+ * the same as repeatedly sweeping the whole volume.
+ */
+class NeighborFrontierFill
+{
+public:
+  /**
+   * @param filter Filter used to check for cancellation
+   * @param featureIds Feature Ids of the Cells
+   * @param dims Dimensions of the Image Geometry
+   * @param minimumFeatureId Smallest Feature Id that a neighbor can pass on
+   */
+  NeighborFrontierFill(AbstractFilter* filter, int32_t* featureIds, const SizeVec3Type& dims, int32_t minimumFeatureId);
+  virtual ~NeighborFrontierFill();
+
+  /**
+   * @brief execute Runs rounds until the frontier is empty or the filter is canceled
+   * @param voxelArrays Cell arrays copied from the chosen neighbor. This should include the Feature Ids array.
+   * @return Number of Cells that were left with a negative Feature Id
+   */
+  size_t execute(const std::vector<IDataArray::Pointer>& voxelArrays);
+
+private:
+  AbstractFilter* m_Filter = nullptr;
+  int32_t* m_FeatureIds = nullptr;
+  int64_t m_Dims[3] = {0, 0, 0};
+  int32_t m_MinimumFeatureId = 0;
+
+  /**
+   * @brief gatherNextFrontier Collects the unassigned face neighbors of the Cells assigned in the last round
+   */
+  void gatherNextFrontier(const std::vector<int64_t>& frontier, const std::vector<int64_t>& sources, std::vector<int64_t>& nextFrontier) const;
+
+public:
+  NeighborFrontierFill(const NeighborFrontierFill&) = delete;            // Copy Constructor Not Implemented
+  NeighborFrontierFill(NeighborFrontierFill&&) = delete;                 // Move Constructor Not Implemented
+  NeighborFrontierFill& operator=(const NeighborFrontierFill&) = delete; // Copy Assignment Not Implemented
+  NeighborFrontierFill& operator=(NeighborFrontierFill&&) = delete;      // Move Assignment Not Implemented
+};
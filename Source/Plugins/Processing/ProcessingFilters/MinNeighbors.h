@@ -271,8 +271,6 @@ private:
   DataArrayPath m_NumNeighborsArrayPath = {SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::NumNeighbors};
   std::vector<DataArrayPath> m_IgnoredDataArrayPaths = {};
 
-  int32_t* m_Neighbors = nullptr;
-
 public:
   MinNeighbors(const MinNeighbors&) = delete;            // Copy Constructor Not Implemented
   MinNeighbors(MinNeighbors&&) = delete;                 // Move Constructor Not Implemented
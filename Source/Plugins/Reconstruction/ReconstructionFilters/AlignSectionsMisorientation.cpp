@@ -35,7 +35,9 @@
 
 #include "AlignSectionsMisorientation.h"
 
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 #include <QtCore/QDateTime>
 #include <QtCore/QTextStream>
@@ -50,6 +52,7 @@
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "EbsdLib/Core/Quaternion.hpp"
 #include "EbsdLib/LaueOps/LaueOps.h"
@@ -57,6 +60,212 @@
 #include "Reconstruction/ReconstructionConstants.h"
 #include "Reconstruction/ReconstructionVersion.h"
 
+namespace
+{
+/**
+ * @brief The MisorientationShiftInputs struct holds the cell data that the shift search reads
+ */
+struct MisorientationShiftInputs
+{
+  const float* quats = nullptr;
+  const int32_t* cellPhases = nullptr;
+  const bool* goodVoxels = nullptr;
+  const uint32_t* crystalStructures = nullptr;
+  bool useGoodVoxels = false;
+  float misorientationTolerance = 0.0f;
+  int64_t dims[3] = {0, 0, 0};
+};
+
+/**
+ * @brief calculateShiftDisorientation Returns the fraction of sampled points that are misoriented (or
+ * do not match in good voxel state) when section slice is shifted by (xshift, yshift) against section slice + 1
+ */
+float calculateShiftDisorientation(const MisorientationShiftInputs& inputs, const std::vector<LaueOps::Pointer>& orientationOps, int64_t slice, int64_t xshift, int64_t yshift)
+{
+  const int64_t* dims = inputs.dims;
+  float disorientation = 0.0f;
+  float count = 0.0f;
+  for(int64_t l = 0; l < dims[1]; l = l + 4)
+  {
+    for(int64_t n = 0; n < dims[0]; n = n + 4)
+    {
+      if((l + yshift) >= 0 && (l + yshift) < dims[1] && (n + xshift) >= 0 && (n + xshift) < dims[0])
+      {
+        count++;
+        int64_t refposition = ((slice + 1) * dims[0] * dims[1]) + (l * dims[0]) + n;
+        int64_t curposition = (slice * dims[0] * dims[1]) + ((l + yshift) * dims[0]) + (n + xshift);
+        if(!inputs.useGoodVoxels || (inputs.goodVoxels[refposition] && inputs.goodVoxels[curposition]))
+        {
+          float w = std::numeric_limits<float>::max();
+          if(inputs.cellPhases[refposition] > 0 && inputs.cellPhases[curposition] > 0)
+          {
+            const float* currentQuatPtr = inputs.quats + refposition * 4;
+            QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+            uint32_t phase1 = inputs.crystalStructures[inputs.cellPhases[refposition]];
+            currentQuatPtr = inputs.quats + curposition * 4;
+            QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+            uint32_t phase2 = inputs.crystalStructures[inputs.cellPhases[curposition]];
+            if(phase1 == phase2 && phase1 < static_cast<uint32_t>(orientationOps.size()))
+            {
+              OrientationF axisAngle = orientationOps[phase1]->calculateMisorientation(q1, q2);
+              w = axisAngle[3];
+            }
+          }
+          if(w > inputs.misorientationTolerance)
+          {
+            disorientation++;
+          }
+        }
+        if(inputs.useGoodVoxels)
+        {
+          if(inputs.goodVoxels[refposition] && !inputs.goodVoxels[curposition])
+          {
+            disorientation++;
+          }
+          if(!inputs.goodVoxels[refposition] && inputs.goodVoxels[curposition])
+          {
+            disorientation++;
+          }
+        }
+      }
+    }
+  }
+  return disorientation / count;
+}
+
+/**
+ * @brief The EvaluateShiftCandidatesImpl class evaluates the candidate shifts of one round of the
+ * search for a single pair of sections
+ */
+class EvaluateShiftCandidatesImpl
+{
+public:
+  EvaluateShiftCandidatesImpl(const MisorientationShiftInputs& inputs, int64_t slice, const std::vector<int64_t>& xshifts, const std::vector<int64_t>& yshifts, std::vector<float>& disorientations)
+  : m_Inputs(inputs)
+  , m_Slice(slice)
+  , m_XShifts(xshifts)
+  , m_YShifts(yshifts)
+  , m_Disorientations(disorientations)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    std::vector<LaueOps::Pointer> orientationOps = LaueOps::GetAllOrientationOps();
+    for(size_t i = start; i < end; i++)
+    {
+      m_Disorientations[i] = calculateShiftDisorientation(m_Inputs, orientationOps, m_Slice, m_XShifts[i], m_YShifts[i]);
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const MisorientationShiftInputs& m_Inputs;
+  int64_t m_Slice = 0;
+  const std::vector<int64_t>& m_XShifts;
+  const std::vector<int64_t>& m_YShifts;
+  std::vector<float>& m_Disorientations;
+};
+
+/**
+ * @brief The FindSectionShiftsImpl class runs the greedy shift search for a range of section pairs.
+ * The shift between two sections does not depend on any other pair, so pairs are searched concurrently
+ * and the candidates of each round are evaluated concurrently as well. The candidates are compared in
+ * the same order as the serial search, so ties resolve identically.
+ */
+class FindSectionShiftsImpl
+{
+public:
+  FindSectionShiftsImpl(const MisorientationShiftInputs& inputs, std::vector<int64_t>& newxshifts, std::vector<int64_t>& newyshifts)
+  : m_Inputs(inputs)
+  , m_NewXShifts(newxshifts)
+  , m_NewYShifts(newyshifts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t* dims = m_Inputs.dims;
+    const int64_t halfDim0 = static_cast<int64_t>(dims[0] * 0.5f);
+    const int64_t halfDim1 = static_cast<int64_t>(dims[1] * 0.5f);
+
+    std::vector<uint8_t> misorients(static_cast<size_t>(dims[0] * dims[1]), 0);
+    std::vector<int64_t> candidateXShifts;
+    std::vector<int64_t> candidateYShifts;
+    std::vector<float> disorientations;
+    candidateXShifts.reserve(49);
+    candidateYShifts.reserve(49);
+
+    for(size_t iter = start; iter < end; iter++)
+    {
+      float mindisorientation = std::numeric_limits<float>::max();
+      int64_t slice = (dims[2] - 1) - static_cast<int64_t>(iter);
+      int64_t oldxshift = -1;
+      int64_t oldyshift = -1;
+      int64_t newxshift = 0;
+      int64_t newyshift = 0;
+
+      std::fill(misorients.begin(), misorients.end(), 0);
+
+      while(newxshift != oldxshift || newyshift != oldyshift)
+      {
+        oldxshift = newxshift;
+        oldyshift = newyshift;
+        candidateXShifts.clear();
+        candidateYShifts.clear();
+        for(int32_t j = -3; j < 4; j++)
+        {
+          for(int32_t k = -3; k < 4; k++)
+          {
+            int64_t idx = (dims[0] * (j + oldyshift + halfDim1)) + (k + oldxshift + halfDim0);
+            if(llabs(k + oldxshift) < halfDim0 && llabs(j + oldyshift) < halfDim1 && misorients[idx] == 0)
+            {
+              candidateXShifts.push_back(k + oldxshift);
+              candidateYShifts.push_back(j + oldyshift);
+            }
+          }
+        }
+
+        disorientations.resize(candidateXShifts.size());
+        ParallelDataAlgorithm dataAlg;
+        dataAlg.setRange(0ULL, static_cast<size_t>(candidateXShifts.size()));
+        dataAlg.execute(EvaluateShiftCandidatesImpl(m_Inputs, slice, candidateXShifts, candidateYShifts, disorientations));
+
+        for(size_t c = 0; c < candidateXShifts.size(); c++)
+        {
+          int64_t xshift = candidateXShifts[c];
+          int64_t yshift = candidateYShifts[c];
+          float disorientation = disorientations[c];
+          misorients[(dims[0] * (yshift + halfDim1)) + (xshift + halfDim0)] = 1;
+          if(disorientation < mindisorientation || (disorientation == mindisorientation && ((llabs(xshift) < llabs(newxshift)) || (llabs(yshift) < llabs(newyshift)))))
+          {
+            newxshift = xshift;
+            newyshift = yshift;
+            mindisorientation = disorientation;
+          }
+        }
+      }
+      m_NewXShifts[iter] = newxshift;
+      m_NewYShifts[iter] = newyshift;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const MisorientationShiftInputs& m_Inputs;
+  std::vector<int64_t>& m_NewXShifts;
+  std::vector<int64_t>& m_NewYShifts;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -216,148 +425,50 @@ void AlignSectionsMisorientation::find_shifts(std::vector<int64_t>& xshifts, std
 
   SizeVec3Type udims = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-  int64_t dims[3] = {
-      static_cast<int64_t>(udims[0]),
-      static_cast<int64_t>(udims[1]),
-      static_cast<int64_t>(udims[2]),
-  };
-
-  std::vector<LaueOps::Pointer> m_OrientationOps = LaueOps::GetAllOrientationOps();
-
-  float disorientation = 0.0f;
-  float mindisorientation = std::numeric_limits<float>::max();
-  int64_t newxshift = 0;
-  int64_t newyshift = 0;
-  int64_t oldxshift = 0;
-  int64_t oldyshift = 0;
-  float count = 0.0f;
-  int64_t slice = 0;
-  float w = 0.0f;
-
-  int64_t refposition = 0;
-  int64_t curposition = 0;
-
-  uint32_t phase1 = 0, phase2 = 0;
-  int64_t progInt = 0;
-
-  // Allocate a 2D Array which will be reused from slice to slice
-  BoolArrayType::Pointer misorientsPtr = BoolArrayType::CreateArray(dims[0] * dims[1], std::string("_INTERNAL_USE_ONLY_Misorients"), true);
-  misorientsPtr->initializeWithValue(false);
-  bool* misorients = misorientsPtr->getPointer(0); // Get the raw pointer to use in our calculations for speed.
-
-  int64_t idx = 0; // This will be used to compute the index into the flat array
-  int64_t xIdx = 0;
-  int64_t yIdx = 0;
-
-  const int64_t halfDim0 = static_cast<int64_t>(dims[0] * 0.5f);
-  const int64_t halfDim1 = static_cast<int64_t>(dims[1] * 0.5f);
-
-  // Loop over the Z Direction
-  for(int64_t iter = 1; iter < dims[2]; iter++)
+  MisorientationShiftInputs inputs;
+  inputs.quats = m_Quats;
+  inputs.cellPhases = m_CellPhases;
+  inputs.goodVoxels = m_GoodVoxels;
+  inputs.crystalStructures = m_CrystalStructures;
+  inputs.useGoodVoxels = m_UseGoodVoxels;
+  inputs.misorientationTolerance = m_MisorientationTolerance * SIMPLib::Constants::k_PiOver180D;
+  inputs.dims[0] = static_cast<int64_t>(udims[0]);
+  inputs.dims[1] = static_cast<int64_t>(udims[1]);
+  inputs.dims[2] = static_cast<int64_t>(udims[2]);
+  const int64_t* dims = inputs.dims;
+
+  // Shifts between each pair of sections, relative to the section above
+  std::vector<int64_t> newxshifts(static_cast<size_t>(dims[2]), 0);
+  std::vector<int64_t> newyshifts(static_cast<size_t>(dims[2]), 0);
+
+  // Search the section pairs in batches so progress and cancel requests are still handled regularly
+  int64_t batchSize = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  batchSize = std::max(static_cast<int64_t>(std::thread::hardware_concurrency()) * 2, static_cast<int64_t>(1));
+#endif
+  for(int64_t iter = 1; iter < dims[2]; iter += batchSize)
   {
-    progInt = ((float)iter / dims[2]) * 100.0f;
+    int64_t progInt = ((float)iter / dims[2]) * 100.0f;
     QString ss = QObject::tr("Aligning Sections || Determining Shifts || %1% Complete").arg(progInt);
     notifyStatusMessage(ss);
     if(getCancel())
     {
       return;
     }
-    mindisorientation = std::numeric_limits<float>::max();
-    slice = (dims[2] - 1) - iter;
-    oldxshift = -1;
-    oldyshift = -1;
-    newxshift = 0;
-    newyshift = 0;
-
-    misorientsPtr->initializeWithValue(false); // Initialize everything to false
 
-    float misorientationTolerance = m_MisorientationTolerance * SIMPLib::Constants::k_PiOver180D;
-    float* currentQuatPtr = nullptr;
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(static_cast<size_t>(iter), static_cast<size_t>(std::min(iter + batchSize, dims[2])));
+    dataAlg.execute(FindSectionShiftsImpl(inputs, newxshifts, newyshifts));
+  }
 
-    while(newxshift != oldxshift || newyshift != oldyshift)
-    {
-      oldxshift = newxshift;
-      oldyshift = newyshift;
-      for(int32_t j = -3; j < 4; j++)
-      {
-        for(int32_t k = -3; k < 4; k++)
-        {
-          disorientation = 0.0f;
-          count = 0.0f;
-          xIdx = k + oldxshift + halfDim0;
-          yIdx = j + oldyshift + halfDim1;
-          idx = (dims[0] * yIdx) + xIdx;
-          if(!misorients[idx] && llabs(k + oldxshift) < halfDim0 && llabs(j + oldyshift) < halfDim1)
-          {
-            for(int64_t l = 0; l < dims[1]; l = l + 4)
-            {
-              for(int64_t n = 0; n < dims[0]; n = n + 4)
-              {
-                if((l + j + oldyshift) >= 0 && (l + j + oldyshift) < dims[1] && (n + k + oldxshift) >= 0 && (n + k + oldxshift) < dims[0])
-                {
-                  count++;
-                  refposition = ((slice + 1) * dims[0] * dims[1]) + (l * dims[0]) + n;
-                  curposition = (slice * dims[0] * dims[1]) + ((l + j + oldyshift) * dims[0]) + (n + k + oldxshift);
-                  if(!m_UseGoodVoxels || (m_GoodVoxels[refposition] && m_GoodVoxels[curposition]))
-                  {
-                    w = std::numeric_limits<float>::max();
-                    if(m_CellPhases[refposition] > 0 && m_CellPhases[curposition] > 0)
-                    {
-
-                      currentQuatPtr = m_Quats + refposition * 4;
-                      QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-                      phase1 = m_CrystalStructures[m_CellPhases[refposition]];
-                      currentQuatPtr = m_Quats + curposition * 4;
-                      QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-                      phase2 = m_CrystalStructures[m_CellPhases[curposition]];
-                      if(phase1 == phase2 && phase1 < static_cast<uint32_t>(m_OrientationOps.size()))
-                      {
-                        OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
-                        w = axisAngle[3];
-                      }
-                    }
-                    if(w > misorientationTolerance)
-                    {
-                      disorientation++;
-                    }
-                  }
-                  if(m_UseGoodVoxels)
-                  {
-                    if(m_GoodVoxels[refposition] && !m_GoodVoxels[curposition])
-                    {
-                      disorientation++;
-                    }
-                    if(!m_GoodVoxels[refposition] && m_GoodVoxels[curposition])
-                    {
-                      disorientation++;
-                    }
-                  }
-                }
-                else
-                {
-                }
-              }
-            }
-            disorientation = disorientation / count;
-            xIdx = k + oldxshift + halfDim0;
-            yIdx = j + oldyshift + halfDim1;
-            idx = (dims[0] * yIdx) + xIdx;
-            misorients[idx] = true;
-            if(disorientation < mindisorientation || (disorientation == mindisorientation && ((llabs(k + oldxshift) < llabs(newxshift)) || (llabs(j + oldyshift) < llabs(newyshift)))))
-            {
-              newxshift = k + oldxshift;
-              newyshift = j + oldyshift;
-              mindisorientation = disorientation;
-            }
-          }
-        }
-      }
-    }
-    xshifts[iter] = xshifts[iter - 1] + newxshift;
-    yshifts[iter] = yshifts[iter - 1] + newyshift;
+  for(int64_t iter = 1; iter < dims[2]; iter++)
+  {
+    int64_t slice = (dims[2] - 1) - iter;
+    xshifts[iter] = xshifts[iter - 1] + newxshifts[iter];
+    yshifts[iter] = yshifts[iter - 1] + newyshifts[iter];
     if(getWriteAlignmentShifts())
     {
-      outFile << slice << "	" << slice + 1 << "	" << newxshift << "	" << newyshift << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
+      outFile << slice << "	" << slice + 1 << "	" << newxshifts[iter] << "	" << newyshifts[iter] << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
     }
   }
   if(getWriteAlignmentShifts())
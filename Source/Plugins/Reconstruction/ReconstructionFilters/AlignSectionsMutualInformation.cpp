@@ -34,7 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "AlignSectionsMutualInformation.h"
 
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 #include <QtCore/QTextStream>
 
@@ -49,12 +51,208 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
 #include "SIMPLib/Math/SIMPLibRandom.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "EbsdLib/LaueOps/LaueOps.h"
 
 #include "Reconstruction/ReconstructionConstants.h"
 #include "Reconstruction/ReconstructionVersion.h"
 
+namespace
+{
+/**
+ * @brief The MutualInformationBuffers struct holds the joint and marginal Feature histograms used to
+ * evaluate one candidate shift. They are all zero between evaluations
+ */
+struct MutualInformationBuffers
+{
+  std::vector<float> mutualinfo12;
+  std::vector<float> mutualinfo1;
+  std::vector<float> mutualinfo2;
+};
+
+/**
+ * @brief calculateShiftMutualInformation Returns the inverse of the mutual information between the section
+ * Feature Ids of section slice shifted by (xshift, yshift) and section slice + 1
+ */
+float calculateShiftMutualInformation(const int32_t* miFeatureIds, const int64_t* dims, int64_t slice, int32_t featurecount1, int32_t featurecount2, int64_t xshift, int64_t yshift,
+                                      MutualInformationBuffers& buffers)
+{
+  float* mutualinfo12 = buffers.mutualinfo12.data();
+  float* mutualinfo1 = buffers.mutualinfo1.data();
+  float* mutualinfo2 = buffers.mutualinfo2.data();
+  float disorientation = 0.0f;
+  float count = 0.0f;
+  for(int64_t l = 0; l < dims[1]; l = l + 4)
+  {
+    for(int64_t n = 0; n < dims[0]; n = n + 4)
+    {
+      if((l + yshift) >= 0 && (l + yshift) < dims[1] && (n + xshift) >= 0 && (n + xshift) < dims[0])
+      {
+        int64_t refposition = ((slice + 1) * dims[0] * dims[1]) + (l * dims[0]) + n;
+        int64_t curposition = (slice * dims[0] * dims[1]) + ((l + yshift) * dims[0]) + (n + xshift);
+        int32_t refgnum = miFeatureIds[refposition];
+        int32_t curgnum = miFeatureIds[curposition];
+        if(curgnum >= 0 && refgnum >= 0)
+        {
+          mutualinfo12[curgnum * featurecount2 + refgnum]++;
+          mutualinfo1[curgnum]++;
+          mutualinfo2[refgnum]++;
+          count++;
+        }
+      }
+      else
+      {
+        mutualinfo12[0]++;
+        mutualinfo1[0]++;
+        mutualinfo2[0]++;
+      }
+    }
+  }
+  float ha = 0.0f;
+  float hb = 0.0f;
+  float hab = 0.0f;
+  for(int32_t b = 0; b < featurecount1; b++)
+  {
+    mutualinfo1[b] = mutualinfo1[b] / count;
+    if(mutualinfo1[b] != 0)
+    {
+      ha = ha + mutualinfo1[b] * logf(mutualinfo1[b]);
+    }
+  }
+  for(int32_t c = 0; c < featurecount2; c++)
+  {
+    mutualinfo2[c] = mutualinfo2[c] / float(count);
+    if(mutualinfo2[c] != 0)
+    {
+      hb = hb + mutualinfo2[c] * logf(mutualinfo2[c]);
+    }
+  }
+  for(int32_t b = 0; b < featurecount1; b++)
+  {
+    for(int32_t c = 0; c < featurecount2; c++)
+    {
+      float& joint = mutualinfo12[b * featurecount2 + c];
+      joint = joint / count;
+      if(joint != 0)
+      {
+        hab = hab + joint * logf(joint);
+      }
+      float value = 0.0f;
+      if(mutualinfo1[b] > 0 && mutualinfo2[c] > 0)
+      {
+        value = (joint / (mutualinfo1[b] * mutualinfo2[c]));
+      }
+      if(value != 0)
+      {
+        disorientation = disorientation + (joint * logf(value));
+      }
+    }
+  }
+  std::fill(buffers.mutualinfo12.begin(), buffers.mutualinfo12.end(), 0.0f);
+  std::fill(buffers.mutualinfo1.begin(), buffers.mutualinfo1.end(), 0.0f);
+  std::fill(buffers.mutualinfo2.begin(), buffers.mutualinfo2.end(), 0.0f);
+  return 1.0f / disorientation;
+}
+
+/**
+ * @brief The FindSectionShiftsImpl class runs the greedy shift search for a range of section pairs.
+ * The shift between two sections does not depend on any other pair, so pairs are searched concurrently.
+ * The candidates of each round are evaluated serially within a pair so that each thread holds a single
+ * set of histograms, which keeps peak memory at one featurecount1 x featurecount2 table per thread.
+ */
+class FindSectionShiftsImpl
+{
+public:
+  FindSectionShiftsImpl(const int32_t* miFeatureIds, const int32_t* featurecounts, const int64_t* dims, std::vector<int64_t>& newxshifts, std::vector<int64_t>& newyshifts)
+  : m_MIFeatureIds(miFeatureIds)
+  , m_FeatureCounts(featurecounts)
+  , m_Dims(dims)
+  , m_NewXShifts(newxshifts)
+  , m_NewYShifts(newyshifts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t* dims = m_Dims;
+    const int64_t halfDim0 = dims[0] / 2;
+    const int64_t halfDim1 = dims[1] / 2;
+
+    std::vector<float> misorients(static_cast<size_t>(dims[0] * dims[1]), 0.0f);
+    std::vector<int64_t> candidateXShifts;
+    std::vector<int64_t> candidateYShifts;
+    MutualInformationBuffers buffers;
+    candidateXShifts.reserve(49);
+    candidateYShifts.reserve(49);
+
+    for(size_t iter = start; iter < end; iter++)
+    {
+      float mindisorientation = std::numeric_limits<float>::max();
+      int64_t slice = (dims[2] - 1) - static_cast<int64_t>(iter);
+      int32_t featurecount1 = m_FeatureCounts[slice];
+      int32_t featurecount2 = m_FeatureCounts[slice + 1];
+      int64_t oldxshift = -1;
+      int64_t oldyshift = -1;
+      int64_t newxshift = 0;
+      int64_t newyshift = 0;
+
+      std::fill(misorients.begin(), misorients.end(), 0.0f);
+      buffers.mutualinfo12.assign(static_cast<size_t>(featurecount1) * static_cast<size_t>(featurecount2), 0.0f);
+      buffers.mutualinfo1.assign(static_cast<size_t>(featurecount1), 0.0f);
+      buffers.mutualinfo2.assign(static_cast<size_t>(featurecount2), 0.0f);
+
+      while(newxshift != oldxshift || newyshift != oldyshift)
+      {
+        oldxshift = newxshift;
+        oldyshift = newyshift;
+        candidateXShifts.clear();
+        candidateYShifts.clear();
+        for(int32_t j = -3; j < 4; j++)
+        {
+          for(int32_t k = -3; k < 4; k++)
+          {
+            if(llabs(k + oldxshift) < halfDim0 && llabs(j + oldyshift) < halfDim1 && misorients[(k + oldxshift + halfDim0) * dims[1] + (j + oldyshift + halfDim1)] == 0)
+            {
+              candidateXShifts.push_back(k + oldxshift);
+              candidateYShifts.push_back(j + oldyshift);
+            }
+          }
+        }
+
+        for(size_t c = 0; c < candidateXShifts.size(); c++)
+        {
+          int64_t xshift = candidateXShifts[c];
+          int64_t yshift = candidateYShifts[c];
+          float disorientation = calculateShiftMutualInformation(m_MIFeatureIds, dims, slice, featurecount1, featurecount2, xshift, yshift, buffers);
+          misorients[(xshift + halfDim0) * dims[1] + (yshift + halfDim1)] = disorientation;
+          if(disorientation < mindisorientation)
+          {
+            newxshift = xshift;
+            newyshift = yshift;
+            mindisorientation = disorientation;
+          }
+        }
+      }
+      m_NewXShifts[iter] = newxshift;
+      m_NewYShifts[iter] = newyshift;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_MIFeatureIds = nullptr;
+  const int32_t* m_FeatureCounts = nullptr;
+  const int64_t* m_Dims = nullptr;
+  std::vector<int64_t>& m_NewXShifts;
+  std::vector<int64_t>& m_NewYShifts;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -230,180 +428,41 @@ void AlignSectionsMutualInformation::find_shifts(std::vector<int64_t>& xshifts,
       static_cast<int64_t>(udims[2]),
   };
 
-  float disorientation = 0.0f;
-  float mindisorientation = std::numeric_limits<float>::max();
-  float** mutualinfo12 = nullptr;
-  float* mutualinfo1 = nullptr;
-  float* mutualinfo2 = nullptr;
-  int32_t featurecount1 = 0, featurecount2 = 0;
-  int64_t newxshift = 0;
-  int64_t newyshift = 0;
-  int64_t oldxshift = 0;
-  int64_t oldyshift = 0;
-  float count = 0.0f;
-  int64_t slice = 0;
-
-  int32_t refgnum = 0, curgnum = 0;
-  int64_t refposition = 0;
-  int64_t curposition = 0;
-
   form_features_sections();
 
-  std::vector<std::vector<float>> misorients;
-  misorients.resize(dims[0]);
-  for(int64_t a = 0; a < dims[0]; a++)
-  {
-    misorients[a].assign(dims[1], 0.0f);
-  }
+  // Shifts between each pair of sections, relative to the section above
+  std::vector<int64_t> newxshifts(static_cast<size_t>(dims[2]), 0);
+  std::vector<int64_t> newyshifts(static_cast<size_t>(dims[2]), 0);
 
-  for(int64_t iter = 1; iter < dims[2]; iter++)
+  // Search the section pairs in batches so progress and cancel requests are still handled regularly
+  int64_t batchSize = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  batchSize = std::max(static_cast<int64_t>(std::thread::hardware_concurrency()) * 2, static_cast<int64_t>(1));
+#endif
+  for(int64_t iter = 1; iter < dims[2]; iter += batchSize)
   {
     float prog = ((float)iter / dims[2]) * 100;
     QString ss = QObject::tr("Aligning Sections || Determining Shifts || %1% Complete").arg(QString::number(prog, 'f', 0));
     notifyStatusMessage(ss);
-    mindisorientation = std::numeric_limits<float>::max();
-    slice = (dims[2] - 1) - iter;
-    featurecount1 = featurecounts[slice];
-    featurecount2 = featurecounts[slice + 1];
-    mutualinfo12 = new float*[featurecount1];
-    mutualinfo1 = new float[featurecount1];
-    mutualinfo2 = new float[featurecount2];
-
-    for(int32_t a = 0; a < featurecount1; a++)
-    {
-      mutualinfo1[a] = 0.0f;
-      mutualinfo12[a] = new float[featurecount2];
-      for(int32_t b = 0; b < featurecount2; b++)
-      {
-        mutualinfo12[a][b] = 0.0f;
-        mutualinfo2[b] = 0.0f;
-      }
-    }
-    oldxshift = -1;
-    oldyshift = -1;
-    newxshift = 0;
-    newyshift = 0;
-    for(int64_t a = 0; a < dims[0]; a++)
+    if(getCancel())
     {
-      for(int64_t b = 0; b < dims[1]; b++)
-      {
-        misorients[a][b] = 0;
-      }
-    }
-    while(newxshift != oldxshift || newyshift != oldyshift)
-    {
-      oldxshift = newxshift;
-      oldyshift = newyshift;
-      for(int32_t j = -3; j < 4; j++)
-      {
-        for(int32_t k = -3; k < 4; k++)
-        {
-          disorientation = 0;
-          count = 0;
-          if(misorients[k + oldxshift + dims[0] / 2][j + oldyshift + dims[1] / 2] == 0 && llabs(k + oldxshift) < (dims[0] / 2) && (j + oldyshift) < (dims[1] / 2))
-          {
-            for(int64_t l = 0; l < dims[1]; l = l + 4)
-            {
-              for(int64_t n = 0; n < dims[0]; n = n + 4)
-              {
-                if((l + j + oldyshift) >= 0 && (l + j + oldyshift) < dims[1] && (n + k + oldxshift) >= 0 && (n + k + oldxshift) < dims[0])
-                {
-                  refposition = ((slice + 1) * dims[0] * dims[1]) + (l * dims[0]) + n;
-                  curposition = (slice * dims[0] * dims[1]) + ((l + j + oldyshift) * dims[0]) + (n + k + oldxshift);
-                  refgnum = miFeatureIds[refposition];
-                  curgnum = miFeatureIds[curposition];
-                  if(curgnum >= 0 && refgnum >= 0)
-                  {
-                    mutualinfo12[curgnum][refgnum]++;
-                    mutualinfo1[curgnum]++;
-                    mutualinfo2[refgnum]++;
-                    count++;
-                  }
-                }
-                else
-                {
-                  mutualinfo12[0][0]++;
-                  mutualinfo1[0]++;
-                  mutualinfo2[0]++;
-                }
-              }
-            }
-            float ha = 0.0f;
-            float hb = 0.0f;
-            float hab = 0.0f;
-            for(int32_t b = 0; b < featurecount1; b++)
-            {
-              mutualinfo1[b] = mutualinfo1[b] / count;
-              if(mutualinfo1[b] != 0)
-              {
-                ha = ha + mutualinfo1[b] * logf(mutualinfo1[b]);
-              }
-            }
-            for(int32_t c = 0; c < featurecount2; c++)
-            {
-              mutualinfo2[c] = mutualinfo2[c] / float(count);
-              if(mutualinfo2[c] != 0)
-              {
-                hb = hb + mutualinfo2[c] * logf(mutualinfo2[c]);
-              }
-            }
-            for(int32_t b = 0; b < featurecount1; b++)
-            {
-              for(int32_t c = 0; c < featurecount2; c++)
-              {
-                mutualinfo12[b][c] = mutualinfo12[b][c] / count;
-                if(mutualinfo12[b][c] != 0)
-                {
-                  hab = hab + mutualinfo12[b][c] * logf(mutualinfo12[b][c]);
-                }
-                float value = 0.0f;
-                if(mutualinfo1[b] > 0 && mutualinfo2[c] > 0)
-                {
-                  value = (mutualinfo12[b][c] / (mutualinfo1[b] * mutualinfo2[c]));
-                }
-                if(value != 0)
-                {
-                  disorientation = disorientation + (mutualinfo12[b][c] * logf(value));
-                }
-              }
-            }
-            for(int32_t b = 0; b < featurecount1; b++)
-            {
-              for(int32_t c = 0; c < featurecount2; c++)
-              {
-                mutualinfo12[b][c] = 0.0f;
-                mutualinfo1[b] = 0.0f;
-                mutualinfo2[c] = 0.0f;
-              }
-            }
-            disorientation = 1.0f / disorientation;
-            misorients[k + oldxshift + dims[0] / 2][j + oldyshift + dims[1] / 2] = disorientation;
-            if(disorientation < mindisorientation)
-            {
-              newxshift = k + oldxshift;
-              newyshift = j + oldyshift;
-              mindisorientation = disorientation;
-            }
-          }
-        }
-      }
+      return;
     }
-    xshifts[iter] = xshifts[iter - 1] + newxshift;
-    yshifts[iter] = yshifts[iter - 1] + newyshift;
+
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(static_cast<size_t>(iter), static_cast<size_t>(std::min(iter + batchSize, dims[2])));
+    dataAlg.execute(FindSectionShiftsImpl(miFeatureIds, featurecounts, dims, newxshifts, newyshifts));
+  }
+
+  for(int64_t iter = 1; iter < dims[2]; iter++)
+  {
+    int64_t slice = (dims[2] - 1) - iter;
+    xshifts[iter] = xshifts[iter - 1] + newxshifts[iter];
+    yshifts[iter] = yshifts[iter - 1] + newyshifts[iter];
     if(getWriteAlignmentShifts())
     {
-      outFile << slice << "	" << slice + 1 << "	" << newxshift << "	" << newyshift << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
-    }
-    delete[] mutualinfo1;
-    delete[] mutualinfo2;
-    for(int32_t i = 0; i < featurecount1; i++)
-    {
-      delete mutualinfo12[i];
+      outFile << slice << "	" << slice + 1 << "	" << newxshifts[iter] << "	" << newyshifts[iter] << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
     }
-    delete[] mutualinfo12;
-    mutualinfo1 = nullptr;
-    mutualinfo2 = nullptr;
-    mutualinfo12 = nullptr;
   }
 
   m->getAttributeMatrix(getCellAttributeMatrixName())->removeAttributeArray(SIMPL::CellData::FeatureIds);
@@ -335,40 +335,66 @@ int64_t EBSDSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
 // -----------------------------------------------------------------------------
 bool EBSDSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum)
 {
-  bool group = false;
+  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]) && isGroupable(referencepoint, neighborpoint))
+  {
+    m_FeatureIds[neighborpoint] = gnum;
+    return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EBSDSegmentFeatures::isSeedCandidate(int64_t point) const
+{
+  return (!m_UseGoodVoxels || m_GoodVoxels[point]) && m_CellPhases[point] > 0;
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EBSDSegmentFeatures::isGroupable(int64_t referencepoint, int64_t neighborpoint) const
+{
   // Get the phases for each voxel
-  int32_t phase1 = m_CrystalStructures[m_CellPhases[referencepoint]];
-  int32_t phase2 = m_CrystalStructures[m_CellPhases[neighborpoint]];
+  uint32_t phase1 = m_CrystalStructures[m_CellPhases[referencepoint]];
+  uint32_t phase2 = m_CrystalStructures[m_CellPhases[neighborpoint]];
   // If either of the phases is 999 then we bail out now.
   if(phase1 >= m_OrientationOps.size() || phase2 >= m_OrientationOps.size())
   {
-    return group;
+    return false;
   }
-  float* currentQuatPtr = nullptr;
-
-  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]))
+  if(m_CellPhases[referencepoint] != m_CellPhases[neighborpoint])
   {
-    float w = std::numeric_limits<float>::max();
-    currentQuatPtr = m_Quats + referencepoint * 4;
-    QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-    currentQuatPtr = m_Quats + neighborpoint * 4;
-    QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-
-    if(m_CellPhases[referencepoint] == m_CellPhases[neighborpoint])
-    {
-      OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
-      w = axisAngle[3];
-    }
-    if(w < m_MisoTolerance)
-    {
-      group = true;
-      m_FeatureIds[neighborpoint] = gnum;
-    }
+    return false;
   }
-  return group;
+
+  const float* currentQuatPtr = m_Quats + referencepoint * 4;
+  QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+  currentQuatPtr = m_Quats + neighborpoint * 4;
+  QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+
+  OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
+  return axisAngle[3] < m_MisoTolerance;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* EBSDSegmentFeatures::getFeatureIdsForLabeling()
+{
+  return m_FeatureIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataArrayPath EBSDSegmentFeatures::getCellFeatureAttributeMatrixPath() const
+{
+  return DataArrayPath(getDataContainerName(), getCellFeatureAttributeMatrixName(), "");
+}
+
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
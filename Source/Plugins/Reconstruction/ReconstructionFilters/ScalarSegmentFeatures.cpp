@@ -77,6 +77,14 @@ public:
   {
     return false;
   }
+
+  /**
+   * @brief compare Side effect free comparison of the two data values; safe to call concurrently
+   */
+  virtual bool compare(int64_t index, int64_t neighIndex) const
+  {
+    return false;
+  }
 };
 
 /**
@@ -94,6 +102,16 @@ public:
   virtual ~TSpecificCompareFunctorBool() = default;
 
   bool operator()(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override
+  {
+    if(compare(referencepoint, neighborpoint))
+    {
+      m_FeatureIds[neighborpoint] = gnum;
+      return true;
+    }
+    return false;
+  }
+
+  bool compare(int64_t referencepoint, int64_t neighborpoint) const override
   {
     // Sanity check the indices that are being passed in.
     if(referencepoint >= m_Length || neighborpoint >= m_Length)
@@ -101,12 +119,7 @@ public:
       return false;
     }
 
-    if(m_Data[neighborpoint] == m_Data[referencepoint])
-    {
-      m_FeatureIds[neighborpoint] = gnum;
-      return true;
-    }
-    return false;
+    return m_Data[neighborpoint] == m_Data[referencepoint];
   }
 
 protected:
@@ -135,6 +148,16 @@ public:
   virtual ~TSpecificCompareFunctor() = default;
 
   bool operator()(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override
+  {
+    if(compare(referencepoint, neighborpoint))
+    {
+      m_FeatureIds[neighborpoint] = gnum;
+      return true;
+    }
+    return false;
+  }
+
+  bool compare(int64_t referencepoint, int64_t neighborpoint) const override
   {
     // Sanity check the indices that are being passed in.
     if(referencepoint >= m_Length || neighborpoint >= m_Length)
@@ -144,21 +167,9 @@ public:
 
     if(m_Data[referencepoint] >= m_Data[neighborpoint])
     {
-      if((m_Data[referencepoint] - m_Data[neighborpoint]) <= m_Tolerance)
-      {
-        m_FeatureIds[neighborpoint] = gnum;
-        return true;
-      }
+      return (m_Data[referencepoint] - m_Data[neighborpoint]) <= m_Tolerance;
     }
-    else
-    {
-      if((m_Data[neighborpoint] - m_Data[referencepoint]) <= m_Tolerance)
-      {
-        m_FeatureIds[neighborpoint] = gnum;
-        return true;
-      }
-    }
-    return false;
+    return (m_Data[neighborpoint] - m_Data[referencepoint]) <= m_Tolerance;
   }
 
 protected:
@@ -426,6 +437,38 @@ bool ScalarSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t ne
   return false;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ScalarSegmentFeatures::isSeedCandidate(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ScalarSegmentFeatures::isGroupable(int64_t referencepoint, int64_t neighborpoint) const
+{
+  return m_Compare->compare(referencepoint, neighborpoint);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* ScalarSegmentFeatures::getFeatureIdsForLabeling()
+{
+  return m_FeatureIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataArrayPath ScalarSegmentFeatures::getCellFeatureAttributeMatrixPath() const
+{
+  return DataArrayPath(getDataContainerName(), getCellFeatureAttributeMatrixName(), "");
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -251,6 +251,16 @@ public:
    */
   void execute() override;
 
+  /**
+   * @brief isSeedCandidate Reimplemented from @see SegmentFeatures class
+   */
+  bool isSeedCandidate(int64_t point) const override;
+
+  /**
+   * @brief isGroupable Reimplemented from @see SegmentFeatures class
+   */
+  bool isGroupable(int64_t referencepoint, int64_t neighborpoint) const override;
+
 protected:
   ScalarSegmentFeatures();
   /**
@@ -273,6 +283,16 @@ protected:
    */
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
 
+  /**
+   * @brief getFeatureIdsForLabeling Reimplemented from @see SegmentFeatures class
+   */
+  int32_t* getFeatureIdsForLabeling() override;
+
+  /**
+   * @brief getCellFeatureAttributeMatrixPath Reimplemented from @see SegmentFeatures class
+   */
+  DataArrayPath getCellFeatureAttributeMatrixPath() const override;
+
 private:
   IDataArrayWkPtrType m_InputDataPtr;
   void* m_InputData = nullptr;
@@ -316,7 +336,7 @@ private:
   /**
    * @brief updateFeatureInstancePointers Updates raw Feature pointers
    */
-  void updateFeatureInstancePointers();
+  void updateFeatureInstancePointers() override;
 
 public:
   ScalarSegmentFeatures(const ScalarSegmentFeatures&) = delete;            // Copy Constructor Not Implemented
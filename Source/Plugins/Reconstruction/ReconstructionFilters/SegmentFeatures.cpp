@@ -34,16 +34,225 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "SegmentFeatures.h"
 
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <utility>
+
 #include <QtCore/QTextStream>
 
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "Reconstruction/ReconstructionConstants.h"
 #include "Reconstruction/ReconstructionVersion.h"
 
+namespace
+{
+using SeamPairsType = std::vector<std::pair<int32_t, int32_t>>;
+
+/**
+ * @brief The LabelTilesImpl class runs the burn algorithm on each tile of the grid independently.
+ * A tile is a contiguous range of planes (or rows for a 2D grid), so the tile local labels are
+ * numbered in order of the lowest voxel index of each Feature, just like the serial algorithm.
+ */
+class LabelTilesImpl
+{
+public:
+  LabelTilesImpl(SegmentFeatures* filter, int32_t* featureIds, const int64_t* dims, const std::vector<int64_t>& tileBounds, std::vector<int32_t>& tileFeatureCounts)
+  : m_Filter(filter)
+  , m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_TileBounds(tileBounds)
+  , m_TileFeatureCounts(tileFeatureCounts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    std::vector<int64_t> voxelslist;
+    for(size_t tile = start; tile < end; tile++)
+    {
+      if(m_Filter->getCancel())
+      {
+        return;
+      }
+      m_TileFeatureCounts[tile] = labelTile(m_TileBounds[tile], m_TileBounds[tile + 1], voxelslist);
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  int32_t labelTile(int64_t tileStart, int64_t tileEnd, std::vector<int64_t>& voxelslist) const
+  {
+    const int64_t sliceStride = m_Dims[0] * m_Dims[1];
+    const int64_t neighpoints[6] = {-sliceStride, -m_Dims[0], -1, 1, m_Dims[0], sliceStride};
+
+    int32_t gnum = 0;
+    for(int64_t seed = tileStart; seed < tileEnd; seed++)
+    {
+      if(m_FeatureIds[seed] != 0 || !m_Filter->isSeedCandidate(seed))
+      {
+        continue;
+      }
+      gnum++;
+      m_FeatureIds[seed] = gnum;
+      voxelslist.clear();
+      voxelslist.push_back(seed);
+      while(!voxelslist.empty())
+      {
+        int64_t currentpoint = voxelslist.back();
+        voxelslist.pop_back();
+        int64_t col = currentpoint % m_Dims[0];
+        int64_t row = (currentpoint / m_Dims[0]) % m_Dims[1];
+        int64_t plane = currentpoint / sliceStride;
+        for(int32_t i = 0; i < 6; i++)
+        {
+          if((i == 0 && plane == 0) || (i == 5 && plane == (m_Dims[2] - 1)) || (i == 1 && row == 0) || (i == 4 && row == (m_Dims[1] - 1)) || (i == 2 && col == 0) ||
+             (i == 3 && col == (m_Dims[0] - 1)))
+          {
+            continue;
+          }
+          int64_t neighbor = currentpoint + neighpoints[i];
+          // Neighbors in other tiles are joined later when the tile seams are merged
+          if(neighbor < tileStart || neighbor >= tileEnd)
+          {
+            continue;
+          }
+          if(m_FeatureIds[neighbor] == 0 && m_Filter->isSeedCandidate(neighbor) && m_Filter->isGroupable(currentpoint, neighbor))
+          {
+            m_FeatureIds[neighbor] = gnum;
+            voxelslist.push_back(neighbor);
+          }
+        }
+      }
+    }
+    return gnum;
+  }
+
+  SegmentFeatures* m_Filter = nullptr;
+  int32_t* m_FeatureIds = nullptr;
+  const int64_t* m_Dims = nullptr;
+  const std::vector<int64_t>& m_TileBounds;
+  std::vector<int32_t>& m_TileFeatureCounts;
+};
+
+/**
+ * @brief The FindSeamPairsImpl class compares the voxels on either side of each tile seam and
+ * records the pairs of provisional Feature Ids that belong to the same Feature.
+ */
+class FindSeamPairsImpl
+{
+public:
+  FindSeamPairsImpl(SegmentFeatures* filter, const int32_t* featureIds, int64_t unitStride, const std::vector<int64_t>& tileBounds, const std::vector<int32_t>& tileOffsets,
+                    std::vector<SeamPairsType>& seamPairs)
+  : m_Filter(filter)
+  , m_FeatureIds(featureIds)
+  , m_UnitStride(unitStride)
+  , m_TileBounds(tileBounds)
+  , m_TileOffsets(tileOffsets)
+  , m_SeamPairs(seamPairs)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t seam = start; seam < end; seam++)
+    {
+      SeamPairsType& pairs = m_SeamPairs[seam];
+      const int64_t upperStart = m_TileBounds[seam + 1];
+      for(int64_t k = 0; k < m_UnitStride; k++)
+      {
+        int64_t upper = upperStart + k;
+        int64_t lower = upper - m_UnitStride;
+        if(m_FeatureIds[lower] == 0 || m_FeatureIds[upper] == 0 || !m_Filter->isGroupable(lower, upper))
+        {
+          continue;
+        }
+        std::pair<int32_t, int32_t> pair(m_TileOffsets[seam] + m_FeatureIds[lower], m_TileOffsets[seam + 1] + m_FeatureIds[upper]);
+        if(pairs.empty() || pairs.back() != pair)
+        {
+          pairs.push_back(pair);
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  SegmentFeatures* m_Filter = nullptr;
+  const int32_t* m_FeatureIds = nullptr;
+  int64_t m_UnitStride = 0;
+  const std::vector<int64_t>& m_TileBounds;
+  const std::vector<int32_t>& m_TileOffsets;
+  std::vector<SeamPairsType>& m_SeamPairs;
+};
+
+/**
+ * @brief The RelabelTilesImpl class replaces the tile local labels with the final Feature Ids
+ */
+class RelabelTilesImpl
+{
+public:
+  RelabelTilesImpl(int32_t* featureIds, const std::vector<int64_t>& tileBounds, const std::vector<int32_t>& tileOffsets, const std::vector<int32_t>& finalIds)
+  : m_FeatureIds(featureIds)
+  , m_TileBounds(tileBounds)
+  , m_TileOffsets(tileOffsets)
+  , m_FinalIds(finalIds)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t tile = start; tile < end; tile++)
+    {
+      const int32_t offset = m_TileOffsets[tile];
+      for(int64_t i = m_TileBounds[tile]; i < m_TileBounds[tile + 1]; i++)
+      {
+        if(m_FeatureIds[i] > 0)
+        {
+          m_FeatureIds[i] = m_FinalIds[offset + m_FeatureIds[i]];
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  int32_t* m_FeatureIds = nullptr;
+  const std::vector<int64_t>& m_TileBounds;
+  const std::vector<int32_t>& m_TileOffsets;
+  const std::vector<int32_t>& m_FinalIds;
+};
+
+// -----------------------------------------------------------------------------
+int32_t findRoot(std::vector<int32_t>& parents, int32_t label)
+{
+  while(parents[label] != label)
+  {
+    parents[label] = parents[parents[label]];
+    label = parents[label];
+  }
+  return label;
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -97,6 +306,152 @@ bool SegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighbor
   return false;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* SegmentFeatures::getFeatureIdsForLabeling()
+{
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::isSeedCandidate(int64_t point) const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::isGroupable(int64_t referencepoint, int64_t neighborpoint) const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataArrayPath SegmentFeatures::getCellFeatureAttributeMatrixPath() const
+{
+  return DataArrayPath();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SegmentFeatures::updateFeatureInstancePointers()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SegmentFeatures::updateFeatureCount(size_t numTuples)
+{
+  AttributeMatrix::Pointer cellFeatureAttrMat = getDataContainerArray()->getAttributeMatrix(getCellFeatureAttributeMatrixPath());
+  if(nullptr == cellFeatureAttrMat)
+  {
+    return;
+  }
+  std::vector<size_t> tDims(1, numTuples);
+  cellFeatureAttrMat->resizeAttributeArrays(tDims);
+  updateFeatureInstancePointers();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SegmentFeatures::labelFeaturesParallel(int32_t* featureIds, const int64_t dims[3])
+{
+  // Tiles are built from whole planes so that every tile is a contiguous range of voxel
+  // indices. A 2D grid is split along its rows instead.
+  const int64_t unitStride = (dims[2] > 1) ? dims[0] * dims[1] : dims[0];
+  const int64_t numUnits = (dims[2] > 1) ? dims[2] : dims[1];
+
+  int64_t numTiles = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  numTiles = std::min(numUnits, static_cast<int64_t>(std::max(2U * std::thread::hardware_concurrency(), 1U)));
+#endif
+
+  std::vector<int64_t> tileBounds(numTiles + 1, 0);
+  for(int64_t tile = 0; tile <= numTiles; tile++)
+  {
+    tileBounds[tile] = ((tile * numUnits) / numTiles) * unitStride;
+  }
+
+  notifyStatusMessage(QObject::tr("Labeling %1 Tiles").arg(numTiles));
+  std::vector<int32_t> tileFeatureCounts(numTiles, 0);
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, static_cast<size_t>(numTiles));
+    dataAlg.execute(LabelTilesImpl(this, featureIds, dims, tileBounds, tileFeatureCounts));
+  }
+  if(getCancel())
+  {
+    return 1;
+  }
+
+  // Provisional Feature Ids are the tile local labels shifted by the number of labels in the
+  // preceding tiles. Since tiles are ordered by voxel index so are the provisional Ids.
+  std::vector<int32_t> tileOffsets(numTiles, 0);
+  for(int64_t tile = 1; tile < numTiles; tile++)
+  {
+    tileOffsets[tile] = tileOffsets[tile - 1] + tileFeatureCounts[tile - 1];
+  }
+  const int32_t numProvisional = tileOffsets[numTiles - 1] + tileFeatureCounts[numTiles - 1];
+
+  notifyStatusMessage(QObject::tr("Merging Features Across %1 Tile Seams").arg(numTiles - 1));
+  std::vector<SeamPairsType> seamPairs(numTiles - 1);
+  if(numTiles > 1)
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, static_cast<size_t>(numTiles - 1));
+    dataAlg.execute(FindSeamPairsImpl(this, featureIds, unitStride, tileBounds, tileOffsets, seamPairs));
+  }
+
+  // Always attach the larger root to the smaller one so every root is the lowest provisional Id
+  // (and therefore the lowest voxel index) of its Feature
+  std::vector<int32_t> parents(numProvisional + 1, 0);
+  std::iota(parents.begin(), parents.end(), 0);
+  for(const auto& pairs : seamPairs)
+  {
+    for(const auto& pair : pairs)
+    {
+      int32_t root1 = findRoot(parents, pair.first);
+      int32_t root2 = findRoot(parents, pair.second);
+      if(root1 < root2)
+      {
+        parents[root2] = root1;
+      }
+      else if(root2 < root1)
+      {
+        parents[root1] = root2;
+      }
+    }
+  }
+  seamPairs.clear();
+
+  std::vector<int32_t> finalIds(numProvisional + 1, 0);
+  int32_t gnum = 0;
+  for(int32_t label = 1; label <= numProvisional; label++)
+  {
+    int32_t root = findRoot(parents, label);
+    finalIds[label] = (root == label) ? ++gnum : finalIds[root];
+  }
+  parents.clear();
+
+  notifyStatusMessage(QObject::tr("Total Features: %1").arg(gnum));
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, static_cast<size_t>(numTiles));
+    dataAlg.execute(RelabelTilesImpl(featureIds, tileBounds, tileOffsets, finalIds));
+  }
+
+  return static_cast<size_t>(gnum) + 1;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -120,6 +475,17 @@ void SegmentFeatures::execute()
       static_cast<int64_t>(udims[2]),
   };
 
+  int32_t* featureIds = getFeatureIdsForLabeling();
+  if(nullptr != featureIds)
+  {
+    size_t numTuples = labelFeaturesParallel(featureIds, dims);
+    if(!getCancel())
+    {
+      updateFeatureCount(numTuples);
+    }
+    return;
+  }
+
   int32_t gnum = 1;
   int64_t seed = 0;
   int64_t neighbor = 0;
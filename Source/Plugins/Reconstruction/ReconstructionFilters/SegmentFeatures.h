@@ -39,6 +39,7 @@
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
 #include "SIMPLib/Filtering/AbstractFilter.h"
 
 #include "Reconstruction/ReconstructionConstants.h"
@@ -159,6 +160,23 @@ public:
    */
   void execute() override;
 
+  /**
+   * @brief isSeedCandidate Determines if a voxel may belong to any Feature. This must not
+   * modify any state since it is called concurrently from the parallel labeling engine.
+   * @param point Voxel index
+   * @return Boolean check for whether the voxel can be segmented
+   */
+  virtual bool isSeedCandidate(int64_t point) const;
+
+  /**
+   * @brief isGroupable Side effect free version of determineGrouping() used by the parallel
+   * labeling engine. Both voxels are already known to be seed candidates.
+   * @param referencepoint Point of growing seed
+   * @param neighborpoint Point to be compared for adding
+   * @return Boolean check for whether the two voxels belong to the same Feature
+   */
+  virtual bool isGroupable(int64_t referencepoint, int64_t neighborpoint) const;
+
 protected:
   SegmentFeatures();
 
@@ -188,6 +206,44 @@ protected:
    */
   virtual bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum);
 
+  /**
+   * @brief getFeatureIdsForLabeling Returns the Feature Ids buffer the parallel labeling engine
+   * writes into. Subclasses that return nullptr (the default) are segmented with the serial burn
+   * algorithm using getSeed() and determineGrouping().
+   * @return Raw pointer to the Feature Ids or nullptr
+   */
+  virtual int32_t* getFeatureIdsForLabeling();
+
+  /**
+   * @brief getCellFeatureAttributeMatrixPath Returns the path of the Feature Attribute Matrix that
+   * updateFeatureCount() resizes. The default is an empty path, for which nothing is resized.
+   * @return Path to the Feature Attribute Matrix
+   */
+  virtual DataArrayPath getCellFeatureAttributeMatrixPath() const;
+
+  /**
+   * @brief updateFeatureInstancePointers Updates the raw Feature pointers after the Feature
+   * Attribute Matrix has been resized
+   */
+  virtual void updateFeatureInstancePointers();
+
+  /**
+   * @brief updateFeatureCount Resizes the Feature Attribute Matrix once the parallel labeling
+   * engine has determined the final number of Features.
+   * @param numTuples Number of Feature tuples, including the 0 Feature
+   */
+  void updateFeatureCount(size_t numTuples);
+
+  /**
+   * @brief labelFeaturesParallel Segments the volume into tiles that are labeled concurrently,
+   * merges the labels across tile seams with a union-find and then relabels the Features so the
+   * Feature Ids are identical to the ones produced by the serial burn algorithm.
+   * @param featureIds Feature Ids to fill, all values must be 0 on entry
+   * @param dims Dimensions of the grid
+   * @return Number of Feature tuples, including the 0 Feature
+   */
+  size_t labelFeaturesParallel(int32_t* featureIds, const int64_t dims[3]);
+
 public:
   SegmentFeatures(const SegmentFeatures&) = delete;            // Copy Constructor Not Implemented
   SegmentFeatures(SegmentFeatures&&) = delete;                 // Move Constructor Not Implemented
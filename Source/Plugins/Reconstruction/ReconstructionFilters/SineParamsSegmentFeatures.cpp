@@ -351,32 +351,60 @@ int64_t SineParamsSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
 // -----------------------------------------------------------------------------
 bool SineParamsSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum)
 {
-  bool group = false;
+  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]) && isGroupable(referencepoint, neighborpoint))
+  {
+    m_FeatureIds[neighborpoint] = gnum;
+    return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SineParamsSegmentFeatures::isSeedCandidate(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SineParamsSegmentFeatures::isGroupable(int64_t referencepoint, int64_t neighborpoint) const
+{
   float v1;
   float v2;
   float shift;
   float step = 45.0f * SIMPLib::Constants::k_PiOver180D;
   float avgDiff = 0;
-  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]))
+  for(int i = 0; i < 8; i++)
   {
-    for(int i = 0; i < 8; i++)
-    {
-      shift = float(i) * step;
-      v1 = m_SineParams[3 * referencepoint] * sin(2.0 * (shift + m_SineParams[3 * referencepoint + 2])) + m_SineParams[3 * referencepoint + 1];
-      v2 = m_SineParams[3 * neighborpoint] * sin(2.0 * (shift + m_SineParams[3 * neighborpoint + 2])) + m_SineParams[3 * neighborpoint + 1];
-      avgDiff += fabs(v1 - v2);
-    }
-    avgDiff /= 8.0;
-    if(avgDiff < 7)
-    {
-      group = true;
-      m_FeatureIds[neighborpoint] = gnum;
-    }
+    shift = float(i) * step;
+    v1 = m_SineParams[3 * referencepoint] * sin(2.0 * (shift + m_SineParams[3 * referencepoint + 2])) + m_SineParams[3 * referencepoint + 1];
+    v2 = m_SineParams[3 * neighborpoint] * sin(2.0 * (shift + m_SineParams[3 * neighborpoint + 2])) + m_SineParams[3 * neighborpoint + 1];
+    avgDiff += fabs(v1 - v2);
   }
+  avgDiff /= 8.0;
+  return avgDiff < 7;
+}
 
-  return group;
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* SineParamsSegmentFeatures::getFeatureIdsForLabeling()
+{
+  return m_FeatureIds;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataArrayPath SineParamsSegmentFeatures::getCellFeatureAttributeMatrixPath() const
+{
+  return DataArrayPath(getDataContainerName(), getCellFeatureAttributeMatrixName(), "");
+}
+
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -248,6 +248,9 @@ public:
    */
   void execute() override;
 
+  bool isSeedCandidate(int64_t point) const override;
+  bool isGroupable(int64_t referencepoint, int64_t neighborpoint) const override;
+
 protected:
   SineParamsSegmentFeatures();
   /**
@@ -262,6 +265,8 @@ protected:
 
   int64_t getSeed(int32_t gnum, int64_t nextSeed) override;
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
+  int32_t* getFeatureIdsForLabeling() override;
+  DataArrayPath getCellFeatureAttributeMatrixPath() const override;
 
 private:
   std::weak_ptr<DataArray<float>> m_SineParamsPtr;
@@ -305,7 +310,7 @@ private:
   /**
    * @brief updateFeatureInstancePointers Updates raw Feature pointers
    */
-  void updateFeatureInstancePointers();
+  void updateFeatureInstancePointers() override;
 
   bool m_MissingGoodVoxels;
 
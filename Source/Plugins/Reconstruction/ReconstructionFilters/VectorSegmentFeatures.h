@@ -246,6 +246,16 @@ public:
    */
   void execute() override;
 
+  /**
+   * @brief isSeedCandidate Reimplemented from @see SegmentFeatures class
+   */
+  bool isSeedCandidate(int64_t point) const override;
+
+  /**
+   * @brief isGroupable Reimplemented from @see SegmentFeatures class
+   */
+  bool isGroupable(int64_t referencepoint, int64_t neighborpoint) const override;
+
 protected:
   VectorSegmentFeatures();
   /**
@@ -268,6 +278,16 @@ protected:
    */
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
 
+  /**
+   * @brief getFeatureIdsForLabeling Reimplemented from @see SegmentFeatures class
+   */
+  int32_t* getFeatureIdsForLabeling() override;
+
+  /**
+   * @brief getCellFeatureAttributeMatrixPath Reimplemented from @see SegmentFeatures class
+   */
+  DataArrayPath getCellFeatureAttributeMatrixPath() const override;
+
 private:
   std::weak_ptr<DataArray<float>> m_VectorsPtr;
   float* m_Vectors = nullptr;
@@ -310,7 +330,7 @@ private:
   /**
    * @brief updateFeatureInstancePointers Updates raw Feature pointers
    */
-  void updateFeatureInstancePointers();
+  void updateFeatureInstancePointers() override;
 
 public:
   VectorSegmentFeatures(const VectorSegmentFeatures&) = delete;            // Copy Constructor Not Implemented
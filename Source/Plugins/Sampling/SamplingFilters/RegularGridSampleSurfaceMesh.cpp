@@ -34,6 +34,10 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "RegularGridSampleSurfaceMesh.h"
 
+#include <array>
+#include <cmath>
+#include <utility>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/DataContainers/DataContainer.h"
@@ -214,6 +218,64 @@ VertexGeom::Pointer RegularGridSampleSurfaceMesh::generate_points()
   return points;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RegularGridSampleSurfaceMesh::index_points(VertexGeom::Pointer /*points*/)
+{
+  // The points sit on a regular lattice, so find_candidate_points computes their index ranges directly from the grid
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RegularGridSampleSurfaceMesh::find_candidate_points(const float* lowerLeft, const float* upperRight, PointRanges& ranges) const
+{
+  // point i along a dimension sits at (i + 0.5) * spacing + origin, so the box maps straight onto index
+  // ranges; one extra index on each side absorbs the rounding of the float point coordinates
+  std::array<int64_t, 3> first = {0, 0, 0};
+  std::array<int64_t, 3> last = {0, 0, 0};
+  for(size_t d = 0; d < 3; d++)
+  {
+    if(m_Spacing[d] == 0.0f)
+    {
+      first[d] = 0;
+      last[d] = m_Dimensions[d] - 1;
+      continue;
+    }
+    double lower = (static_cast<double>(lowerLeft[d]) - m_Origin[d]) / m_Spacing[d] - 0.5;
+    double upper = (static_cast<double>(upperRight[d]) - m_Origin[d]) / m_Spacing[d] - 0.5;
+    if(lower > upper)
+    {
+      std::swap(lower, upper);
+    }
+    lower = std::floor(lower) - 1.0;
+    upper = std::ceil(upper) + 1.0;
+    if(!(lower <= upper) || upper < 0.0 || lower > static_cast<double>(m_Dimensions[d] - 1))
+    {
+      return;
+    }
+    first[d] = lower < 0.0 ? 0 : static_cast<int64_t>(lower);
+    last[d] = upper > static_cast<double>(m_Dimensions[d] - 1) ? m_Dimensions[d] - 1 : static_cast<int64_t>(upper);
+  }
+
+  for(int64_t k = first[2]; k <= last[2]; k++)
+  {
+    for(int64_t j = first[1]; j <= last[1]; j++)
+    {
+      int64_t row = (k * m_Dimensions[1] + j) * m_Dimensions[0];
+      if(!ranges.empty() && ranges.back().second == row + first[0])
+      {
+        ranges.back().second = row + last[0] + 1;
+      }
+      else
+      {
+        ranges.emplace_back(row + first[0], row + last[0] + 1);
+      }
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -262,6 +262,22 @@ protected:
    */
   void assign_points(Int32ArrayType::Pointer iArray) override;
 
+  /**
+   * @brief index_points Reimplemented from @see SampleSurfaceMesh class. The points lie on the output lattice,
+   * so no index needs to be built
+   * @param points Sampling points returned by generate_points
+   */
+  void index_points(VertexGeom::Pointer points) override;
+
+  /**
+   * @brief find_candidate_points Reimplemented from @see SampleSurfaceMesh class. Returns the rows of the
+   * lattice that overlap the box
+   * @param lowerLeft Lower corner of the box
+   * @param upperRight Upper corner of the box
+   * @param ranges Ranges of point indices
+   */
+  void find_candidate_points(const float* lowerLeft, const float* upperRight, PointRanges& ranges) const override;
+
 private:
   std::weak_ptr<DataArray<int32_t>> m_FeatureIdsPtr;
   int32_t* m_FeatureIds = nullptr;
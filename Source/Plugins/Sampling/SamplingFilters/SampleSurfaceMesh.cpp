@@ -34,6 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "SampleSurfaceMesh.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <mutex>
 #include <thread>
 
@@ -70,41 +73,64 @@ class SampleSurfaceMeshImplByPoints
   VertexGeom::Pointer m_FaceBBs;
   VertexGeom::Pointer m_Points;
   size_t m_FeatureId = 0;
+  std::array<float, 3> m_LowerLeft = {0.0F, 0.0F, 0.0F};
+  std::array<float, 3> m_UpperRight = {0.0F, 0.0F, 0.0F};
+  float m_Radius = 0.0f;
+  const SampleSurfaceMesh::PointRanges& m_Ranges;
+  const std::vector<int64_t>& m_RangeOffsets;
   int32_t* m_PolyIds = nullptr;
 
 public:
   SampleSurfaceMeshImplByPoints(SampleSurfaceMesh* filter, TriangleGeom::Pointer faces, Int32Int32DynamicListArray::Pointer faceIds, VertexGeom::Pointer faceBBs, VertexGeom::Pointer points,
-                                size_t featureId, int32_t* polyIds)
+                                size_t featureId, const std::array<float, 3>& lowerLeft, const std::array<float, 3>& upperRight, float radius, const SampleSurfaceMesh::PointRanges& ranges,
+                                const std::vector<int64_t>& rangeOffsets, int32_t* polyIds)
   : m_Filter(filter)
   , m_Faces(faces)
   , m_FaceIds(faceIds)
   , m_FaceBBs(faceBBs)
   , m_Points(points)
   , m_FeatureId(featureId)
+  , m_LowerLeft(lowerLeft)
+  , m_UpperRight(upperRight)
+  , m_Radius(radius)
+  , m_Ranges(ranges)
+  , m_RangeOffsets(rangeOffsets)
   , m_PolyIds(polyIds)
   {
   }
   virtual ~SampleSurfaceMeshImplByPoints() = default;
 
+  /**
+   * @brief checkPoints Tests the candidate points at positions [start, end) of the concatenated candidate ranges
+   * @param start
+   * @param end
+   */
   void checkPoints(size_t start, size_t end) const
   {
-    float radius = 0.0f;
+    float radius = m_Radius;
     float distToBoundary = 0.0f;
-    int64_t numPoints = m_Points->getNumberOfVertices();
-    std::array<float, 3> lowerLeft = {0.0F, 0.0F, 0.0F};
-    std::array<float, 3> upperRight = {0.0F, 0.0F, 0.0F};
+    int64_t numCandidates = m_RangeOffsets.back();
+    std::array<float, 3> lowerLeft = m_LowerLeft;
+    std::array<float, 3> upperRight = m_UpperRight;
     float* point = nullptr;
     char code = ' ';
 
     size_t iter = m_FeatureId;
 
-    // find bounding box for current feature
-    GeometryMath::FindBoundingBoxOfFaces(m_Faces.get(), m_FaceIds->getElementList(iter), lowerLeft.data(), upperRight.data());
-    GeometryMath::FindDistanceBetweenPoints(lowerLeft.data(), upperRight.data(), radius);
+    // find the candidate range holding the first position of this chunk
+    size_t r = static_cast<size_t>(std::upper_bound(m_RangeOffsets.begin(), m_RangeOffsets.end(), static_cast<int64_t>(start)) - m_RangeOffsets.begin()) - 1;
+    int64_t i = m_Ranges[r].first + (static_cast<int64_t>(start) - m_RangeOffsets[r]);
+
     int64_t pointsVisited = 0;
-    // check points in vertex array to see if they are in the bounding box of the feature
-    for(int64_t i = static_cast<int64_t>(start); i < static_cast<int64_t>(end); i++)
+    // check the candidate points to see if they are in the bounding box of the feature
+    for(size_t pos = start; pos < end; pos++)
     {
+      if(i == m_Ranges[r].second)
+      {
+        r++;
+        i = m_Ranges[r].first;
+      }
+
       point = m_Points->getVertexPointer(i);
       if(m_PolyIds[i] == 0 && GeometryMath::PointInBox(point, lowerLeft.data(), upperRight.data()))
       {
@@ -114,12 +140,13 @@ public:
           m_PolyIds[i] = iter;
         }
       }
+      i++;
       pointsVisited++;
 
       // Send some feedback
       if(pointsVisited % 1000 == 0)
       {
-        m_Filter->sendThreadSafeProgressMessage(m_FeatureId, 1000, numPoints);
+        m_Filter->sendThreadSafeProgressMessage(m_FeatureId, 1000, numCandidates);
       }
       // Check for the filter being cancelled.
       if(m_Filter->getCancel())
@@ -166,20 +193,29 @@ public:
   {
     float radius = 0.0f;
     float distToBoundary = 0.0f;
-    int64_t numPoints = m_Points->getNumberOfVertices();
     std::array<float, 3> lowerLeft = {0.0F, 0.0F, 0.0F};
     std::array<float, 3> upperRight = {0.0F, 0.0F, 0.0F};
     float* point = nullptr;
     char code = ' ';
+    SampleSurfaceMesh::PointRanges ranges;
 
     for(size_t iter = start; iter < end; iter++)
     {
+      // a feature without faces cannot contain any point
+      if(m_FaceIds->getNumberOfElements(iter) == 0)
+      {
+        continue;
+      }
+
       // find bounding box for current feature
       GeometryMath::FindBoundingBoxOfFaces(m_Faces.get(), m_FaceIds->getElementList(iter), lowerLeft.data(), upperRight.data());
       GeometryMath::FindDistanceBetweenPoints(lowerLeft.data(), upperRight.data(), radius);
 
-      // check points in vertex array to see if they are in the bounding box of the feature
-      for(int64_t i = 0; i < numPoints; i++)
+      // only the points that can lie in the bounding box of the feature need to be checked
+      ranges.clear();
+      m_Filter->find_candidate_points(lowerLeft.data(), upperRight.data(), ranges);
+
+      for(const auto& range : ranges)
       {
         // Check for the filter being cancelled.
         if(m_Filter->getCancel())
@@ -187,13 +223,16 @@ public:
           return;
         }
 
-        point = m_Points->getVertexPointer(i);
-        if(m_PolyIds[i] == 0 && GeometryMath::PointInBox(point, lowerLeft.data(), upperRight.data()))
+        for(int64_t i = range.first; i < range.second; i++)
         {
-          code = GeometryMath::PointInPolyhedron(m_Faces.get(), m_FaceIds->getElementList(iter), m_FaceBBs.get(), point, lowerLeft.data(), upperRight.data(), radius, distToBoundary);
-          if(code == 'i' || code == 'V' || code == 'E' || code == 'F')
+          point = m_Points->getVertexPointer(i);
+          if(m_PolyIds[i] == 0 && GeometryMath::PointInBox(point, lowerLeft.data(), upperRight.data()))
           {
-            m_PolyIds[i] = iter;
+            code = GeometryMath::PointInPolyhedron(m_Faces.get(), m_FaceIds->getElementList(iter), m_FaceBBs.get(), point, lowerLeft.data(), upperRight.data(), radius, distToBoundary);
+            if(code == 'i' || code == 'V' || code == 'E' || code == 'F')
+            {
+              m_PolyIds[i] = iter;
+            }
           }
         }
       }
@@ -300,6 +339,149 @@ void SampleSurfaceMesh::assign_points(Int32ArrayType::Pointer iArray)
 {
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SampleSurfaceMesh::index_points(VertexGeom::Pointer points)
+{
+  int64_t numPoints = points->getNumberOfVertices();
+  m_BinOffsets.clear();
+  m_BinPointIds.clear();
+  if(numPoints == 0)
+  {
+    m_BinDims = {0, 0, 0};
+    return;
+  }
+
+  // find the extent of the points, ignoring any non finite coordinates
+  std::array<float, 3> minCoords = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+  std::array<float, 3> maxCoords = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+  for(int64_t i = 0; i < numPoints; i++)
+  {
+    float* point = points->getVertexPointer(i);
+    for(size_t d = 0; d < 3; d++)
+    {
+      if(std::isfinite(point[d]))
+      {
+        minCoords[d] = std::min(minCoords[d], point[d]);
+        maxCoords[d] = std::max(maxCoords[d], point[d]);
+      }
+    }
+  }
+
+  // aim for a handful of points per bin, spread over the dimensions the points actually extend in
+  size_t numExtended = 0;
+  for(size_t d = 0; d < 3; d++)
+  {
+    if(maxCoords[d] > minCoords[d])
+    {
+      numExtended++;
+    }
+  }
+  const double k_PointsPerBin = 4.0;
+  int64_t binsPerDim = 1;
+  if(numExtended > 0)
+  {
+    binsPerDim = std::max(static_cast<int64_t>(1), static_cast<int64_t>(std::pow(static_cast<double>(numPoints) / k_PointsPerBin, 1.0 / static_cast<double>(numExtended))));
+  }
+  for(size_t d = 0; d < 3; d++)
+  {
+    if(maxCoords[d] > minCoords[d])
+    {
+      m_BinOrigin[d] = minCoords[d];
+      m_BinDims[d] = binsPerDim;
+      m_InverseBinSize[d] = static_cast<float>(static_cast<double>(binsPerDim) / (static_cast<double>(maxCoords[d]) - static_cast<double>(minCoords[d])));
+    }
+    else
+    {
+      m_BinOrigin[d] = 0.0f;
+      m_BinDims[d] = 1;
+      m_InverseBinSize[d] = 0.0f;
+    }
+  }
+
+  // counting sort of the point ids by bin, which keeps the ids of each bin in increasing order
+  std::vector<int64_t> pointBins(numPoints);
+  m_BinOffsets.assign(m_BinDims[0] * m_BinDims[1] * m_BinDims[2] + 1, 0);
+  for(int64_t i = 0; i < numPoints; i++)
+  {
+    float* point = points->getVertexPointer(i);
+    pointBins[i] = (binIndex(point[2], 2) * m_BinDims[1] + binIndex(point[1], 1)) * m_BinDims[0] + binIndex(point[0], 0);
+    m_BinOffsets[pointBins[i] + 1]++;
+  }
+  for(size_t b = 1; b < m_BinOffsets.size(); b++)
+  {
+    m_BinOffsets[b] += m_BinOffsets[b - 1];
+  }
+  m_BinPointIds.resize(numPoints);
+  std::vector<int64_t> binFill(m_BinOffsets.begin(), m_BinOffsets.end() - 1);
+  for(int64_t i = 0; i < numPoints; i++)
+  {
+    m_BinPointIds[binFill[pointBins[i]]++] = i;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int64_t SampleSurfaceMesh::binIndex(float value, size_t dim) const
+{
+  // the same monotone mapping is used for points and for box corners, so a point inside a box
+  // always lands in a bin between the bins of the box corners
+  float t = (value - m_BinOrigin[dim]) * m_InverseBinSize[dim];
+  if(!(t >= 0.0f))
+  {
+    return 0;
+  }
+  if(t >= static_cast<float>(m_BinDims[dim]))
+  {
+    return m_BinDims[dim] - 1;
+  }
+  return std::min(static_cast<int64_t>(t), m_BinDims[dim] - 1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SampleSurfaceMesh::find_candidate_points(const float* lowerLeft, const float* upperRight, PointRanges& ranges) const
+{
+  if(m_BinOffsets.empty())
+  {
+    return;
+  }
+
+  std::array<int64_t, 3> first = {0, 0, 0};
+  std::array<int64_t, 3> last = {0, 0, 0};
+  for(size_t d = 0; d < 3; d++)
+  {
+    first[d] = binIndex(lowerLeft[d], d);
+    last[d] = binIndex(upperRight[d], d);
+  }
+
+  for(int64_t k = first[2]; k <= last[2]; k++)
+  {
+    for(int64_t j = first[1]; j <= last[1]; j++)
+    {
+      int64_t row = (k * m_BinDims[1] + j) * m_BinDims[0];
+      for(int64_t i = first[0]; i <= last[0]; i++)
+      {
+        for(int64_t b = m_BinOffsets[row + i]; b < m_BinOffsets[row + i + 1]; b++)
+        {
+          int64_t pointId = m_BinPointIds[b];
+          if(!ranges.empty() && ranges.back().second == pointId)
+          {
+            ranges.back().second++;
+          }
+          else
+          {
+            ranges.emplace_back(pointId, pointId + 1);
+          }
+        }
+      }
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -434,6 +616,17 @@ void SampleSurfaceMesh::execute()
   iArray->initializeWithZeros();
   int32_t* polyIds = iArray->getPointer(0);
 
+  notifyStatusMessage("Indexing sampling points ...");
+
+  // build the lookup that lets each feature visit only the points near its bounding box
+  index_points(points);
+
+  // Check for user canceled flag.
+  if(getCancel())
+  {
+    return;
+  }
+
   notifyStatusMessage("Sampling triangle geometry ...");
 
   // C++11 RIGHT HERE....
@@ -451,22 +644,59 @@ void SampleSurfaceMesh::execute()
   }
   else
   {
+    float radius = 0.0f;
+    std::array<float, 3> lowerLeft = {0.0F, 0.0F, 0.0F};
+    std::array<float, 3> upperRight = {0.0F, 0.0F, 0.0F};
+    PointRanges ranges;
+    std::vector<int64_t> rangeOffsets;
+
     for(int featureId = 0; featureId < numFeatures; featureId++)
     {
+      // a feature without faces cannot contain any point
+      if(faceLists->getNumberOfElements(featureId) == 0)
+      {
+        continue;
+      }
+
+      // find bounding box for current feature and the points that may fall inside it
+      GeometryMath::FindBoundingBoxOfFaces(triangleGeom.get(), faceLists->getElementList(featureId), lowerLeft.data(), upperRight.data());
+      GeometryMath::FindDistanceBetweenPoints(lowerLeft.data(), upperRight.data(), radius);
+      ranges.clear();
+      find_candidate_points(lowerLeft.data(), upperRight.data(), ranges);
+
+      rangeOffsets.assign(1, 0);
+      for(const auto& range : ranges)
+      {
+        rangeOffsets.push_back(rangeOffsets.back() + (range.second - range.first));
+      }
+      size_t numCandidates = static_cast<size_t>(rangeOffsets.back());
+      if(numCandidates == 0)
+      {
+        continue;
+      }
+
       m_NumCompleted = 0;
       m_StartMillis = QDateTime::currentMSecsSinceEpoch();
       m_Millis = m_StartMillis;
-      size_t numPoints = points->getNumberOfVertices();
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-      tbb::parallel_for(tbb::blocked_range<size_t>(0, numPoints), SampleSurfaceMeshImplByPoints(this, triangleGeom, faceLists, faceBBs, points, featureId, polyIds), tbb::auto_partitioner());
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, numCandidates),
+                        SampleSurfaceMeshImplByPoints(this, triangleGeom, faceLists, faceBBs, points, featureId, lowerLeft, upperRight, radius, ranges, rangeOffsets, polyIds),
+                        tbb::auto_partitioner());
 
 #else
-      SampleSurfaceMeshImplByPoints serial(this, triangleGeom, faceLists, faceBBs, points, featureId, polyIds);
-      serial.checkPoints(0, numPoints);
+      SampleSurfaceMeshImplByPoints serial(this, triangleGeom, faceLists, faceBBs, points, featureId, lowerLeft, upperRight, radius, ranges, rangeOffsets, polyIds);
+      serial.checkPoints(0, numCandidates);
 #endif
     }
   }
+
+  // the point index is only needed while sampling
+  m_BinOffsets.clear();
+  m_BinOffsets.shrink_to_fit();
+  m_BinPointIds.clear();
+  m_BinPointIds.shrink_to_fit();
+
   assign_points(iArray);
 
   notifyStatusMessage("Complete");
@@ -35,7 +35,10 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
@@ -168,6 +171,11 @@ public:
    */
   void sendThreadSafeProgressMessage(int featureId, size_t numCompleted, size_t totalFeatures);
 
+  /**
+   * @brief Half open [first, second) ranges of sampling point indices
+   */
+  using PointRanges = std::vector<std::pair<int64_t, int64_t>>;
+
 protected:
   SampleSurfaceMesh();
   /**
@@ -193,6 +201,22 @@ protected:
    */
   virtual void assign_points(Int32ArrayType::Pointer iArray);
 
+  /**
+   * @brief index_points Builds the spatial lookup used by find_candidate_points. The default sorts the
+   * points into a uniform grid of bins; subclasses whose points lie on a known lattice can skip this
+   * @param points Sampling points returned by generate_points
+   */
+  virtual void index_points(VertexGeom::Pointer points);
+
+  /**
+   * @brief find_candidate_points Appends non empty ranges of point indices that may lie inside the given box. Every
+   * point inside the box must be covered exactly once, but points outside of it may be returned as well
+   * @param lowerLeft Lower corner of the box
+   * @param upperRight Upper corner of the box
+   * @param ranges Ranges of point indices
+   */
+  virtual void find_candidate_points(const float* lowerLeft, const float* upperRight, PointRanges& ranges) const;
+
 private:
   std::weak_ptr<DataArray<int32_t>> m_SurfaceMeshFaceLabelsPtr;
   int32_t* m_SurfaceMeshFaceLabels = nullptr;
@@ -204,6 +228,22 @@ private:
   qint64 m_Millis = 0;
   int64_t m_LastCompletedPoints = 0;
 
+  std::array<float, 3> m_BinOrigin = {0.0f, 0.0f, 0.0f};
+  std::array<float, 3> m_InverseBinSize = {0.0f, 0.0f, 0.0f};
+  std::array<int64_t, 3> m_BinDims = {0, 0, 0};
+  std::vector<int64_t> m_BinOffsets;
+  std::vector<int64_t> m_BinPointIds;
+
+  /**
+   * @brief binIndex Returns the bin along dimension dim that holds the coordinate value
+   * @param value
+   * @param dim
+   * @return
+   */
+  int64_t binIndex(float value, size_t dim) const;
+
+  friend class SampleSurfaceMeshImpl;
+
 public:
   SampleSurfaceMesh(const SampleSurfaceMesh&) = delete;            // Copy Constructor Not Implemented
   SampleSurfaceMesh(SampleSurfaceMesh&&) = delete;                 // Move Constructor Not Implemented
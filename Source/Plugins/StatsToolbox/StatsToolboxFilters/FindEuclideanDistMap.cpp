@@ -34,6 +34,10 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindEuclideanDistMap.h"
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
 
 #include <tbb/blocked_range.h>
@@ -56,6 +60,7 @@
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "StatsToolbox/StatsToolboxConstants.h"
 #include "StatsToolbox/StatsToolboxVersion.h"
@@ -128,8 +133,8 @@ public:
     // Use a std::vector to get an auto cleaned up array thus not needing the 'delete' keyword later on.
     std::vector<int32_t> voxNN(totalPoints, 0);
     int32_t* voxel_NearestNeighbor = &(voxNN.front());
-    std::vector<double> voxEDist(totalPoints, 0.0);
-    double* voxel_Distance = &(voxEDist.front());
+    std::vector<float> voxEDist(totalPoints, 0.0f);
+    float* voxel_Distance = &(voxEDist.front());
 
     Distance = 0;
     for(size_t a = 0; a < totalPoints; ++a)
@@ -144,15 +149,15 @@ public:
       }
       if(m_MapType == FindEuclideanDistMap::MapType::FeatureBoundary)
       {
-        voxel_Distance[a] = static_cast<double>(m_GBManhattanDistances[a]);
+        voxel_Distance[a] = static_cast<float>(m_GBManhattanDistances[a]);
       }
       else if(m_MapType == FindEuclideanDistMap::MapType::TripleJunction)
       {
-        voxel_Distance[a] = static_cast<double>(m_TJManhattanDistances[a]);
+        voxel_Distance[a] = static_cast<float>(m_TJManhattanDistances[a]);
       }
       else if(m_MapType == FindEuclideanDistMap::MapType::QuadPoint)
       {
-        voxel_Distance[a] = static_cast<double>(m_QPManhattanDistances[a]);
+        voxel_Distance[a] = static_cast<float>(m_QPManhattanDistances[a]);
       }
     }
 
@@ -216,7 +221,7 @@ public:
                 neighpoint = i + neighbors[j];
                 if(mask[j] == 1)
                 {
-                  if(voxel_Distance[neighpoint] != -1.0)
+                  if(voxel_Distance[neighpoint] != -1.0f)
                   {
                     voxel_NearestNeighbor[i] = voxel_NearestNeighbor[neighpoint];
                   }
@@ -228,10 +233,10 @@ public:
       }
       for(size_t j = 0; j < totalPoints; ++j)
       {
-        if(voxel_NearestNeighbor[j] != -1 && voxel_Distance[j] == -1.0 && m_FeatureIds[j] > 0)
+        if(voxel_NearestNeighbor[j] != -1 && voxel_Distance[j] == -1.0f && m_FeatureIds[j] > 0)
         {
           changed++;
-          voxel_Distance[j] = Distance;
+          voxel_Distance[j] = static_cast<float>(Distance);
         }
       }
     }
@@ -263,7 +268,7 @@ public:
               z2 = spacing[2] * floor(nearestneighbor * oneOverzBlock);                      // find_zcoord(nearestneighbor);
               dist = ((x1 - x2) * (x1 - x2)) + ((y1 - y2) * (y1 - y2)) + ((z1 - z2) * (z1 - z2));
               dist = sqrt(dist);
-              voxel_Distance[zStride + yStride + p] = dist;
+              voxel_Distance[zStride + yStride + p] = static_cast<float>(dist);
             }
           }
         }
@@ -288,6 +293,234 @@ public:
   }
 };
 
+namespace
+{
+// Squared distance of a Cell that no Cell of the map has reached yet
+constexpr float k_Unreached = std::numeric_limits<float>::max();
+
+/**
+ * @brief The InitializeExactDistanceImpl class seeds the exact distance transform: Cells of the map start at a squared
+ * distance of 0 with themselves as the nearest Cell, every other Cell starts unreached
+ */
+class InitializeExactDistanceImpl
+{
+public:
+  InitializeExactDistanceImpl(const int32_t* featureIds, int32_t* nearestNeighbors, uint32_t mapIndex, float* squaredDistances)
+  : m_FeatureIds(featureIds)
+  , m_NearestNeighbors(nearestNeighbors)
+  , m_MapIndex(mapIndex)
+  , m_SquaredDistances(squaredDistances)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t a = start; a < end; a++)
+    {
+      int32_t& nearest = m_NearestNeighbors[a * 3 + m_MapIndex];
+      if(m_FeatureIds[a] > 0 && nearest >= 0)
+      {
+        m_SquaredDistances[a] = 0.0f;
+        nearest = static_cast<int32_t>(a);
+      }
+      else
+      {
+        m_SquaredDistances[a] = k_Unreached;
+        nearest = -1;
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  int32_t* m_NearestNeighbors;
+  uint32_t m_MapIndex;
+  float* m_SquaredDistances;
+};
+
+/**
+ * @brief The ExactDistanceLinesImpl class runs one pass of the separable exact Euclidean distance transform
+ * (Felzenszwalb & Huttenlocher) over a set of scan lines along one axis. Each line takes the lower envelope of the
+ * parabolas rooted at its Cells and carries the nearest Cell of the winning parabola along with the squared distance.
+ */
+class ExactDistanceLinesImpl
+{
+public:
+  ExactDistanceLinesImpl(const int64_t* dims, size_t axis, float spacing, int32_t* nearestNeighbors, uint32_t mapIndex, float* squaredDistances)
+  : m_Dims(dims)
+  , m_Axis(axis)
+  , m_Spacing(static_cast<double>(spacing))
+  , m_NearestNeighbors(nearestNeighbors)
+  , m_MapIndex(mapIndex)
+  , m_SquaredDistances(squaredDistances)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t length = m_Dims[m_Axis];
+    const int64_t strides[3] = {1, m_Dims[0], m_Dims[0] * m_Dims[1]};
+    const int64_t stride = strides[m_Axis];
+
+    std::vector<float> lineDistances(length);
+    std::vector<int32_t> lineNearest(length);
+    std::vector<int64_t> vertices(length);
+    std::vector<double> boundaries(length + 1);
+
+    for(size_t line = start; line < end; line++)
+    {
+      int64_t first = lineStart(static_cast<int64_t>(line));
+      for(int64_t q = 0; q < length; q++)
+      {
+        int64_t cell = first + q * stride;
+        lineDistances[q] = m_SquaredDistances[cell];
+        lineNearest[q] = m_NearestNeighbors[cell * 3 + m_MapIndex];
+      }
+
+      // Lower envelope of the parabolas of every reached Cell on the line
+      int64_t k = -1;
+      for(int64_t q = 0; q < length; q++)
+      {
+        if(lineDistances[q] == k_Unreached)
+        {
+          continue;
+        }
+        if(k < 0)
+        {
+          k = 0;
+          vertices[0] = q;
+          boundaries[0] = -std::numeric_limits<double>::max();
+          boundaries[1] = std::numeric_limits<double>::max();
+          continue;
+        }
+        double s = intersection(lineDistances.data(), vertices[k], q);
+        while(s <= boundaries[k])
+        {
+          k--;
+          s = intersection(lineDistances.data(), vertices[k], q);
+        }
+        k++;
+        vertices[k] = q;
+        boundaries[k] = s;
+        boundaries[k + 1] = std::numeric_limits<double>::max();
+      }
+      if(k < 0)
+      {
+        continue;
+      }
+
+      k = 0;
+      for(int64_t q = 0; q < length; q++)
+      {
+        double position = static_cast<double>(q) * m_Spacing;
+        while(boundaries[k + 1] < position)
+        {
+          k++;
+        }
+        double offset = position - static_cast<double>(vertices[k]) * m_Spacing;
+        int64_t cell = first + q * stride;
+        m_SquaredDistances[cell] = static_cast<float>(offset * offset + static_cast<double>(lineDistances[vertices[k]]));
+        m_NearestNeighbors[cell * 3 + m_MapIndex] = lineNearest[vertices[k]];
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int64_t* m_Dims;
+  size_t m_Axis;
+  double m_Spacing;
+  int32_t* m_NearestNeighbors;
+  uint32_t m_MapIndex;
+  float* m_SquaredDistances;
+
+  /**
+   * @brief lineStart Returns the index of the first Cell of a scan line, numbering lines over the other two axes
+   */
+  int64_t lineStart(int64_t line) const
+  {
+    if(m_Axis == 0)
+    {
+      return line * m_Dims[0];
+    }
+    if(m_Axis == 1)
+    {
+      return (line / m_Dims[0]) * m_Dims[0] * m_Dims[1] + (line % m_Dims[0]);
+    }
+    return line;
+  }
+
+  /**
+   * @brief intersection Returns the position at which the parabola rooted at q starts to lie below the one rooted at p
+   */
+  double intersection(const float* lineDistances, int64_t p, int64_t q) const
+  {
+    double pPos = static_cast<double>(p) * m_Spacing;
+    double qPos = static_cast<double>(q) * m_Spacing;
+    return ((static_cast<double>(lineDistances[q]) + qPos * qPos) - (static_cast<double>(lineDistances[p]) + pPos * pPos)) / (2.0 * (qPos - pPos));
+  }
+};
+
+/**
+ * @brief The FinalizeExactDistanceImpl class turns the squared distances into distances. Cells outside of a Feature are
+ * their own nearest Cell at a distance of 0, and Cells no map Cell reached get -1 for both, matching the values the
+ * propagation based map leaves in them.
+ */
+class FinalizeExactDistanceImpl
+{
+public:
+  FinalizeExactDistanceImpl(const int32_t* featureIds, int32_t* nearestNeighbors, uint32_t mapIndex, float* distances)
+  : m_FeatureIds(featureIds)
+  , m_NearestNeighbors(nearestNeighbors)
+  , m_MapIndex(mapIndex)
+  , m_Distances(distances)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t a = start; a < end; a++)
+    {
+      int32_t& nearest = m_NearestNeighbors[a * 3 + m_MapIndex];
+      if(m_FeatureIds[a] <= 0)
+      {
+        m_Distances[a] = 0.0f;
+        nearest = static_cast<int32_t>(a);
+      }
+      else if(m_Distances[a] == k_Unreached)
+      {
+        m_Distances[a] = -1.0f;
+        nearest = -1;
+      }
+      else
+      {
+        m_Distances[a] = std::sqrt(m_Distances[a]);
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  int32_t* m_NearestNeighbors;
+  uint32_t m_MapIndex;
+  float* m_Distances;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -305,6 +538,7 @@ void FindEuclideanDistMap::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_BOOL_FP("Output arrays are Manhattan istance (int32)", CalcManhattanDist, FilterParameter::Category::Parameter, FindEuclideanDistMap));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Use Exact Euclidean Distance Transform", UseExactDistanceTransform, FilterParameter::Category::Parameter, FindEuclideanDistMap));
   std::vector<QString> linkedProps = {"GBDistancesArrayName"};
 
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Calculate Distance to Boundaries", DoBoundaries, FilterParameter::Category::Parameter, FindEuclideanDistMap, linkedProps));
@@ -353,6 +587,7 @@ void FindEuclideanDistMap::readFilterParameters(AbstractFilterParametersReader*
   setDoQuadPoints(reader->readValue("DoQuadPoints", getDoQuadPoints()));
   setSaveNearestNeighbors(reader->readValue("SaveNearestNeighbors", getSaveNearestNeighbors()));
   setCalcManhattanDist(reader->readValue("CalcOnlyManhattanDist", getCalcManhattanDist()));
+  setUseExactDistanceTransform(reader->readValue("UseExactDistanceTransform", getUseExactDistanceTransform()));
   reader->closeFilterGroup();
 }
 
@@ -657,6 +892,23 @@ void FindEuclideanDistMap::findDistanceMap()
     }
   }
 
+  if(!m_CalcManhattanDist && m_UseExactDistanceTransform)
+  {
+    if(m_DoBoundaries)
+    {
+      findExactDistanceMap(MapType::FeatureBoundary, m_GBEuclideanDistances);
+    }
+    if(m_DoTripleLines)
+    {
+      findExactDistanceMap(MapType::TripleJunction, m_TJEuclideanDistances);
+    }
+    if(m_DoQuadPoints)
+    {
+      findExactDistanceMap(MapType::QuadPoint, m_QPEuclideanDistances);
+    }
+    return;
+  }
+
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
   if(true)
   {
@@ -732,6 +984,42 @@ void FindEuclideanDistMap::findDistanceMap()
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FindEuclideanDistMap::findExactDistanceMap(MapType mapType, float* distances)
+{
+  ImageGeom::Pointer imageGeom = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName())->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = imageGeom->getDimensions();
+  FloatVec3Type spacing = imageGeom->getSpacing();
+  int64_t dims[3] = {static_cast<int64_t>(udims[0]), static_cast<int64_t>(udims[1]), static_cast<int64_t>(udims[2])};
+  size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
+  uint32_t mapIndex = static_cast<uint32_t>(mapType);
+
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, totalPoints);
+    dataAlg.execute(InitializeExactDistanceImpl(m_FeatureIds, m_NearestNeighbors, mapIndex, distances));
+  }
+
+  // One pass per axis; the scan lines of a pass are independent of each other
+  for(size_t axis = 0; axis < 3; axis++)
+  {
+    if(getCancel())
+    {
+      return;
+    }
+    size_t numLines = totalPoints / udims[axis];
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, numLines);
+    dataAlg.execute(ExactDistanceLinesImpl(dims, axis, spacing[axis], m_NearestNeighbors, mapIndex, distances));
+  }
+
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0ULL, totalPoints);
+  dataAlg.execute(FinalizeExactDistanceImpl(m_FeatureIds, m_NearestNeighbors, mapIndex, distances));
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -972,3 +1260,15 @@ bool FindEuclideanDistMap::getCalcManhattanDist() const
 {
   return m_CalcManhattanDist;
 }
+
+// -----------------------------------------------------------------------------
+void FindEuclideanDistMap::setUseExactDistanceTransform(bool value)
+{
+  m_UseExactDistanceTransform = value;
+}
+
+// -----------------------------------------------------------------------------
+bool FindEuclideanDistMap::getUseExactDistanceTransform() const
+{
+  return m_UseExactDistanceTransform;
+}
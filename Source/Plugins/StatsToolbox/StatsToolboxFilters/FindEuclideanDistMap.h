@@ -65,6 +65,7 @@ class StatsToolbox_EXPORT FindEuclideanDistMap : public AbstractFilter
   PYB11_PROPERTY(bool DoQuadPoints READ getDoQuadPoints WRITE setDoQuadPoints)
   PYB11_PROPERTY(bool SaveNearestNeighbors READ getSaveNearestNeighbors WRITE setSaveNearestNeighbors)
   PYB11_PROPERTY(bool CalcManhattanDist READ getCalcManhattanDist WRITE setCalcManhattanDist)
+  PYB11_PROPERTY(bool UseExactDistanceTransform READ getUseExactDistanceTransform WRITE setUseExactDistanceTransform)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -217,6 +218,17 @@ public:
   bool getCalcManhattanDist() const;
   Q_PROPERTY(bool CalcManhattanDist READ getCalcManhattanDist WRITE setCalcManhattanDist)
 
+  /**
+   * @brief Setter property for UseExactDistanceTransform
+   */
+  void setUseExactDistanceTransform(bool value);
+  /**
+   * @brief Getter property for UseExactDistanceTransform
+   * @return Value of UseExactDistanceTransform
+   */
+  bool getUseExactDistanceTransform() const;
+  Q_PROPERTY(bool UseExactDistanceTransform READ getUseExactDistanceTransform WRITE setUseExactDistanceTransform)
+
   /**
    * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
@@ -300,6 +312,14 @@ protected:
    */
   void findDistanceMap();
 
+  /**
+   * @brief findExactDistanceMap Computes the exact Euclidean distance of every Cell to the nearest Cell of the given map
+   * with separable passes along X, Y and Z, and stores that Cell as the nearest neighbor
+   * @param mapType Which map to compute
+   * @param distances Output distances of the map; also used to hold the squared distances between passes
+   */
+  void findExactDistanceMap(MapType mapType, float* distances);
+
 private:
   std::weak_ptr<DataArray<int32_t>> m_FeatureIdsPtr;
   int32_t* m_FeatureIds = nullptr;
@@ -328,6 +348,7 @@ private:
   bool m_DoQuadPoints = {false};
   bool m_SaveNearestNeighbors = {false};
   bool m_CalcManhattanDist = {true};
+  bool m_UseExactDistanceTransform = {false};
 
   // Full Euclidean Distance Arrays
 
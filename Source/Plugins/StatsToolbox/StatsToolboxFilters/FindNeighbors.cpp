@@ -35,8 +35,9 @@
 #include "FindNeighbors.h"
 
 #include <algorithm>
+#include <thread>
+#include <unordered_map>
 
-#include <QtCore/QDateTime>
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
@@ -50,6 +51,7 @@
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "StatsToolbox/StatsToolboxConstants.h"
 #include "StatsToolbox/StatsToolboxVersion.h"
@@ -62,6 +64,161 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID32 = 32,
 };
 
+namespace
+{
+// Shared face counts keyed by the (lower Feature Id, higher Feature Id) pair
+using FaceCountMap = std::unordered_map<uint64_t, int32_t>;
+// (Neighbor Feature Id, Number of shared faces)
+using NeighborFaceCount = std::pair<int32_t, int32_t>;
+
+/**
+ * @brief The CountFeatureFacesImpl class counts the faces shared between Features for a set of
+ * voxel chunks. Each chunk gets its own face count table so no locking is needed, and each face
+ * is only counted once from the voxel on its lower side.
+ */
+class CountFeatureFacesImpl
+{
+public:
+  CountFeatureFacesImpl(FindNeighbors* filter, const int32_t* featureIds, const int64_t* dims, const std::vector<int64_t>& chunkBounds, int8_t* boundaryCells,
+                        std::vector<FaceCountMap>& faceCounts, std::vector<std::vector<int32_t>>& surfaceFeatures)
+  : m_Filter(filter)
+  , m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_ChunkBounds(chunkBounds)
+  , m_BoundaryCells(boundaryCells)
+  , m_FaceCounts(faceCounts)
+  , m_SurfaceFeatures(surfaceFeatures)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t sliceStride = m_Dims[0] * m_Dims[1];
+    const int64_t neighpoints[6] = {-sliceStride, -m_Dims[0], -1, 1, m_Dims[0], sliceStride};
+    const bool is2D = (m_Dims[2] == 1);
+
+    for(size_t chunk = start; chunk < end; chunk++)
+    {
+      FaceCountMap& faceCounts = m_FaceCounts[chunk];
+      std::vector<int32_t>& surfaceFeatures = m_SurfaceFeatures[chunk];
+      for(int64_t j = m_ChunkBounds[chunk]; j < m_ChunkBounds[chunk + 1]; j++)
+      {
+        if(j % m_Dims[0] == 0 && m_Filter->getCancel())
+        {
+          return;
+        }
+
+        int8_t onsurf = 0;
+        int32_t feature = m_FeatureIds[j];
+        if(feature > 0)
+        {
+          int64_t column = j % m_Dims[0];
+          int64_t row = (j / m_Dims[0]) % m_Dims[1];
+          int64_t plane = j / sliceStride;
+          bool onGridEdge = column == 0 || column == m_Dims[0] - 1 || row == 0 || row == m_Dims[1] - 1;
+          if(!is2D)
+          {
+            onGridEdge = onGridEdge || plane == 0 || plane == m_Dims[2] - 1;
+          }
+          if(onGridEdge && (surfaceFeatures.empty() || surfaceFeatures.back() != feature))
+          {
+            surfaceFeatures.push_back(feature);
+          }
+
+          for(int32_t k = 0; k < 6; k++)
+          {
+            if((k == 0 && plane == 0) || (k == 5 && plane == (m_Dims[2] - 1)) || (k == 1 && row == 0) || (k == 4 && row == (m_Dims[1] - 1)) || (k == 2 && column == 0) ||
+               (k == 3 && column == (m_Dims[0] - 1)))
+            {
+              continue;
+            }
+            int32_t neighborFeature = m_FeatureIds[j + neighpoints[k]];
+            if(neighborFeature != feature && neighborFeature > 0)
+            {
+              onsurf++;
+              // Faces in the +X, +Y and +Z directions; the others are counted from the neighbor voxel
+              if(k >= 3)
+              {
+                uint64_t lower = static_cast<uint64_t>(std::min(feature, neighborFeature));
+                uint64_t higher = static_cast<uint64_t>(std::max(feature, neighborFeature));
+                faceCounts[(lower << 32) | higher]++;
+              }
+            }
+          }
+        }
+        if(nullptr != m_BoundaryCells)
+        {
+          m_BoundaryCells[j] = onsurf;
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  FindNeighbors* m_Filter = nullptr;
+  const int32_t* m_FeatureIds = nullptr;
+  const int64_t* m_Dims = nullptr;
+  const std::vector<int64_t>& m_ChunkBounds;
+  int8_t* m_BoundaryCells = nullptr;
+  std::vector<FaceCountMap>& m_FaceCounts;
+  std::vector<std::vector<int32_t>>& m_SurfaceFeatures;
+};
+
+/**
+ * @brief The ReduceFeatureFacesImpl class sorts each Feature's row of the compressed sparse row
+ * neighbor table by neighbor Id and merges the duplicate entries that came from different chunks.
+ */
+class ReduceFeatureFacesImpl
+{
+public:
+  ReduceFeatureFacesImpl(const std::vector<int64_t>& offsets, std::vector<NeighborFaceCount>& entries, std::vector<int32_t>& numNeighbors)
+  : m_Offsets(offsets)
+  , m_Entries(entries)
+  , m_NumNeighbors(numNeighbors)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      auto rowBegin = m_Entries.begin() + m_Offsets[i];
+      auto rowEnd = m_Entries.begin() + m_Offsets[i + 1];
+      std::sort(rowBegin, rowEnd);
+      int32_t count = 0;
+      for(auto iter = rowBegin; iter != rowEnd; ++iter)
+      {
+        if(count > 0 && (rowBegin + count - 1)->first == iter->first)
+        {
+          (rowBegin + count - 1)->second += iter->second;
+        }
+        else
+        {
+          *(rowBegin + count) = *iter;
+          count++;
+        }
+      }
+      m_NumNeighbors[i] = count;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const std::vector<int64_t>& m_Offsets;
+  std::vector<NeighborFaceCount>& m_Entries;
+  std::vector<int32_t>& m_NumNeighbors;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -217,7 +374,6 @@ void FindNeighbors::execute()
   }
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
-  AttributeMatrix::Pointer featureAM = m->getAttributeMatrix(getCellFeatureAttributeMatrixPath());
   size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
   size_t totalFeatures = m_NumNeighborsPtr.lock()->getNumberOfTuples();
 
@@ -243,190 +399,113 @@ void FindNeighbors::execute()
       static_cast<int64_t>(udims[2]),
   };
 
-  int64_t neighpoints[6] = {0, 0, 0, 0, 0, 0};
-  neighpoints[0] = -dims[0] * dims[1];
-  neighpoints[1] = -dims[0];
-  neighpoints[2] = -1;
-  neighpoints[3] = 1;
-  neighpoints[4] = dims[0];
-  neighpoints[5] = dims[0] * dims[1];
-
-  int64_t column = 0, row = 0, plane = 0;
-  int32_t feature = 0;
-  int32_t nnum = 0;
-  int8_t onsurf = 0;
-  bool good = false;
-  int64_t neighbor = 0;
-
-  std::vector<std::vector<int32_t>> neighborlist;
-  std::vector<std::vector<float>> neighborsurfacearealist;
-
-  int32_t nListSize = 100;
-  neighborlist.resize(totalFeatures);
-  neighborsurfacearealist.resize(totalFeatures);
-
-  uint64_t millis = QDateTime::currentMSecsSinceEpoch();
-  uint64_t currentMillis = millis;
-
   for(size_t i = 1; i < totalFeatures; i++)
   {
-    currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if(currentMillis - millis > 1000)
-    {
-      QString ss = QObject::tr("Finding Neighbors || Initializing Neighbor Lists || %1% Complete").arg((static_cast<float>(i) / totalFeatures) * 100);
-      notifyStatusMessage(ss);
-      millis = QDateTime::currentMSecsSinceEpoch();
-    }
-
-    if(getCancel())
-    {
-      return;
-    }
-
     m_NumNeighbors[i] = 0;
-    neighborlist[i].resize(nListSize);
-    neighborsurfacearealist[i].assign(nListSize, -1.0f);
     if(m_StoreSurfaceFeatures)
     {
       m_SurfaceFeatures[i] = false;
     }
   }
 
-  for(size_t j = 0; j < totalPoints; j++)
+  // Split the grid into chunks of whole rows. Every chunk collects its own face counts which are
+  // then reduced into a compressed sparse row table of (neighbor, face count) per Feature.
+  const int64_t numRows = dims[1] * dims[2];
+  int64_t numChunks = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  numChunks = std::min(numRows, static_cast<int64_t>(std::max(4U * std::thread::hardware_concurrency(), 1U)));
+#endif
+  std::vector<int64_t> chunkBounds(numChunks + 1, 0);
+  for(int64_t chunk = 0; chunk <= numChunks; chunk++)
   {
-    currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if(currentMillis - millis > 1000)
+    chunkBounds[chunk] = ((chunk * numRows) / numChunks) * dims[0];
+  }
+
+  notifyStatusMessage("Finding Neighbors || Determining Neighbor Lists");
+  std::vector<FaceCountMap> faceCounts(numChunks);
+  std::vector<std::vector<int32_t>> surfaceFeatures(numChunks);
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, static_cast<size_t>(numChunks));
+    dataAlg.execute(CountFeatureFacesImpl(this, m_FeatureIds, dims, chunkBounds, m_StoreBoundaryCells ? m_BoundaryCells : nullptr, faceCounts, surfaceFeatures));
+  }
+  if(getCancel())
+  {
+    return;
+  }
+
+  if(m_StoreSurfaceFeatures)
+  {
+    for(const auto& features : surfaceFeatures)
     {
-      QString ss = QObject::tr("Finding Neighbors || Determining Neighbor Lists || %1% Complete").arg((static_cast<float>(j) / totalPoints) * 100);
-      notifyStatusMessage(ss);
-      millis = QDateTime::currentMSecsSinceEpoch();
+      for(const auto& feature : features)
+      {
+        m_SurfaceFeatures[feature] = true;
+      }
     }
+  }
+  surfaceFeatures.clear();
 
-    if(getCancel())
+  notifyStatusMessage("Finding Neighbors || Calculating Surface Areas");
+  // Each counted face belongs to both Features so it is stored in both rows
+  std::vector<int64_t> offsets(totalFeatures + 1, 0);
+  for(const auto& faceCount : faceCounts)
+  {
+    for(const auto& entry : faceCount)
     {
-      return;
+      offsets[(entry.first >> 32) + 1]++;
+      offsets[(entry.first & 0xFFFFFFFF) + 1]++;
     }
+  }
+  for(size_t i = 1; i <= totalFeatures; i++)
+  {
+    offsets[i] += offsets[i - 1];
+  }
 
-    onsurf = 0;
-    feature = m_FeatureIds[j];
-    if(feature > 0 && feature < neighborlist.size())
+  std::vector<NeighborFaceCount> entries(offsets[totalFeatures]);
+  {
+    std::vector<int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for(auto& faceCount : faceCounts)
     {
-      column = static_cast<int64_t>(j % m->getGeometryAs<ImageGeom>()->getXPoints());
-      row = static_cast<int64_t>((j / m->getGeometryAs<ImageGeom>()->getXPoints()) % m->getGeometryAs<ImageGeom>()->getYPoints());
-      plane = static_cast<int64_t>(j / (m->getGeometryAs<ImageGeom>()->getXPoints() * m->getGeometryAs<ImageGeom>()->getYPoints()));
-      if(m_StoreSurfaceFeatures)
+      for(const auto& entry : faceCount)
       {
-        if((column == 0 || column == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getXPoints() - 1)) || row == 0 ||
-            row == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getYPoints()) - 1) || plane == 0 || plane == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getZPoints() - 1))) &&
-           m->getGeometryAs<ImageGeom>()->getZPoints() != 1)
-        {
-          m_SurfaceFeatures[feature] = true;
-        }
-        if((column == 0 || column == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getXPoints() - 1)) || row == 0 ||
-            row == static_cast<int64_t>((m->getGeometryAs<ImageGeom>()->getYPoints() - 1))) &&
-           m->getGeometryAs<ImageGeom>()->getZPoints() == 1)
-        {
-          m_SurfaceFeatures[feature] = true;
-        }
+        int32_t lower = static_cast<int32_t>(entry.first >> 32);
+        int32_t higher = static_cast<int32_t>(entry.first & 0xFFFFFFFF);
+        entries[cursor[lower]++] = {higher, entry.second};
+        entries[cursor[higher]++] = {lower, entry.second};
       }
-      for(int32_t k = 0; k < 6; k++)
-      {
-        good = true;
-        neighbor = static_cast<int64_t>(j + neighpoints[k]);
-        if(k == 0 && plane == 0)
-        {
-          good = false;
-        }
-        if(k == 5 && plane == (m->getGeometryAs<ImageGeom>()->getZPoints() - 1))
-        {
-          good = false;
-        }
-        if(k == 1 && row == 0)
-        {
-          good = false;
-        }
-        if(k == 4 && row == (m->getGeometryAs<ImageGeom>()->getYPoints() - 1))
-        {
-          good = false;
-        }
-        if(k == 2 && column == 0)
-        {
-          good = false;
-        }
-        if(k == 3 && column == (m->getGeometryAs<ImageGeom>()->getXPoints() - 1))
-        {
-          good = false;
-        }
-        if(good && m_FeatureIds[neighbor] != feature && m_FeatureIds[neighbor] > 0)
-        {
-          onsurf++;
-          nnum = m_NumNeighbors[feature];
-          neighborlist[feature].push_back(m_FeatureIds[neighbor]);
-          nnum++;
-          m_NumNeighbors[feature] = nnum;
-        }
-      }
-    }
-    if(m_StoreBoundaryCells)
-    {
-      m_BoundaryCells[j] = onsurf;
+      FaceCountMap().swap(faceCount);
     }
   }
 
+  std::vector<int32_t> numNeighbors(totalFeatures, 0);
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, totalFeatures);
+    dataAlg.execute(ReduceFeatureFacesImpl(offsets, entries, numNeighbors));
+  }
+
   FloatVec3Type spacing = m->getGeometryAs<ImageGeom>()->getSpacing();
 
   // We do this to create new set of NeighborList objects
   for(size_t i = 1; i < totalFeatures; i++)
   {
-    currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if(currentMillis - millis > 1000)
-    {
-      QString ss = QObject::tr("Finding Neighbors || Calculating Surface Areas || %1% Complete").arg(((float)i / totalFeatures) * 100);
-      notifyStatusMessage(ss);
-      millis = QDateTime::currentMSecsSinceEpoch();
-    }
-
     if(getCancel())
     {
       return;
     }
 
-    QMap<int32_t, int32_t> neighToCount;
-    int32_t numneighs = static_cast<int32_t>(neighborlist[i].size());
+    m_NumNeighbors[i] = numNeighbors[i];
 
-    // this increments the voxel counts for each feature
-    for(int32_t j = 0; j < numneighs; j++)
+    NeighborList<int32_t>::SharedVectorType sharedNeiLst(new std::vector<int32_t>(numNeighbors[i]));
+    NeighborList<float>::SharedVectorType sharedSAL(new std::vector<float>(numNeighbors[i]));
+    for(int32_t j = 0; j < numNeighbors[i]; j++)
     {
-      neighToCount[neighborlist[i][j]]++;
+      const NeighborFaceCount& entry = entries[offsets[i] + j];
+      (*sharedNeiLst)[j] = entry.first;
+      (*sharedSAL)[j] = float(entry.second) * spacing[0] * spacing[1];
     }
-
-    QMap<int32_t, int32_t>::Iterator neighiter = neighToCount.find(0);
-    neighToCount.erase(neighiter);
-    neighiter = neighToCount.find(-1);
-    neighToCount.erase(neighiter);
-    // Resize the features neighbor list to zero
-    neighborlist[i].resize(0);
-    neighborsurfacearealist[i].resize(0);
-
-    for(QMap<int32_t, int32_t>::iterator iter = neighToCount.begin(); iter != neighToCount.end(); ++iter)
-    {
-      int32_t neigh = iter.key();    // get the neighbor feature
-      int32_t number = iter.value(); // get the number of voxels
-      float area = float(number) * spacing[0] * spacing[1];
-
-      // Push the neighbor feature id back onto the list so we stay synced up
-      neighborlist[i].push_back(neigh);
-      neighborsurfacearealist[i].push_back(area);
-    }
-    m_NumNeighbors[i] = int32_t(neighborlist[i].size());
-
-    // Set the vector for each list into the NeighborList Object
-    NeighborList<int32_t>::SharedVectorType sharedNeiLst(new std::vector<int32_t>);
-    sharedNeiLst->assign(neighborlist[i].begin(), neighborlist[i].end());
     m_NeighborList.lock()->setList(static_cast<int32_t>(i), sharedNeiLst);
-
-    NeighborList<float>::SharedVectorType sharedSAL(new std::vector<float>);
-    sharedSAL->assign(neighborsurfacearealist[i].begin(), neighborsurfacearealist[i].end());
     m_SharedSurfaceAreaList.lock()->setList(static_cast<int32_t>(i), sharedSAL);
   }
 }
@@ -35,9 +35,13 @@
 
 #include "FindShapes.h"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <Eigen/Core>
 
@@ -53,6 +57,7 @@
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "EbsdLib/Core/Orientation.hpp"
 #include "EbsdLib/Core/OrientationTransformation.hpp"
@@ -137,6 +142,338 @@ std::array<size_t, 3> TripletSort(T a, T b, T c, bool lowToHigh)
   return idx;
 }
 
+/**
+ * @brief Per feature sums collected by one Z slab: the voxel count followed by the sums of
+ * dx*dx, dy*dy, dz*dz, dx*dy, dy*dz and dx*dz, where d is the offset of the voxel center from
+ * the feature centroid. Only the feature ids that actually occur in the slab are stored, in
+ * increasing order, so the storage follows the features a slab touches rather than their id span.
+ */
+struct SlabMoments
+{
+  static constexpr size_t k_NumSums = 7;
+  std::vector<int32_t> featureIds;
+  std::vector<double> sums;
+};
+
+/**
+ * @brief The AccumulateSlabMomentsImpl class accumulates the second moment sums of every feature
+ * over a set of Z slabs. Each slab writes only its own SlabMoments so the slabs run in parallel.
+ */
+class AccumulateSlabMomentsImpl
+{
+public:
+  AccumulateSlabMomentsImpl(const int32_t* featureIds, const float* centroids, const size_t* dims, const float* modRes, const float* scaledOrigin, float scaleFactor, const size_t* slabBounds,
+                            SlabMoments* slabs)
+  : m_FeatureIds(featureIds)
+  , m_Centroids(centroids)
+  , m_Dims(dims)
+  , m_ModRes(modRes)
+  , m_ScaledOrigin(scaledOrigin)
+  , m_ScaleFactor(scaleFactor)
+  , m_SlabBounds(slabBounds)
+  , m_Slabs(slabs)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    size_t xyPoints = m_Dims[0] * m_Dims[1];
+    for(size_t slab = start; slab < end; slab++)
+    {
+      const int32_t* slabIds = m_FeatureIds + m_SlabBounds[slab] * xyPoints;
+      size_t slabVoxels = (m_SlabBounds[slab + 1] - m_SlabBounds[slab]) * xyPoints;
+      SlabMoments& moments = m_Slabs[slab];
+      if(slabVoxels == 0)
+      {
+        continue;
+      }
+
+      // Sums are appended in the order the features are first met; runs of equal ids skip the lookup
+      std::unordered_map<int32_t, size_t> slots;
+      std::vector<int32_t> ids;
+      std::vector<double> slabSums;
+      int32_t lastFeature = slabIds[0];
+      size_t lastSlot = 0;
+      ids.push_back(lastFeature);
+      slabSums.assign(SlabMoments::k_NumSums, 0.0);
+      slots.emplace(lastFeature, 0);
+
+      for(size_t i = m_SlabBounds[slab]; i < m_SlabBounds[slab + 1]; i++)
+      {
+        float z = float(i * m_ModRes[2]) + m_ScaledOrigin[2];
+        for(size_t j = 0; j < m_Dims[1]; j++)
+        {
+          float y = float(j * m_ModRes[1]) + m_ScaledOrigin[1];
+          const int32_t* rowIds = m_FeatureIds + i * xyPoints + j * m_Dims[0];
+          for(size_t k = 0; k < m_Dims[0]; k++)
+          {
+            int32_t gnum = rowIds[k];
+            float x = float(k * m_ModRes[0]) + m_ScaledOrigin[0];
+            double xdist = static_cast<double>(x - (m_Centroids[gnum * 3 + 0] * m_ScaleFactor));
+            double ydist = static_cast<double>(y - (m_Centroids[gnum * 3 + 1] * m_ScaleFactor));
+            double zdist = static_cast<double>(z - (m_Centroids[gnum * 3 + 2] * m_ScaleFactor));
+            if(gnum != lastFeature)
+            {
+              auto inserted = slots.emplace(gnum, ids.size());
+              if(inserted.second)
+              {
+                ids.push_back(gnum);
+                slabSums.resize(slabSums.size() + SlabMoments::k_NumSums, 0.0);
+              }
+              lastFeature = gnum;
+              lastSlot = inserted.first->second;
+            }
+            double* sums = slabSums.data() + lastSlot * SlabMoments::k_NumSums;
+            sums[0] += 1.0;
+            sums[1] += xdist * xdist;
+            sums[2] += ydist * ydist;
+            sums[3] += zdist * zdist;
+            sums[4] += xdist * ydist;
+            sums[5] += ydist * zdist;
+            sums[6] += xdist * zdist;
+          }
+        }
+      }
+
+      // Store the sums sorted by feature id so they can be merged feature range by feature range
+      std::vector<size_t> order(ids.size());
+      for(size_t n = 0; n < order.size(); n++)
+      {
+        order[n] = n;
+      }
+      std::sort(order.begin(), order.end(), [&ids](size_t lhs, size_t rhs) { return ids[lhs] < ids[rhs]; });
+      moments.featureIds.resize(ids.size());
+      moments.sums.resize(slabSums.size());
+      for(size_t n = 0; n < order.size(); n++)
+      {
+        moments.featureIds[n] = ids[order[n]];
+        std::copy_n(slabSums.data() + order[n] * SlabMoments::k_NumSums, SlabMoments::k_NumSums, moments.sums.data() + n * SlabMoments::k_NumSums);
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  const float* m_Centroids;
+  const size_t* m_Dims;
+  const float* m_ModRes;
+  const float* m_ScaledOrigin;
+  float m_ScaleFactor;
+  const size_t* m_SlabBounds;
+  SlabMoments* m_Slabs;
+};
+
+/**
+ * @brief The FeatureMomentsImpl class merges the slab sums of each feature (always in slab order),
+ * turns them into the moment of inertia tensor, solves its eigen system and computes Omega3. The
+ * features are independent of each other so the eigen solves run as one parallel batch.
+ */
+class FeatureMomentsImpl
+{
+public:
+  FeatureMomentsImpl(const std::vector<SlabMoments>& slabs, const float* modRes, double volumeFactor, double* featureMoments, double* featureEigenVals, float* efVec, float* volumes, float* omega3s)
+  : m_Slabs(slabs)
+  , m_ModRes(modRes)
+  , m_VolumeFactor(volumeFactor)
+  , m_FeatureMoments(featureMoments)
+  , m_FeatureEigenVals(featureEigenVals)
+  , m_EFVec(efVec)
+  , m_Volumes(volumes)
+  , m_Omega3s(omega3s)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    double sphere = (2000.0 * M_PI * M_PI) / 9.0;
+    // constant for moments because voxels are broken into smaller voxels
+    double konst1 = static_cast<double>((m_ModRes[0] / 2.0) * (m_ModRes[1] / 2.0) * (m_ModRes[2] / 2.0));
+    double konst3 = static_cast<double>((m_ModRes[0]) * (m_ModRes[1]) * (m_ModRes[2]));
+    // Each voxel is split into 8 sub-voxels whose centers sit a quarter voxel away from the voxel center
+    // along each axis. Summed over the 8 sub-voxels the offsets cancel out of the cross terms and add
+    // 8 * (quarter voxel)^2 to each squared term, so the sub-voxels never need to be visited one by one.
+    double quarterSq[3] = {0.0, 0.0, 0.0};
+    for(size_t d = 0; d < 3; d++)
+    {
+      quarterSq[d] = static_cast<double>(m_ModRes[d] / 4.0f) * static_cast<double>(m_ModRes[d] / 4.0f);
+    }
+
+    float u200 = 0.0f;
+    float u020 = 0.0f;
+    float u002 = 0.0f;
+    float u110 = 0.0f;
+    float u011 = 0.0f;
+    float u101 = 0.0f;
+    double o3 = 0.0, vol5 = 0.0, omega3 = 0.0;
+
+    // Merge the slab sums of the features in this range, always in slab order
+    std::vector<double> rangeSums((end - start) * SlabMoments::k_NumSums, 0.0);
+    for(const SlabMoments& slab : m_Slabs)
+    {
+      auto first = std::lower_bound(slab.featureIds.begin(), slab.featureIds.end(), static_cast<int32_t>(start));
+      for(auto iter = first; iter != slab.featureIds.end() && *iter < static_cast<int32_t>(end); ++iter)
+      {
+        const double* slabSums = slab.sums.data() + static_cast<size_t>(iter - slab.featureIds.begin()) * SlabMoments::k_NumSums;
+        double* sums = rangeSums.data() + static_cast<size_t>(*iter - static_cast<int32_t>(start)) * SlabMoments::k_NumSums;
+        for(size_t n = 0; n < SlabMoments::k_NumSums; n++)
+        {
+          sums[n] += slabSums[n];
+        }
+      }
+    }
+
+    for(size_t featureId = start; featureId < end; featureId++)
+    {
+      const double* sums = rangeSums.data() + (featureId - start) * SlabMoments::k_NumSums;
+
+      double count = sums[0];
+      double* moments = m_FeatureMoments + featureId * 6;
+      moments[0] = 8.0 * (sums[2] + sums[3] + count * (quarterSq[1] + quarterSq[2]));
+      moments[1] = 8.0 * (sums[1] + sums[3] + count * (quarterSq[0] + quarterSq[2]));
+      moments[2] = 8.0 * (sums[1] + sums[2] + count * (quarterSq[0] + quarterSq[1]));
+      moments[3] = 8.0 * sums[4];
+      moments[4] = 8.0 * sums[5];
+      moments[5] = 8.0 * sums[6];
+      m_Volumes[featureId] = static_cast<float>(count);
+      if(featureId == 0)
+      {
+        continue;
+      }
+
+      // calculating the modified volume for the omega3 value
+      vol5 = m_Volumes[featureId] * konst3;
+      m_Volumes[featureId] = m_Volumes[featureId] * m_VolumeFactor;
+      moments[0] = moments[0] * konst1;
+      moments[1] = moments[1] * konst1;
+      moments[2] = moments[2] * konst1;
+      moments[3] = -moments[3] * konst1;
+      moments[4] = -moments[4] * konst1;
+      moments[5] = -moments[5] * konst1;
+
+      // Now store the 3x3 Matrix for the Eigen Value/Vectors
+      Eigen::Matrix3f moment;
+      // clang-format off
+      moment <<
+        moments[0], moments[3], moments[5],
+        moments[3], moments[1], moments[4],
+        moments[5], moments[4], moments[2];
+      // clang-format on
+      Eigen::EigenSolver<Eigen::Matrix3f> es(moment);
+      Eigen::EigenSolver<Eigen::Matrix3f>::EigenvalueType eigenValues = es.eigenvalues();
+      Eigen::EigenSolver<Eigen::Matrix3f>::EigenvectorsType eigenVectors = es.eigenvectors();
+
+      // Returns the argument order sorted high to low
+      std::array<size_t, 3> idxs = ::TripletSort(eigenValues[0].real(), eigenValues[1].real(), eigenValues[2].real(), false);
+      m_FeatureEigenVals[featureId * 3 + 0] = eigenValues[idxs[0]].real();
+      m_FeatureEigenVals[featureId * 3 + 1] = eigenValues[idxs[1]].real();
+      m_FeatureEigenVals[featureId * 3 + 2] = eigenValues[idxs[2]].real();
+
+      // EigenVector associated with the largest EigenValue goes in the 3rd column, the next largest into
+      // the 2nd column and the smallest into the 1rst column
+      float* efVec = m_EFVec + featureId * 9;
+      for(size_t c = 0; c < 3; c++)
+      {
+        auto col = eigenVectors.col(idxs[c]);
+        efVec[2 - c] = col(0).real();
+        efVec[5 - c] = col(1).real();
+        efVec[8 - c] = col(2).real();
+      }
+
+      // Only for Omega3 below
+      u200 = static_cast<float>((moments[1] + moments[2] - moments[0]) / 2.0f);
+      u020 = static_cast<float>((moments[0] + moments[2] - moments[1]) / 2.0f);
+      u002 = static_cast<float>((moments[0] + moments[1] - moments[2]) / 2.0f);
+      u110 = static_cast<float>(-moments[3]);
+      u011 = static_cast<float>(-moments[4]);
+      u101 = static_cast<float>(-moments[5]);
+      o3 = static_cast<double>((u200 * u020 * u002) + (2.0f * u110 * u101 * u011) - (u200 * u011 * u011) - (u020 * u101 * u101) - (u002 * u110 * u110));
+      vol5 = pow(vol5, 5.0);
+      omega3 = vol5 / o3;
+      omega3 = omega3 / sphere;
+      if(omega3 > 1)
+      {
+        omega3 = 1.0;
+      }
+      if(vol5 == 0.0)
+      {
+        omega3 = 0.0;
+      }
+      m_Omega3s[featureId] = static_cast<float>(omega3);
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const std::vector<SlabMoments>& m_Slabs;
+  const float* m_ModRes;
+  double m_VolumeFactor;
+  double* m_FeatureMoments;
+  double* m_FeatureEigenVals;
+  float* m_EFVec;
+  float* m_Volumes;
+  float* m_Omega3s;
+};
+
+/**
+ * @brief The FindAxisEulersImpl class converts the principal axes of each feature into Euler angles.
+ */
+class FindAxisEulersImpl
+{
+public:
+  FindAxisEulersImpl(const float* efVec, float* axisEulerAngles)
+  : m_EFVec(efVec)
+  , m_AxisEulerAngles(axisEulerAngles)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t featureId = start; featureId < end; featureId++)
+    {
+      // insert principal unit vectors into rotation matrix representing Feature reference frame within the sample reference frame
+      //(Note that the 3 direction is actually the long axis and the 1 direction is actually the short axis)
+      // clang-format off
+      const float* efVec = m_EFVec + featureId * 9;
+      float g[3][3] = {{efVec[0], efVec[3], efVec[6]},
+                       {efVec[1], efVec[4], efVec[7]},
+                       {efVec[2], efVec[5], efVec[8]}};
+      // clang-format on
+
+      // check for right-handedness
+      OrientationTransformation::ResultType result = OrientationTransformation::om_check(OrientationF(g));
+      if(result.result == 0)
+      {
+        g[2][0] *= -1.0f;
+        g[2][1] *= -1.0f;
+        g[2][2] *= -1.0f;
+      }
+
+      OrientationF eu = OrientationTransformation::om2eu<OrientationF, OrientationF>(OrientationF(g));
+
+      m_AxisEulerAngles[3 * featureId] = eu[0];
+      m_AxisEulerAngles[3 * featureId + 1] = eu[1];
+      m_AxisEulerAngles[3 * featureId + 2] = eu[2];
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const float* m_EFVec;
+  float* m_AxisEulerAngles;
+};
 } // namespace
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
@@ -275,188 +612,39 @@ void FindShapes::find_moments()
   FS_DECLARE_REF(FloatArrayType, Volumes, volumes)
   FS_DECLARE_REF(FloatArrayType, Omega3s, omega3s)
 
-  float u200 = 0.0f;
-  float u020 = 0.0f;
-  float u002 = 0.0f;
-  float u110 = 0.0f;
-  float u011 = 0.0f;
-  float u101 = 0.0f;
-  float xx = 0.0f, yy = 0.0f, zz = 0.0f, xy = 0.0f, xz = 0.0f, yz = 0.0f;
-
-  size_t xPoints = imageGeom->getXPoints();
-  size_t yPoints = imageGeom->getYPoints();
-  size_t zPoints = imageGeom->getZPoints();
+  size_t dims[3] = {imageGeom->getXPoints(), imageGeom->getYPoints(), imageGeom->getZPoints()};
   FloatVec3Type spacing = imageGeom->getSpacing();
   FloatVec3Type origin = imageGeom->getOrigin();
 
   // using a modified resolution to keep the moment calculations "small" and prevent exceeding numerical bounds.
   // scaleFactor is applied later to rescale the calculated axis lengths
-  float modXRes = spacing[0] * static_cast<float>(m_ScaleFactor);
-  float modYRes = spacing[1] * static_cast<float>(m_ScaleFactor);
-  float modZRes = spacing[2] * static_cast<float>(m_ScaleFactor);
+  float scaleFactor = static_cast<float>(m_ScaleFactor);
+  float modRes[3] = {spacing[0] * scaleFactor, spacing[1] * scaleFactor, spacing[2] * scaleFactor};
+  float scaledOrigin[3] = {origin[0] * scaleFactor, origin[1] * scaleFactor, origin[2] * scaleFactor};
 
   size_t numfeatures = m_CentroidsPtr.lock()->getNumberOfTuples();
 
-  for(size_t i = 0; i < numfeatures; i++)
+  // Split the volume into a fixed set of Z slabs, each with its own moment sums. The slab layout does not
+  // depend on how the work is scheduled, so the merged sums are the same from run to run.
+  size_t numSlabs = std::min(dims[2], static_cast<size_t>(std::max(1U, std::thread::hardware_concurrency())));
+  std::vector<size_t> slabBounds(numSlabs + 1, 0);
+  for(size_t slab = 0; slab <= numSlabs; slab++)
   {
-    featureMoments[6 * i + 0] = 0.0;
-    featureMoments[6 * i + 1] = 0.0;
-    featureMoments[6 * i + 2] = 0.0;
-    featureMoments[6 * i + 3] = 0.0;
-    featureMoments[6 * i + 4] = 0.0;
-    featureMoments[6 * i + 5] = 0.0;
+    slabBounds[slab] = (dims[2] * slab) / numSlabs;
   }
+  std::vector<SlabMoments> slabs(numSlabs);
 
-  float x = 0.0f, y = 0.0f, z = 0.0f, x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f, z1 = 0.0f, z2 = 0.0f;
-  float xdist1 = 0.0f, xdist2 = 0.0f, xdist3 = 0.0f, xdist4 = 0.0f, xdist5 = 0.0f, xdist6 = 0.0f, xdist7 = 0.0f, xdist8 = 0.0f;
-  float ydist1 = 0.0f, ydist2 = 0.0f, ydist3 = 0.0f, ydist4 = 0.0f, ydist5 = 0.0f, ydist6 = 0.0f, ydist7 = 0.0f, ydist8 = 0.0f;
-  float zdist1 = 0.0f, zdist2 = 0.0f, zdist3 = 0.0f, zdist4 = 0.0f, zdist5 = 0.0f, zdist6 = 0.0f, zdist7 = 0.0f, zdist8 = 0.0f;
-  size_t zStride = 0, yStride = 0;
-  for(size_t i = 0; i < zPoints; i++)
   {
-    zStride = i * xPoints * yPoints;
-    for(size_t j = 0; j < yPoints; j++)
-    {
-      yStride = j * xPoints;
-      for(size_t k = 0; k < xPoints; k++)
-      {
-        int32_t gnum = featureIds[zStride + yStride + k];
-        x = float(k * modXRes) + (origin[0] * static_cast<float>(m_ScaleFactor));
-        y = float(j * modYRes) + (origin[1] * static_cast<float>(m_ScaleFactor));
-        z = float(i * modZRes) + (origin[2] * static_cast<float>(m_ScaleFactor));
-        x1 = x + (modXRes / 4.0f);
-        x2 = x - (modXRes / 4.0f);
-        y1 = y + (modYRes / 4.0f);
-        y2 = y - (modYRes / 4.0f);
-        z1 = z + (modZRes / 4.0f);
-        z2 = z - (modZRes / 4.0f);
-        xdist1 = (x1 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist1 = (y1 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist1 = (z1 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist2 = (x1 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist2 = (y1 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist2 = (z2 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist3 = (x1 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist3 = (y2 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist3 = (z1 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist4 = (x1 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist4 = (y2 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist4 = (z2 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist5 = (x2 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist5 = (y1 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist5 = (z1 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist6 = (x2 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist6 = (y1 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist6 = (z2 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist7 = (x2 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist7 = (y2 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist7 = (z1 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-        xdist8 = (x2 - (centroids[gnum * 3 + 0] * static_cast<float>(m_ScaleFactor)));
-        ydist8 = (y2 - (centroids[gnum * 3 + 1] * static_cast<float>(m_ScaleFactor)));
-        zdist8 = (z2 - (centroids[gnum * 3 + 2] * static_cast<float>(m_ScaleFactor)));
-
-        xx = ((ydist1) * (ydist1)) + ((zdist1) * (zdist1)) + ((ydist2) * (ydist2)) + ((zdist2) * (zdist2)) + ((ydist3) * (ydist3)) + ((zdist3) * (zdist3)) + ((ydist4) * (ydist4)) +
-             ((zdist4) * (zdist4)) + ((ydist5) * (ydist5)) + ((zdist5) * (zdist5)) + ((ydist6) * (ydist6)) + ((zdist6) * (zdist6)) + ((ydist7) * (ydist7)) + ((zdist7) * (zdist7)) +
-             ((ydist8) * (ydist8)) + ((zdist8) * (zdist8));
-        yy = ((xdist1) * (xdist1)) + ((zdist1) * (zdist1)) + ((xdist2) * (xdist2)) + ((zdist2) * (zdist2)) + ((xdist3) * (xdist3)) + ((zdist3) * (zdist3)) + ((xdist4) * (xdist4)) +
-             ((zdist4) * (zdist4)) + ((xdist5) * (xdist5)) + ((zdist5) * (zdist5)) + ((xdist6) * (xdist6)) + ((zdist6) * (zdist6)) + ((xdist7) * (xdist7)) + ((zdist7) * (zdist7)) +
-             ((xdist8) * (xdist8)) + ((zdist8) * (zdist8));
-        zz = ((xdist1) * (xdist1)) + ((ydist1) * (ydist1)) + ((xdist2) * (xdist2)) + ((ydist2) * (ydist2)) + ((xdist3) * (xdist3)) + ((ydist3) * (ydist3)) + ((xdist4) * (xdist4)) +
-             ((ydist4) * (ydist4)) + ((xdist5) * (xdist5)) + ((ydist5) * (ydist5)) + ((xdist6) * (xdist6)) + ((ydist6) * (ydist6)) + ((xdist7) * (xdist7)) + ((ydist7) * (ydist7)) +
-             ((xdist8) * (xdist8)) + ((ydist8) * (ydist8));
-        xy = ((xdist1) * (ydist1)) + ((xdist2) * (ydist2)) + ((xdist3) * (ydist3)) + ((xdist4) * (ydist4)) + ((xdist5) * (ydist5)) + ((xdist6) * (ydist6)) + ((xdist7) * (ydist7)) +
-             ((xdist8) * (ydist8));
-        yz = ((ydist1) * (zdist1)) + ((ydist2) * (zdist2)) + ((ydist3) * (zdist3)) + ((ydist4) * (zdist4)) + ((ydist5) * (zdist5)) + ((ydist6) * (zdist6)) + ((ydist7) * (zdist7)) +
-             ((ydist8) * (zdist8));
-        xz = ((xdist1) * (zdist1)) + ((xdist2) * (zdist2)) + ((xdist3) * (zdist3)) + ((xdist4) * (zdist4)) + ((xdist5) * (zdist5)) + ((xdist6) * (zdist6)) + ((xdist7) * (zdist7)) +
-             ((xdist8) * (zdist8));
-
-        featureMoments[gnum * 6 + 0] = featureMoments[gnum * 6 + 0] + static_cast<double>(xx);
-        featureMoments[gnum * 6 + 1] = featureMoments[gnum * 6 + 1] + static_cast<double>(yy);
-        featureMoments[gnum * 6 + 2] = featureMoments[gnum * 6 + 2] + static_cast<double>(zz);
-        featureMoments[gnum * 6 + 3] = featureMoments[gnum * 6 + 3] + static_cast<double>(xy);
-        featureMoments[gnum * 6 + 4] = featureMoments[gnum * 6 + 4] + static_cast<double>(yz);
-        featureMoments[gnum * 6 + 5] = featureMoments[gnum * 6 + 5] + static_cast<double>(xz);
-        volumes[gnum] = volumes[gnum] + 1.0;
-      }
-    }
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, numSlabs);
+    dataAlg.execute(AccumulateSlabMomentsImpl(featureIds.getPointer(0), centroids.getPointer(0), dims, modRes, scaledOrigin, scaleFactor, slabBounds.data(), slabs.data()));
   }
-  double sphere = (2000.0 * M_PI * M_PI) / 9.0;
-  // constant for moments because voxels are broken into smaller voxels
-  double konst1 = static_cast<double>((modXRes / 2.0) * (modYRes / 2.0) * (modZRes / 2.0));
+
   // constant for volumes because voxels are counted as one
   double konst2 = static_cast<double>((spacing[0]) * (spacing[1]) * (spacing[2]));
-  double konst3 = static_cast<double>((modXRes) * (modYRes) * (modZRes));
-  double o3 = 0.0, vol5 = 0.0, omega3 = 0.0;
-  for(size_t featureId = 1; featureId < numfeatures; featureId++)
-  {
-    // calculating the modified volume for the omega3 value
-    vol5 = volumes[featureId] * konst3;
-    volumes[featureId] = volumes[featureId] * konst2;
-    featureMoments[featureId * 6 + 0] = featureMoments[featureId * 6 + 0] * konst1;
-    featureMoments[featureId * 6 + 1] = featureMoments[featureId * 6 + 1] * konst1;
-    featureMoments[featureId * 6 + 2] = featureMoments[featureId * 6 + 2] * konst1;
-    featureMoments[featureId * 6 + 3] = -featureMoments[featureId * 6 + 3] * konst1;
-    featureMoments[featureId * 6 + 4] = -featureMoments[featureId * 6 + 4] * konst1;
-    featureMoments[featureId * 6 + 5] = -featureMoments[featureId * 6 + 5] * konst1;
-
-    // Now store the 3x3 Matrix for the Eigen Value/Vectors
-    Eigen::Matrix3f moment;
-    // clang-format off
-    moment <<
-      featureMoments[featureId * 6 + 0], featureMoments[featureId * 6 + 3], featureMoments[featureId * 6 + 5],
-      featureMoments[featureId * 6 + 3], featureMoments[featureId * 6 + 1], featureMoments[featureId * 6 + 4],
-      featureMoments[featureId * 6 + 5], featureMoments[featureId * 6 + 4], featureMoments[featureId * 6 + 2];
-    // clang-format on
-    Eigen::EigenSolver<Eigen::Matrix3f> es(moment);
-    Eigen::EigenSolver<Eigen::Matrix3f>::EigenvalueType eigenValues = es.eigenvalues();
-    Eigen::EigenSolver<Eigen::Matrix3f>::EigenvectorsType eigenVectors = es.eigenvectors();
-
-    // Returns the argument order sorted high to low
-    std::array<size_t, 3> idxs = ::TripletSort(eigenValues[0].real(), eigenValues[1].real(), eigenValues[2].real(), false);
-    featureEigenVals[featureId * 3 + 0] = eigenValues[idxs[0]].real();
-    featureEigenVals[featureId * 3 + 1] = eigenValues[idxs[1]].real();
-    featureEigenVals[featureId * 3 + 2] = eigenValues[idxs[2]].real();
-
-    // EigenVector associated with the largest EigenValue goes in the 3rd column
-    auto col = eigenVectors.col(idxs[0]);
-    m_EFVec->setComponent(featureId, 2, col(0).real());
-    m_EFVec->setComponent(featureId, 5, col(1).real());
-    m_EFVec->setComponent(featureId, 8, col(2).real());
-
-    // Then the next largest into the 2nd column
-    col = eigenVectors.col(idxs[1]);
-    m_EFVec->setComponent(featureId, 1, col(0).real());
-    m_EFVec->setComponent(featureId, 4, col(1).real());
-    m_EFVec->setComponent(featureId, 7, col(2).real());
-
-    // The the smallest into the 1rst column
-    col = eigenVectors.col(idxs[2]);
-    m_EFVec->setComponent(featureId, 0, col(0).real());
-    m_EFVec->setComponent(featureId, 3, col(1).real());
-    m_EFVec->setComponent(featureId, 6, col(2).real());
-
-    // Only for Omega3 below
-    u200 = static_cast<float>((featureMoments[featureId * 6 + 1] + featureMoments[featureId * 6 + 2] - featureMoments[featureId * 6 + 0]) / 2.0f);
-    u020 = static_cast<float>((featureMoments[featureId * 6 + 0] + featureMoments[featureId * 6 + 2] - featureMoments[featureId * 6 + 1]) / 2.0f);
-    u002 = static_cast<float>((featureMoments[featureId * 6 + 0] + featureMoments[featureId * 6 + 1] - featureMoments[featureId * 6 + 2]) / 2.0f);
-    u110 = static_cast<float>(-featureMoments[featureId * 6 + 3]);
-    u011 = static_cast<float>(-featureMoments[featureId * 6 + 4]);
-    u101 = static_cast<float>(-featureMoments[featureId * 6 + 5]);
-    o3 = static_cast<double>((u200 * u020 * u002) + (2.0f * u110 * u101 * u011) - (u200 * u011 * u011) - (u020 * u101 * u101) - (u002 * u110 * u110));
-    vol5 = pow(vol5, 5.0);
-    omega3 = vol5 / o3;
-    omega3 = omega3 / sphere;
-    if(omega3 > 1)
-    {
-      omega3 = 1.0;
-    }
-    if(vol5 == 0.0)
-    {
-      omega3 = 0.0;
-    }
-    omega3s[featureId] = static_cast<float>(omega3);
-  }
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0ULL, numfeatures);
+  dataAlg.execute(FeatureMomentsImpl(slabs, modRes, konst2, featureMoments.getPointer(0), featureEigenVals.getPointer(0), m_EFVec->getPointer(0), volumes.getPointer(0), omega3s.getPointer(0)));
 }
 
 // -----------------------------------------------------------------------------
@@ -683,32 +871,13 @@ void FindShapes::find_axiseulers()
   FS_DECLARE_REF(FloatArrayType, AxisEulerAngles, axisEulerAngles)
 
   size_t numfeatures = centroids.getNumberOfTuples();
-  for(size_t featureId = 1; featureId < numfeatures; featureId++)
+  if(numfeatures < 2)
   {
-    // insert principal unit vectors into rotation matrix representing Feature reference frame within the sample reference frame
-    //(Note that the 3 direction is actually the long axis and the 1 direction is actually the short axis)
-    // clang-format off
-    size_t idx = featureId*9;
-    float g[3][3] = {{(*m_EFVec)[idx + 0], (*m_EFVec)[idx + 3], (*m_EFVec)[idx + 6]},
-                     {(*m_EFVec)[idx + 1], (*m_EFVec)[idx + 4], (*m_EFVec)[idx + 7]},
-                     {(*m_EFVec)[idx + 2], (*m_EFVec)[idx + 5], (*m_EFVec)[idx + 8]}};
-    // clang-format on
-
-    // check for right-handedness
-    OrientationTransformation::ResultType result = OrientationTransformation::om_check(OrientationF(g));
-    if(result.result == 0)
-    {
-      g[2][0] *= -1.0f;
-      g[2][1] *= -1.0f;
-      g[2][2] *= -1.0f;
-    }
-
-    OrientationF eu = OrientationTransformation::om2eu<OrientationF, OrientationF>(OrientationF(g));
-
-    axisEulerAngles[3 * featureId] = eu[0];
-    axisEulerAngles[3 * featureId + 1] = eu[1];
-    axisEulerAngles[3 * featureId + 2] = eu[2];
+    return;
   }
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(1ULL, numfeatures);
+  dataAlg.execute(FindAxisEulersImpl(m_EFVec->getPointer(0), axisEulerAngles.getPointer(0)));
 }
 
 // -----------------------------------------------------------------------------
@@ -323,6 +323,112 @@ public:
     return EXIT_SUCCESS;
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void runEuclideanDistMap(DataContainerArray::Pointer dca, bool useExactDistanceTransform, const QString& suffix)
+  {
+    QString filtName = "FindEuclideanDistMap";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer factory = fm->getFactoryFromClassName(filtName);
+    DREAM3D_REQUIRE(factory.get() != nullptr)
+
+    AbstractFilter::Pointer filter = factory->create();
+    DREAM3D_REQUIRE(filter.get() != nullptr)
+
+    filter->setDataContainerArray(dca);
+
+    QVariant var;
+    var.setValue(k_FeatureIdsArrayPath);
+    int err = filter->setProperty("FeatureIdsArrayPath", var);
+    DREAM3D_REQUIRE(err >= 0);
+
+    var.setValue(false);
+    err = filter->setProperty("CalcManhattanDist", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(useExactDistanceTransform);
+    err = filter->setProperty("UseExactDistanceTransform", var);
+    DREAM3D_REQUIRE(err >= 0);
+
+    var.setValue(true);
+    err = filter->setProperty("DoBoundaries", var);
+    DREAM3D_REQUIRE(err >= 0);
+    err = filter->setProperty("DoTripleLines", var);
+    DREAM3D_REQUIRE(err >= 0);
+    err = filter->setProperty("DoQuadPoints", var);
+    DREAM3D_REQUIRE(err >= 0);
+    err = filter->setProperty("SaveNearestNeighbors", var);
+    DREAM3D_REQUIRE(err >= 0);
+
+    var.setValue(QString("GBDistance" + suffix));
+    err = filter->setProperty("GBDistancesArrayName", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(QString("TJDistance" + suffix));
+    err = filter->setProperty("TJDistancesArrayName", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(QString("QPDistance" + suffix));
+    err = filter->setProperty("QPDistancesArrayName", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(QString("NearestNeighbors" + suffix));
+    err = filter->setProperty("NearestNeighborsArrayName", var);
+    DREAM3D_REQUIRE(err >= 0);
+
+    filter->execute();
+    DREAM3D_REQUIRE(filter->getErrorCode() >= 0);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int RunExactDistanceTransformTest()
+  {
+    std::vector<size_t> tDims = {10, 6, 1};
+    DataContainerArray::Pointer dca = initializeDataContainerArray(tDims);
+
+    runEuclideanDistMap(dca, false, "Propagated");
+    runEuclideanDistMap(dca, true, "Exact");
+
+    AttributeMatrix::Pointer am = dca->getAttributeMatrix(k_FeatureIdsArrayPath);
+    Int32ArrayType::Pointer featureIds = am->getAttributeArrayAs<Int32ArrayType>(k_FeatureIdsArrayPath.getDataArrayName());
+    Int32ArrayType::Pointer propagatedNeighbors = am->getAttributeArrayAs<Int32ArrayType>("NearestNeighborsPropagated");
+    Int32ArrayType::Pointer exactNeighbors = am->getAttributeArrayAs<Int32ArrayType>("NearestNeighborsExact");
+    DREAM3D_REQUIRE(propagatedNeighbors.get() != nullptr)
+    DREAM3D_REQUIRE(exactNeighbors.get() != nullptr)
+
+    std::vector<QString> mapNames = {"GBDistance", "TJDistance", "QPDistance"};
+    for(size_t m = 0; m < mapNames.size(); m++)
+    {
+      FloatArrayType::Pointer propagated = am->getAttributeArrayAs<FloatArrayType>(mapNames[m] + "Propagated");
+      FloatArrayType::Pointer exact = am->getAttributeArrayAs<FloatArrayType>(mapNames[m] + "Exact");
+      DREAM3D_REQUIRE(propagated.get() != nullptr)
+      DREAM3D_REQUIRE(exact.get() != nullptr)
+
+      for(size_t i = 0; i < featureIds->getNumberOfTuples(); i++)
+      {
+        float propagatedValue = propagated->getValue(i);
+        float exactValue = exact->getValue(i);
+        int32_t propagatedNeighbor = propagatedNeighbors->getComponent(i, static_cast<int>(m));
+        int32_t exactNeighbor = exactNeighbors->getComponent(i, static_cast<int>(m));
+
+        // Cells outside of a Feature, map Cells and unreached Cells must match exactly
+        if(featureIds->getValue(i) <= 0 || propagatedValue <= 0.0f)
+        {
+          DREAM3D_REQUIRE_EQUAL(exactValue, propagatedValue);
+          DREAM3D_REQUIRE_EQUAL(exactNeighbor, propagatedNeighbor);
+        }
+        // everywhere else the exact distance can only be shorter than the grown one
+        else
+        {
+          DREAM3D_REQUIRE(exactValue >= 0.0f)
+          DREAM3D_REQUIRE(exactValue <= propagatedValue + 1.0E-4f)
+          DREAM3D_REQUIRE(exactNeighbor >= 0)
+        }
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -334,6 +440,7 @@ public:
     DREAM3D_REGISTER_TEST(TestFilterAvailability());
 
     DREAM3D_REGISTER_TEST(RunTest())
+    DREAM3D_REGISTER_TEST(RunExactDistanceTransformTest())
 
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
@@ -40,17 +40,14 @@
 #include "SurfaceMeshing/SurfaceMeshingFilters/FeatureFaceCurvatureFilter.h"
 #include "SurfaceMeshing/SurfaceMeshingFilters/FindNRingNeighbors.h"
 
-#include <Eigen/Dense>
+#include <algorithm>
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-#include <tbb/task.h>
-#include <tbb/task_group.h>
-#endif
+#include <Eigen/Dense>
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-CalculateTriangleGroupCurvatures::CalculateTriangleGroupCurvatures(int64_t nring, std::vector<int64_t> triangleIds, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1,
+CalculateTriangleGroupCurvatures::CalculateTriangleGroupCurvatures(int64_t nring, const std::vector<int64_t>& triangleIds, const std::vector<size_t>& groupOffsets, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1,
                                                                    DoubleArrayType::Pointer principleCurvature2, DoubleArrayType::Pointer principleDirection1,
                                                                    DoubleArrayType::Pointer principleDirection2, DoubleArrayType::Pointer gaussianCurvature, DoubleArrayType::Pointer meanCurvature,
                                                                    DoubleArrayType::Pointer weingartenMatrix, TriangleGeom::Pointer trianglesGeom, DataArray<int32_t>::Pointer surfaceMeshFaceLabels,
@@ -58,6 +55,7 @@ CalculateTriangleGroupCurvatures::CalculateTriangleGroupCurvatures(int64_t nring
                                                                    FeatureFaceCurvatureFilter* parent)
 : m_NRing(nring)
 , m_TriangleIds(triangleIds)
+, m_GroupOffsets(groupOffsets)
 , m_UseNormalsForCurveFitting(useNormalsForCurveFitting)
 , m_PrincipleCurvature1(principleCurvature1)
 , m_PrincipleCurvature2(principleCurvature2)
@@ -72,6 +70,8 @@ CalculateTriangleGroupCurvatures::CalculateTriangleGroupCurvatures(int64_t nring
 , m_SurfaceMeshTriangleCentroids(surfaceMeshTriangleCentroids)
 , m_ParentFilter(parent)
 {
+  // Every copy of this object shares one neighbor finder pool built over one flat vertex to triangle adjacency
+  m_NRingNeighborsPool = std::make_shared<FindNRingNeighborsPool>(std::make_shared<VertexTriangleAdjacency>(*trianglesGeom));
 }
 // -----------------------------------------------------------------------------
 //
@@ -98,229 +98,285 @@ void subtractVector3d(DataArray<double>::Pointer data, double* v)
 // -----------------------------------------------------------------------------
 void CalculateTriangleGroupCurvatures::operator()() const
 {
-  int32_t err = 0;
+  compute(0, m_TriangleIds.size());
+}
 
-  if(m_TriangleIds.size() == 0)
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CalculateTriangleGroupCurvatures::operator()(const tbb::blocked_range<size_t>& r) const
+{
+  compute(r.begin(), r.end());
+}
+#endif
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CalculateTriangleGroupCurvatures::compute(size_t start, size_t end) const
+{
+  if(start >= end)
   {
     return;
   }
 
-  // Instantiate a FindNRingNeighbors class to use during the loop
-  FindNRingNeighbors::Pointer nRingNeighborAlg = FindNRingNeighbors::New();
+  // Borrow a FindNRingNeighbors instance and create the fitting buffers once and reuse them for every triangle in the range
+  FindNRingNeighbors::Pointer nRingNeighborAlg = m_NRingNeighborsPool->acquire();
+  Scratch scratch;
 
   int32_t* faceLabels = m_SurfaceMeshFaceLabels->getPointer(0);
 
-  int32_t* fl = faceLabels + m_TriangleIds[0] * 2;
+  // Find the group holding the first triangle of the range
+  size_t group = static_cast<size_t>(std::upper_bound(m_GroupOffsets.begin(), m_GroupOffsets.end(), start) - m_GroupOffsets.begin()) - 1;
+  size_t groupsCompleted = 0;
   int32_t feature0 = 0;
   int32_t feature1 = 0;
-  if(fl[0] < fl[1])
-  {
-    feature0 = fl[0];
-    feature1 = fl[1];
-  }
-  else
-  {
-    feature0 = fl[1];
-    feature1 = fl[0];
-  }
+  size_t featuresGroup = m_GroupOffsets.size();
 
-  bool computeGaussian = (m_GaussianCurvature.get() != nullptr);
-  bool computeMean = (m_MeanCurvature.get() != nullptr);
-  bool computeDirection = (m_PrincipleDirection1.get() != nullptr);
-  bool computeWeingartenMatrix = (m_WeingartenMatrix.get() != nullptr);
-
-  std::vector<int64_t>::size_type tCount = m_TriangleIds.size();
-  // For each triangle in the group
-  for(std::vector<int64_t>::size_type i = 0; i < tCount; ++i)
+  for(size_t i = start; i < end; ++i)
   {
     if(m_ParentFilter->getCancel())
     {
+      m_NRingNeighborsPool->release(nRingNeighborAlg);
       return;
     }
-    int64_t triId = m_TriangleIds[i];
-    nRingNeighborAlg->setTriangleId(triId);
-    nRingNeighborAlg->setRegionId0(feature0);
-    nRingNeighborAlg->setRegionId1(feature1);
-    nRingNeighborAlg->setRing(m_NRing);
-    err = nRingNeighborAlg->generate(m_TrianglesPtr, faceLabels);
-    Q_ASSERT(err >= 0);
-
-    UniqueFaceIds_t triPatch = nRingNeighborAlg->getNRingTriangles();
-    Q_ASSERT(triPatch.size() > 1);
-
-    size_t beforeSize = triPatch.size();
-    DataArray<double>::Pointer patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
-    // if every triangle got removed because of NaN values in the Normals, then bail from this iteration of the loop
-    if(nullptr == patchNormals)
+    while(m_GroupOffsets[group + 1] <= i)
     {
-      continue;
+      group++;
     }
-    // If something got removed, redo this part again.
-    if(triPatch.size() != beforeSize)
+    if(featuresGroup != group)
     {
-      beforeSize = triPatch.size();
-      patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
+      // Every triangle of a group uses the Feature Ids of the group's first triangle
+      int32_t* fl = faceLabels + m_TriangleIds[m_GroupOffsets[group]] * 2;
+      if(fl[0] < fl[1])
+      {
+        feature0 = fl[0];
+        feature1 = fl[1];
+      }
+      else
+      {
+        feature0 = fl[1];
+        feature1 = fl[0];
+      }
+      featuresGroup = group;
     }
 
-    beforeSize = triPatch.size();
-    DataArray<double>::Pointer patchCentroids = extractPatchData(triId, triPatch, m_SurfaceMeshTriangleCentroids->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Centroids"));
-    // if every triangle got removed because of NaN values in the Normals, then bail from this iteration of the loop
-    if(nullptr == patchCentroids)
-    {
-      continue;
-    }
-    // If something got removed, redo this part again.
-    if(triPatch.size() != beforeSize)
+    computeTriangle(m_TriangleIds[i], feature0, feature1, *nRingNeighborAlg, scratch);
+
+    if(i + 1 == m_GroupOffsets[group + 1])
     {
-      beforeSize = triPatch.size();
-      patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
-      patchCentroids = extractPatchData(triId, triPatch, m_SurfaceMeshTriangleCentroids->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Centroids"));
+      groupsCompleted++;
     }
+  }
+
+  m_NRingNeighborsPool->release(nRingNeighborAlg);
+
+  // Send some feedback
+  m_ParentFilter->sendThreadSafeProgressMessage(end - start, groupsCompleted);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CalculateTriangleGroupCurvatures::computeTriangle(int64_t triId, int32_t feature0, int32_t feature1, FindNRingNeighbors& nRingNeighborAlg, Scratch& scratch) const
+{
+  int32_t err = 0;
+  int32_t* faceLabels = m_SurfaceMeshFaceLabels->getPointer(0);
+
+  bool computeGaussian = (m_GaussianCurvature.get() != nullptr);
+  bool computeMean = (m_MeanCurvature.get() != nullptr);
+  bool computeDirection = (m_PrincipleDirection1.get() != nullptr);
+  bool computeWeingartenMatrix = (m_WeingartenMatrix.get() != nullptr);
+
+  nRingNeighborAlg.setTriangleId(triId);
+  nRingNeighborAlg.setRegionId0(feature0);
+  nRingNeighborAlg.setRegionId1(feature1);
+  nRingNeighborAlg.setRing(m_NRing);
+  err = nRingNeighborAlg.generate(m_TrianglesPtr, faceLabels);
+  Q_ASSERT(err >= 0);
+
+  UniqueFaceIds_t& triPatch = scratch.patch;
+  triPatch.assign(nRingNeighborAlg.getNRingTriangles().begin(), nRingNeighborAlg.getNRingTriangles().end());
+  Q_ASSERT(triPatch.size() > 1);
+
+  size_t beforeSize = triPatch.size();
+  DataArray<double>::Pointer patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
+  // if every triangle got removed because of NaN values in the Normals, then skip this triangle
+  if(nullptr == patchNormals)
+  {
+    return;
+  }
+  // If something got removed, redo this part again.
+  if(triPatch.size() != beforeSize)
+  {
+    beforeSize = triPatch.size();
+    patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
+  }
 
-    // Translate the patch to the 0,0,0 origin
-    double sub[3] = {patchCentroids->getComponent(0, 0), patchCentroids->getComponent(0, 1), patchCentroids->getComponent(0, 2)};
-    subtractVector3d(patchCentroids, sub);
+  beforeSize = triPatch.size();
+  DataArray<double>::Pointer patchCentroids = extractPatchData(triId, triPatch, m_SurfaceMeshTriangleCentroids->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Centroids"));
+  // if every triangle got removed because of NaN values in the Normals, then skip this triangle
+  if(nullptr == patchCentroids)
+  {
+    return;
+  }
+  // If something got removed, redo this part again.
+  if(triPatch.size() != beforeSize)
+  {
+    beforeSize = triPatch.size();
+    patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
+    patchCentroids = extractPatchData(triId, triPatch, m_SurfaceMeshTriangleCentroids->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Centroids"));
+  }
 
-    double np[3] = {patchNormals->getComponent(0, 0), patchNormals->getComponent(0, 1), patchNormals->getComponent(0, 2)};
+  // Translate the patch to the 0,0,0 origin
+  double sub[3] = {patchCentroids->getComponent(0, 0), patchCentroids->getComponent(0, 1), patchCentroids->getComponent(0, 2)};
+  subtractVector3d(patchCentroids, sub);
 
-    double seedCentroid[3] = {patchCentroids->getComponent(0, 0), patchCentroids->getComponent(0, 1), patchCentroids->getComponent(0, 2)};
-    double firstCentroid[3] = {patchCentroids->getComponent(1, 0), patchCentroids->getComponent(1, 1), patchCentroids->getComponent(1, 2)};
+  double np[3] = {patchNormals->getComponent(0, 0), patchNormals->getComponent(0, 1), patchNormals->getComponent(0, 2)};
 
-    double temp[3] = {firstCentroid[0] - seedCentroid[0], firstCentroid[1] - seedCentroid[1], firstCentroid[2] - seedCentroid[2]};
-    double vp[3] = {0.0, 0.0, 0.0};
+  double seedCentroid[3] = {patchCentroids->getComponent(0, 0), patchCentroids->getComponent(0, 1), patchCentroids->getComponent(0, 2)};
+  double firstCentroid[3] = {patchCentroids->getComponent(1, 0), patchCentroids->getComponent(1, 1), patchCentroids->getComponent(1, 2)};
 
-    // Cross Product of np and temp
-    MatrixMath::Normalize3x1(np);
-    MatrixMath::CrossProduct(np, temp, vp);
-    MatrixMath::Normalize3x1(vp);
+  double temp[3] = {firstCentroid[0] - seedCentroid[0], firstCentroid[1] - seedCentroid[1], firstCentroid[2] - seedCentroid[2]};
+  double vp[3] = {0.0, 0.0, 0.0};
 
-    // get the third orthogonal vector
-    double up[3] = {0.0, 0.0, 0.0};
-    MatrixMath::CrossProduct(vp, np, up);
+  // Cross Product of np and temp
+  MatrixMath::Normalize3x1(np);
+  MatrixMath::CrossProduct(np, temp, vp);
+  MatrixMath::Normalize3x1(vp);
 
-    // this constitutes a rotation matrix to a local coordinate system
-    double rot[3][3] = {{up[0], up[1], up[2]}, {vp[0], vp[1], vp[2]}, {np[0], np[1], np[2]}};
-    double out[3] = {0.0, 0.0, 0.0};
-    // Transform all centroids and normals to new coordinate system
-    for(size_t m = 0; m < patchCentroids->getNumberOfTuples(); ++m)
+  // get the third orthogonal vector
+  double up[3] = {0.0, 0.0, 0.0};
+  MatrixMath::CrossProduct(vp, np, up);
+
+  // this constitutes a rotation matrix to a local coordinate system
+  double rot[3][3] = {{up[0], up[1], up[2]}, {vp[0], vp[1], vp[2]}, {np[0], np[1], np[2]}};
+  double out[3] = {0.0, 0.0, 0.0};
+  // Transform all centroids and normals to new coordinate system
+  for(size_t m = 0; m < patchCentroids->getNumberOfTuples(); ++m)
+  {
+    ::memcpy(out, patchCentroids->getPointer(m * 3), 3 * sizeof(double));
+    MatrixMath::Multiply3x3with3x1(rot, patchCentroids->getPointer(m * 3), out);
+    if(std::isnan(out[0]) || std::isnan(out[1]) || std::isnan(out[2]))
     {
-      ::memcpy(out, patchCentroids->getPointer(m * 3), 3 * sizeof(double));
-      MatrixMath::Multiply3x3with3x1(rot, patchCentroids->getPointer(m * 3), out);
-      if(std::isnan(out[0]) || std::isnan(out[1]) || std::isnan(out[2]))
-      {
-        break;
-      }
-      ::memcpy(patchCentroids->getPointer(m * 3), out, 3 * sizeof(double));
+      break;
+    }
+    ::memcpy(patchCentroids->getPointer(m * 3), out, 3 * sizeof(double));
 
-      ::memcpy(out, patchNormals->getPointer(m * 3), 3 * sizeof(double));
-      MatrixMath::Multiply3x3with3x1(rot, patchNormals->getPointer(m * 3), out);
-      ::memcpy(patchNormals->getPointer(m * 3), out, 3 * sizeof(double));
+    ::memcpy(out, patchNormals->getPointer(m * 3), 3 * sizeof(double));
+    MatrixMath::Multiply3x3with3x1(rot, patchNormals->getPointer(m * 3), out);
+    ::memcpy(patchNormals->getPointer(m * 3), out, 3 * sizeof(double));
 
-      // We rotate the normals now but we dont use them yet. If we start using part 3 of Goldfeathers paper then we
-      // will need the normals.
-    }
+    // We rotate the normals now but we dont use them yet. If we start using part 3 of Goldfeathers paper then we
+    // will need the normals.
+  }
 
+  {
+    // Solve the Least Squares fit
+    static const uint32_t NO_NORMALS = 3;
+    static const uint32_t USE_NORMALS = 7;
+    uint32_t cols = NO_NORMALS;
+    if(m_UseNormalsForCurveFitting == true)
     {
-      // Solve the Least Squares fit
-      static const uint32_t NO_NORMALS = 3;
-      static const uint32_t USE_NORMALS = 7;
-      uint32_t cols = NO_NORMALS;
-      if(m_UseNormalsForCurveFitting == true)
-      {
-        cols = USE_NORMALS;
-      }
-      size_t rows = patchCentroids->getNumberOfTuples();
-      Eigen::MatrixXd A(rows, cols);
-      Eigen::VectorXd b(rows);
-      double x = 0.0, y = 0.0, z = 0.0;
-      for(size_t m = 0; m < rows; ++m)
+      cols = USE_NORMALS;
+    }
+    size_t rows = patchCentroids->getNumberOfTuples();
+    // The fit is assembled in buffers that only grow, so most triangles need no new allocation
+    if(scratch.a.size() < rows * cols)
+    {
+      scratch.a.resize(rows * cols);
+    }
+    if(scratch.b.size() < rows)
+    {
+      scratch.b.resize(rows);
+    }
+    Eigen::Map<Eigen::MatrixXd> A(scratch.a.data(), rows, cols);
+    Eigen::Map<Eigen::VectorXd> b(scratch.b.data(), rows);
+    double x = 0.0, y = 0.0, z = 0.0;
+    for(size_t m = 0; m < rows; ++m)
+    {
+      x = patchCentroids->getComponent(m, 0);
+      y = patchCentroids->getComponent(m, 1);
+      z = patchCentroids->getComponent(m, 2);
+
+      A(m) = 0.5 * x * x;            // 1/2 x^2
+      A(m + rows) = x * y;           // x*y
+      A(m + rows * 2) = 0.5 * y * y; // 1/2 y^2
+      if(m_UseNormalsForCurveFitting)
       {
-        x = patchCentroids->getComponent(m, 0);
-        y = patchCentroids->getComponent(m, 1);
-        z = patchCentroids->getComponent(m, 2);
-
-        A(m) = 0.5 * x * x;            // 1/2 x^2
-        A(m + rows) = x * y;           // x*y
-        A(m + rows * 2) = 0.5 * y * y; // 1/2 y^2
-        if(m_UseNormalsForCurveFitting)
-        {
-          A(m + rows * 3) = x * x * x;
-          A(m + rows * 4) = x * x * y;
-          A(m + rows * 5) = x * y * y;
-          A(m + rows * 6) = y * y * y;
-        }
-        b[m] = z; // The Z Values
+        A(m + rows * 3) = x * x * x;
+        A(m + rows * 4) = x * x * y;
+        A(m + rows * 5) = x * y * y;
+        A(m + rows * 6) = y * y * y;
       }
+      b[m] = z; // The Z Values
+    }
 
-      Eigen::Matrix2d M;
-
-      if(!m_UseNormalsForCurveFitting)
-      {
-        typedef Eigen::Matrix<double, NO_NORMALS, 1> Vector3d;
-        Vector3d sln1 = A.colPivHouseholderQr().solve(b);
-        // Now that we have the A, B, C constants we can solve the Eigen value/vector problem
-        // to get the principal curvatures and principal directions.
-        M << sln1(0), sln1(1), sln1(1), sln1(2);
-      }
-      else
-      {
-        typedef Eigen::Matrix<double, USE_NORMALS, 1> Vector7d;
-        Vector7d sln1 = A.colPivHouseholderQr().solve(b);
-        // Now that we have the A, B, C, D, E, F & G constants we can solve the Eigen value/vector problem
-        // to get the principal curvatures and pricipal directions.
-        M << sln1(0), sln1(1), sln1(1), sln1(2);
-      }
+    Eigen::Matrix2d M;
 
-      if(computeWeingartenMatrix)
-      {
-        m_WeingartenMatrix->setComponent(triId, 0, M.coeff(0, 0));
-        m_WeingartenMatrix->setComponent(triId, 1, M.coeff(0, 1));
-        m_WeingartenMatrix->setComponent(triId, 2, M.coeff(1, 0));
-        m_WeingartenMatrix->setComponent(triId, 3, M.coeff(1, 1));
-      }
+    if(!m_UseNormalsForCurveFitting)
+    {
+      typedef Eigen::Matrix<double, NO_NORMALS, 1> Vector3d;
+      Vector3d sln1 = scratch.qr.compute(A).solve(b);
+      // Now that we have the A, B, C constants we can solve the Eigen value/vector problem
+      // to get the principal curvatures and principal directions.
+      M << sln1(0), sln1(1), sln1(1), sln1(2);
+    }
+    else
+    {
+      typedef Eigen::Matrix<double, USE_NORMALS, 1> Vector7d;
+      Vector7d sln1 = scratch.qr.compute(A).solve(b);
+      // Now that we have the A, B, C, D, E, F & G constants we can solve the Eigen value/vector problem
+      // to get the principal curvatures and pricipal directions.
+      M << sln1(0), sln1(1), sln1(1), sln1(2);
+    }
 
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> eig(M);
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::RealVectorType eValues = eig.eigenvalues();
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::MatrixType eVectors = eig.eigenvectors();
+    if(computeWeingartenMatrix)
+    {
+      m_WeingartenMatrix->setComponent(triId, 0, M.coeff(0, 0));
+      m_WeingartenMatrix->setComponent(triId, 1, M.coeff(0, 1));
+      m_WeingartenMatrix->setComponent(triId, 2, M.coeff(1, 0));
+      m_WeingartenMatrix->setComponent(triId, 3, M.coeff(1, 1));
+    }
 
-      // Kappa1 >= Kappa2
-      double kappa1 = eValues(0) * -1; // Kappa 1
-      double kappa2 = eValues(1) * -1; // kappa 2
-      Q_ASSERT(kappa1 >= kappa2);
-      m_PrincipleCurvature1->setValue(triId, kappa1);
-      m_PrincipleCurvature2->setValue(triId, kappa2);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> eig(M);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::RealVectorType eValues = eig.eigenvalues();
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::MatrixType eVectors = eig.eigenvectors();
 
-      if(computeGaussian)
-      {
-        m_GaussianCurvature->setValue(triId, kappa1 * kappa2);
-      }
-      if(computeMean)
-      {
-        m_MeanCurvature->setValue(triId, (kappa1 + kappa2) / 2.0);
-      }
+    // Kappa1 >= Kappa2
+    double kappa1 = eValues(0) * -1; // Kappa 1
+    double kappa2 = eValues(1) * -1; // kappa 2
+    Q_ASSERT(kappa1 >= kappa2);
+    m_PrincipleCurvature1->setValue(triId, kappa1);
+    m_PrincipleCurvature2->setValue(triId, kappa2);
 
-      if(computeDirection)
-      {
-        Eigen::Matrix3d e_rot_T;
-        e_rot_T.row(0) = Eigen::Vector3d(up[0], vp[0], np[0]);
-        e_rot_T.row(1) = Eigen::Vector3d(up[1], vp[1], np[1]);
-        e_rot_T.row(2) = Eigen::Vector3d(up[2], vp[2], np[2]);
-
-        // Rotate our principal directions back into the original coordinate system
-        Eigen::Vector3d dir1(eVectors.col(0)(0), eVectors.col(0)(1), 0.0);
-        dir1 = e_rot_T * dir1;
-        ::memcpy(m_PrincipleDirection1->getPointer(triId * 3), dir1.data(), 3 * sizeof(double));
-
-        Eigen::Vector3d dir2(eVectors.col(1)(0), eVectors.col(1)(1), 0.0);
-        dir2 = e_rot_T * dir2;
-        ::memcpy(m_PrincipleDirection2->getPointer(triId * 3), dir2.data(), 3 * sizeof(double));
-      }
+    if(computeGaussian)
+    {
+      m_GaussianCurvature->setValue(triId, kappa1 * kappa2);
+    }
+    if(computeMean)
+    {
+      m_MeanCurvature->setValue(triId, (kappa1 + kappa2) / 2.0);
     }
 
-  } // End Loop over this triangle
-
-  // Send some feedback
-  m_ParentFilter->sendThreadSafeProgressMessage(m_TriangleIds.size(), tCount);
+    if(computeDirection)
+    {
+      Eigen::Matrix3d e_rot_T;
+      e_rot_T.row(0) = Eigen::Vector3d(up[0], vp[0], np[0]);
+      e_rot_T.row(1) = Eigen::Vector3d(up[1], vp[1], np[1]);
+      e_rot_T.row(2) = Eigen::Vector3d(up[2], vp[2], np[2]);
+
+      // Rotate our principal directions back into the original coordinate system
+      Eigen::Vector3d dir1(eVectors.col(0)(0), eVectors.col(0)(1), 0.0);
+      dir1 = e_rot_T * dir1;
+      ::memcpy(m_PrincipleDirection1->getPointer(triId * 3), dir1.data(), 3 * sizeof(double));
+
+      Eigen::Vector3d dir2(eVectors.col(1)(0), eVectors.col(1)(1), 0.0);
+      dir2 = e_rot_T * dir2;
+      ::memcpy(m_PrincipleDirection2->getPointer(triId * 3), dir2.data(), 3 * sizeof(double));
+    }
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -337,7 +393,7 @@ DataArray<double>::Pointer CalculateTriangleGroupCurvatures::extractPatchData(in
     if(std::isnan(data[t * 3]) || std::isnan(data[t * 3 + 1]) || std::isnan(data[t * 3 + 2]))
     {
       iter = triPatch.erase(iter);
-      if(*iter == triId)
+      if(iter != triPatch.end() && *iter == triId)
       {
         triId = *(triPatch.begin());
       }
@@ -353,8 +409,10 @@ DataArray<double>::Pointer CalculateTriangleGroupCurvatures::extractPatchData(in
     return DoubleArrayType::NullPointer();
   }
 
+  auto seedIter = std::lower_bound(triPatch.begin(), triPatch.end(), triId);
+  bool hasSeed = (seedIter != triPatch.end() && *seedIter == triId);
   size_t totalTuples = triPatch.size();
-  if(triPatch.count(triId) == 0)
+  if(!hasSeed)
   {
     totalTuples++;
   }
@@ -367,15 +425,20 @@ DataArray<double>::Pointer CalculateTriangleGroupCurvatures::extractPatchData(in
   extractedData->setComponent(i, 1, data[triId * 3 + 1]);
   extractedData->setComponent(i, 2, data[triId * 3 + 2]);
   ++i;
-  triPatch.erase(triId);
 
-  for(UniqueFaceIds_t::iterator iter = triPatch.begin(); iter != triPatch.end(); ++iter)
+  for(int64_t t : triPatch)
   {
-    int64_t t = *iter;
+    if(t == triId)
+    {
+      continue;
+    }
     extractedData->setTuple(i, data + (t * 3));
     ++i;
   }
-  triPatch.insert(triId);
+  if(!hasSeed)
+  {
+    triPatch.insert(seedIter, triId);
+  }
 
   extractedData->resizeTuples(triPatch.size()); // Resize the TriPatch DataArray
   return extractedData;
@@ -35,24 +35,35 @@
 
 #pragma once
 
-#include <set>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
 #include "SIMPLib/Filtering/AbstractFilter.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#endif
+
 class FeatureFaceCurvatureFilter;
+class FindNRingNeighbors;
+class FindNRingNeighborsPool;
 
 /**
- * @brief The CalculateTriangleGroupCurvatures class calculates the curvature values for a group of triangles
+ * @brief The CalculateTriangleGroupCurvatures class calculates the curvature values for groups of triangles
  * where each triangle in the group will have the 2 Principal Curvature values computed and optionally
- * the 2 Principal Directions and optionally the Mean and Gaussian Curvature computed.
+ * the 2 Principal Directions and optionally the Mean and Gaussian Curvature computed. The triangles of all the
+ * groups are stored back to back in triangleIds and group i covers [groupOffsets[i], groupOffsets[i + 1]), so any
+ * range of triangles can be computed on its own no matter how the groups are sized.
  */
 class CalculateTriangleGroupCurvatures
 {
 public:
-  CalculateTriangleGroupCurvatures(int64_t nring, std::vector<int64_t> triangleIds, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1,
+  CalculateTriangleGroupCurvatures(int64_t nring, const std::vector<int64_t>& triangleIds, const std::vector<size_t>& groupOffsets, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1,
                                    DoubleArrayType::Pointer principleCurvature2, DoubleArrayType::Pointer principleDirection1, DoubleArrayType::Pointer principleDirection2,
                                    DoubleArrayType::Pointer gaussianCurvature, DoubleArrayType::Pointer meanCurvature, DoubleArrayType::Pointer weingartenMatrix, TriangleGeom::Pointer trianglesGeom,
                                    DataArray<int32_t>::Pointer surfaceMeshFaceLabels, DataArray<double>::Pointer surfaceMeshFaceNormals, DataArray<double>::Pointer surfaceMeshTriangleCentroids,
@@ -60,17 +71,49 @@ public:
 
   virtual ~CalculateTriangleGroupCurvatures();
 
+  /**
+   * @brief Computes the curvatures of the triangles at positions [start, end) of triangleIds
+   * @param start
+   * @param end
+   */
+  void compute(size_t start, size_t end) const;
+
   void operator()() const;
 
-  typedef std::set<int64_t> UniqueFaceIds_t;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const;
+#endif
+
+  typedef std::vector<int64_t> UniqueFaceIds_t;
 
 protected:
   CalculateTriangleGroupCurvatures();
 
+  /**
+   * @brief The Scratch struct holds the buffers that are reused from one triangle to the next
+   */
+  struct Scratch
+  {
+    UniqueFaceIds_t patch;
+    std::vector<double> a;
+    std::vector<double> b;
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr;
+  };
+
+  /**
+   * @brief computeTriangle Fits the patch around one triangle and stores its curvature values
+   * @param triId The seed triangle Id
+   * @param feature0 The smaller of the two Feature Ids of the triangle's group
+   * @param feature1 The larger of the two Feature Ids of the triangle's group
+   * @param nRingNeighborAlg The neighbor finder to use
+   * @param scratch The buffers to use
+   */
+  void computeTriangle(int64_t triId, int32_t feature0, int32_t feature1, FindNRingNeighbors& nRingNeighborAlg, Scratch& scratch) const;
+
   /**
    * @brief extractPatchData Extracts out the needed data values from the global arrays
    * @param triId The seed triangle Id
-   * @param triPatch The group of triangles being used
+   * @param triPatch The sorted group of triangles being used
    * @param data The data to extract from
    * @param name The name of the data array being used
    * @return Shared pointer to the extracted data
@@ -79,7 +122,8 @@ protected:
 
 private:
   int64_t m_NRing;
-  std::vector<int64_t> m_TriangleIds;
+  const std::vector<int64_t>& m_TriangleIds;
+  const std::vector<size_t>& m_GroupOffsets;
   bool m_UseNormalsForCurveFitting;
   DoubleArrayType::Pointer m_PrincipleCurvature1;
   DoubleArrayType::Pointer m_PrincipleCurvature2;
@@ -93,4 +137,5 @@ private:
   DataArray<double>::Pointer m_SurfaceMeshFaceNormals;
   DataArray<double>::Pointer m_SurfaceMeshTriangleCentroids;
   FeatureFaceCurvatureFilter* m_ParentFilter;
+  std::shared_ptr<FindNRingNeighborsPool> m_NRingNeighborsPool;
 };
@@ -50,11 +50,13 @@
 
 #include "CalculateTriangleGroupCurvatures.h"
 
+#include <algorithm>
 #include <mutex>
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-#include <tbb/task.h>
-#include <tbb/task_group.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
 #endif
 
 // -----------------------------------------------------------------------------
@@ -333,17 +335,6 @@ void FeatureFaceCurvatureFilter::execute()
   // Just to double check we have everything.
   int64_t numTriangles = triangleGeom->getNumberOfTris();
 
-  // Make sure the Face Connectivity is created because the FindNRing algorithm needs this and will
-  // assert if the data is NOT in the SurfaceMesh Data Container
-  ElementDynamicList::Pointer vertLinks = triangleGeom->getElementsContainingVert();
-  if(nullptr == vertLinks.get())
-  {
-    triangleGeom->findElementsContainingVert();
-  }
-
-  // get the QMap from the SharedFeatureFaces filter
-  SharedFeatureFaces_t sharedFeatureFaces;
-
   int32_t maxFaceId = 0;
   for(int64_t t = 0; t < numTriangles; ++t)
   {
@@ -352,91 +343,75 @@ void FeatureFaceCurvatureFilter::execute()
       maxFaceId = m_SurfaceMeshFeatureFaceIds[t];
     }
   }
-  std::vector<int32_t> faceSizes(maxFaceId + 1, 0);
-  // Loop through all the Triangles and assign each one to a unique Feature Face Id.
+
+  // Lay the triangles out back to back grouped by Feature Face, keeping their order inside each face. Face i
+  // covers [faceOffsets[i], faceOffsets[i + 1]) of faceTriangleIds.
+  std::vector<size_t> faceOffsets(maxFaceId + 2, 0);
   for(int64_t t = 0; t < numTriangles; ++t)
   {
-    faceSizes[m_SurfaceMeshFeatureFaceIds[t]]++;
+    faceOffsets[m_SurfaceMeshFeatureFaceIds[t] + 1]++;
   }
-
-  // Allocate all the vectors that we need
-  for(size_t iter = 0; iter < faceSizes.size(); ++iter)
+  for(size_t i = 1; i < faceOffsets.size(); ++i)
   {
-    FaceIds_t v;
-    v.reserve(faceSizes[iter]);
-    sharedFeatureFaces[iter] = v;
+    faceOffsets[i] += faceOffsets[i - 1];
   }
-
-  // Loop through all the Triangles and assign each one to a unique Feature Face Id.
-  for(int64_t t = 0; t < numTriangles; ++t)
+  FaceIds_t faceTriangleIds(numTriangles);
   {
-    sharedFeatureFaces[m_SurfaceMeshFeatureFaceIds[t]].push_back(t);
+    std::vector<size_t> fill(faceOffsets.begin(), faceOffsets.end() - 1);
+    for(int64_t t = 0; t < numTriangles; ++t)
+    {
+      faceTriangleIds[fill[m_SurfaceMeshFeatureFaceIds[t]]++] = t;
+    }
   }
 
-  m_TotalFeatureFaces = sharedFeatureFaces.size();
+  m_TotalFeatureFaces = 0;
+  for(size_t i = 0; i + 1 < faceOffsets.size(); ++i)
+  {
+    if(faceOffsets[i + 1] > faceOffsets[i])
+    {
+      m_TotalFeatureFaces++;
+    }
+  }
   m_CompletedFeatureFaces = 0;
   m_TotalTriangles = numTriangles;
-  QString ss;
+  setTotalCompleted(0);
+  QString ss = QObject::tr("Computing curvatures for %1 triangles on %2 Feature Faces....").arg(numTriangles).arg(m_TotalFeatureFaces);
+  notifyStatusMessage(ss);
+
+  CalculateTriangleGroupCurvatures curvature(m_NRing, faceTriangleIds, faceOffsets, m_UseNormalsForCurveFitting, m_SurfaceMeshPrincipalCurvature1sPtr.lock(), m_SurfaceMeshPrincipalCurvature2sPtr.lock(),
+                                             m_SurfaceMeshPrincipalDirection1sPtr.lock(), m_SurfaceMeshPrincipalDirection2sPtr.lock(), m_SurfaceMeshGaussianCurvaturesPtr.lock(),
+                                             m_SurfaceMeshMeanCurvaturesPtr.lock(), m_SurfaceMeshWeingartenMatrixPtr.lock(), triangleGeom, m_SurfaceMeshFaceLabelsPtr.lock(),
+                                             m_SurfaceMeshFaceNormalsPtr.lock(), m_SurfaceMeshTriangleCentroidsPtr.lock(), this);
 
 /*********************************
- * We are going to specfically invoke TBB directly instead of using ParallelTaskAlgorithm since we can just queue up all
- * the tasks while the first tasks start up. TBB will then grab a new task from it's own queue to work on it up to the
- * number of hardware limit of the machine. If we use ParallelTaskAlgorithm then at most we can only work on the number
- * of tasks that equal the number of cores on the machine. We spend a lot of overhead spinning up new threads to do each
- * task. This takes much longer (3x longer) in some cases
+ * Every triangle costs about the same to fit (its patch size only depends on the ring count), so instead of one
+ * task per Feature Face the triangles of all the faces are split into ranges of roughly equal work. Small faces
+ * end up sharing a range, large faces are spread over many ranges, and idle threads steal the remaining ranges.
  */
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  std::shared_ptr<tbb::task_group> g(new tbb::task_group);
-  ss = QObject::tr("Adding %1 Feature Faces to the work queue....").arg(maxFaceId);
-  notifyStatusMessage(ss);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, faceTriangleIds.size(), 64), curvature, tbb::auto_partitioner());
 #else
-
-#endif
-  // typedef here for conveneince
-  typedef SharedFeatureFaces_t::iterator SharedFeatureFaceIterator_t;
-  for(SharedFeatureFaceIterator_t iter = sharedFeatureFaces.begin(); iter != sharedFeatureFaces.end(); ++iter)
+  // Work through the triangles in pieces so the progress messages keep coming
+  for(size_t start = 0; start < faceTriangleIds.size(); start += 4096)
   {
-    FaceIds_t& triangleIds = (*iter).second;
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-    {
-      g->run(CalculateTriangleGroupCurvatures(m_NRing, triangleIds, m_UseNormalsForCurveFitting, m_SurfaceMeshPrincipalCurvature1sPtr.lock(), m_SurfaceMeshPrincipalCurvature2sPtr.lock(),
-                                              m_SurfaceMeshPrincipalDirection1sPtr.lock(), m_SurfaceMeshPrincipalDirection2sPtr.lock(), m_SurfaceMeshGaussianCurvaturesPtr.lock(),
-                                              m_SurfaceMeshMeanCurvaturesPtr.lock(), m_SurfaceMeshWeingartenMatrixPtr.lock(), triangleGeom, m_SurfaceMeshFaceLabelsPtr.lock(),
-                                              m_SurfaceMeshFaceNormalsPtr.lock(), m_SurfaceMeshTriangleCentroidsPtr.lock(), this));
-    }
-#else
-    ss = QObject::tr("Working on Face Id %1/%2").arg((*iter).first).arg(maxFaceId);
-    notifyStatusMessage(ss);
-    {
-      CalculateTriangleGroupCurvatures curvature(m_NRing, triangleIds, m_UseNormalsForCurveFitting, m_SurfaceMeshPrincipalCurvature1sPtr.lock(), m_SurfaceMeshPrincipalCurvature2sPtr.lock(),
-                                                 m_SurfaceMeshPrincipalDirection1sPtr.lock(), m_SurfaceMeshPrincipalDirection2sPtr.lock(), m_SurfaceMeshGaussianCurvaturesPtr.lock(),
-                                                 m_SurfaceMeshMeanCurvaturesPtr.lock(), m_SurfaceMeshWeingartenMatrixPtr.lock(), triangleGeom, m_SurfaceMeshFaceLabelsPtr.lock(),
-                                                 m_SurfaceMeshFaceNormalsPtr.lock(), m_SurfaceMeshTriangleCentroidsPtr.lock(), this);
-      curvature();
-    }
-#endif
+    curvature.compute(start, std::min(faceTriangleIds.size(), start + 4096));
   }
-
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  ss = QObject::tr("Waiting on computations to complete.");
-  notifyStatusMessage(ss);
-  g->wait(); // Wait for all the threads to complete before moving on.
 #endif
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void FeatureFaceCurvatureFilter::sendThreadSafeProgressMessage(size_t numCompleted, size_t totalFeatures)
+void FeatureFaceCurvatureFilter::sendThreadSafeProgressMessage(size_t numCompleted, size_t numFeatureFacesCompleted)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lock(mutex);
   qint64 currentMillis = QDateTime::currentMSecsSinceEpoch();
   setTotalCompleted(getTotalCompleted() + numCompleted);
-  m_CompletedFeatureFaces++;
+  m_CompletedFeatureFaces += static_cast<int32_t>(numFeatureFacesCompleted);
   if(currentMillis - getMillis() > 1000)
   {
-    // auto percentage = static_cast<int>(100 * (static_cast<float>(getTotalCompleted()) / static_cast<float>(totalFeatures)));
+    // auto percentage = static_cast<int>(100 * (static_cast<float>(getTotalCompleted()) / static_cast<float>(m_TotalTriangles)));
     QString ss = QObject::tr("Features Completed: %1/%2  Triangles Visited: %3/%4").arg(m_CompletedFeatureFaces).arg(m_TotalFeatureFaces).arg(getTotalCompleted()).arg(m_TotalTriangles);
     notifyStatusMessage(ss);
     setMillis(QDateTime::currentMSecsSinceEpoch());
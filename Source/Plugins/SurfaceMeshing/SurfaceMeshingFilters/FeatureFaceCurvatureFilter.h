@@ -372,8 +372,10 @@ public:
 
   /**
    * @brief Used to send progress messages to this filter from the processing threads
+   * @param numCompleted The number of triangles just computed
+   * @param numFeatureFacesCompleted The number of Feature Faces whose last triangle was among them
   */
-  void sendThreadSafeProgressMessage(size_t numCompleted, size_t totalFeatures);
+  void sendThreadSafeProgressMessage(size_t numCompleted, size_t numFeatureFacesCompleted);
 
   /**
    * @brief Gets the Filter Parameter value for TotalCompleted
@@ -34,10 +34,43 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindNRingNeighbors.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include <QtCore/QDebug>
 
 #include "SIMPLib/Geometry/TriangleGeom.h"
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+VertexTriangleAdjacency::VertexTriangleAdjacency(TriangleGeom& triangleGeom)
+{
+  MeshIndexType* triangles = triangleGeom.getTriPointer(0);
+  size_t numTriangles = triangleGeom.getNumberOfTris();
+  size_t numVertices = triangleGeom.getNumberOfVertices();
+
+  m_Offsets.assign(numVertices + 1, 0);
+  for(size_t i = 0; i < numTriangles * 3; ++i)
+  {
+    m_Offsets[triangles[i] + 1]++;
+  }
+  for(size_t v = 0; v < numVertices; ++v)
+  {
+    m_Offsets[v + 1] += m_Offsets[v];
+  }
+
+  m_Triangles.resize(m_Offsets[numVertices]);
+  std::vector<size_t> fill(m_Offsets.begin(), m_Offsets.end() - 1);
+  for(size_t t = 0; t < numTriangles; ++t)
+  {
+    for(size_t i = 0; i < 3; ++i)
+    {
+      m_Triangles[fill[triangles[t * 3 + i]]++] = t;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -77,15 +110,10 @@ int32_t FindNRingNeighbors::generate(TriangleGeom::Pointer triangleGeom, int32_t
   m_NRingTriangles.clear();
 
   // Make sure we have the proper connectivity built
-  ElementDynamicList::Pointer node2TrianglePtr = triangleGeom->getElementsContainingVert();
-  if(node2TrianglePtr.get() == nullptr)
+  if(nullptr == m_Adjacency || (nullptr != m_AdjacencyGeom && m_AdjacencyGeom != triangleGeom.get()))
   {
-    err = triangleGeom->findElementsContainingVert();
-    if(err < 0)
-    {
-      return err;
-    }
-    node2TrianglePtr = triangleGeom->getElementsContainingVert();
+    m_Adjacency = std::make_shared<VertexTriangleAdjacency>(*triangleGeom);
+    m_AdjacencyGeom = triangleGeom.get();
   }
 
   // Figure out these boolean values for a sanity check
@@ -102,38 +130,40 @@ int32_t FindNRingNeighbors::generate(TriangleGeom::Pointer triangleGeom, int32_t
 #endif
 
   // Add our seed triangle
-  m_NRingTriangles.insert(m_TriangleId);
+  m_NRingTriangles.push_back(m_TriangleId);
+  m_Frontier.assign(1, m_TriangleId);
 
-  for(int64_t ring = 0; ring < m_Ring; ++ring)
+  for(int64_t ring = 0; ring < m_Ring && !m_Frontier.empty(); ++ring)
   {
-    // Make a copy of the 1 Ring Triangles that we just found so that we can use those triangles as the
-    // seed triangles for the 2 Ring triangles
-    UniqueFaceIds_t lcvTriangles(m_NRingTriangles);
-
-    // Now that we have the 1 ring triangles, get the 2 Ring neighbors from that list
-    for(UniqueFaceIds_t::iterator triIter = lcvTriangles.begin(); triIter != lcvTriangles.end(); ++triIter)
+    // Only the triangles added by the previous ring can reach triangles that are not in the patch yet, so gather
+    // the matching triangles around their nodes
+    m_Candidates.clear();
+    for(int64_t triangleIdx : m_Frontier)
     {
-      int64_t triangleIdx = *triIter;
-      // For each node, get the triangle ids that the node belongs to
       for(int32_t i = 0; i < 3; ++i)
       {
-        // Get all the triangles for this Node id
-        uint16_t tCount = node2TrianglePtr->getNumberOfElements(triangles[triangleIdx * 3 + i]);
-        MeshIndexType* data = node2TrianglePtr->getElementListPointer(triangles[triangleIdx * 3 + i]);
-
-        // Copy all the triangles into our "2Ring" set which will be the unique set of triangle ids
-        for(uint16_t t = 0; t < tCount; ++t)
+        MeshIndexType node = triangles[triangleIdx * 3 + i];
+        for(const MeshIndexType* data = m_Adjacency->begin(node); data != m_Adjacency->end(node); ++data)
         {
-          int64_t tid = data[t];
+          int64_t tid = static_cast<int64_t>(*data);
           check0 = faceLabels[tid * 2] == m_RegionId0 && faceLabels[tid * 2 + 1] == m_RegionId1;
           check1 = faceLabels[tid * 2 + 1] == m_RegionId0 && faceLabels[tid * 2] == m_RegionId1;
           if(check0 || check1)
           {
-            m_NRingTriangles.insert(tid);
+            m_Candidates.push_back(tid);
           }
         }
       }
     }
+    std::sort(m_Candidates.begin(), m_Candidates.end());
+    m_Candidates.erase(std::unique(m_Candidates.begin(), m_Candidates.end()), m_Candidates.end());
+
+    // The next ring grows from the candidates that are new, and the patch stays sorted
+    m_Frontier.clear();
+    std::set_difference(m_Candidates.begin(), m_Candidates.end(), m_NRingTriangles.begin(), m_NRingTriangles.end(), std::back_inserter(m_Frontier));
+    m_Merged.clear();
+    std::merge(m_NRingTriangles.begin(), m_NRingTriangles.end(), m_Frontier.begin(), m_Frontier.end(), std::back_inserter(m_Merged));
+    m_NRingTriangles.swap(m_Merged);
   }
   return err;
 }
@@ -234,3 +264,52 @@ bool FindNRingNeighbors::getWriteConformalMesh() const
 {
   return m_WriteConformalMesh;
 }
+
+// -----------------------------------------------------------------------------
+void FindNRingNeighbors::setAdjacency(const std::shared_ptr<const VertexTriangleAdjacency>& value)
+{
+  m_Adjacency = value;
+  m_AdjacencyGeom = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const VertexTriangleAdjacency> FindNRingNeighbors::getAdjacency() const
+{
+  return m_Adjacency;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FindNRingNeighborsPool::FindNRingNeighborsPool(const std::shared_ptr<const VertexTriangleAdjacency>& adjacency)
+: m_Adjacency(adjacency)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FindNRingNeighbors::Pointer FindNRingNeighborsPool::acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if(!m_Available.empty())
+    {
+      FindNRingNeighbors::Pointer instance = m_Available.back();
+      m_Available.pop_back();
+      return instance;
+    }
+  }
+  FindNRingNeighbors::Pointer instance = FindNRingNeighbors::New();
+  instance->setAdjacency(m_Adjacency);
+  return instance;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FindNRingNeighborsPool::release(const FindNRingNeighbors::Pointer& instance)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Available.push_back(instance);
+}
@@ -36,14 +36,41 @@
 #pragma once
 
 #include <memory>
-
-#include <set>
+#include <mutex>
+#include <vector>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
 
 /**
- * @brief The FindNRingNeighbors class calculates the set of triangles that are "N" rings (based on vertex) from a seed triangle
+ * @brief The VertexTriangleAdjacency class stores the triangles that use each vertex of a TriangleGeom in one flat
+ * array. The triangles of vertex v are [begin(v), end(v)), in increasing order. It is built once per mesh and can be
+ * shared by any number of FindNRingNeighbors instances.
+ */
+class VertexTriangleAdjacency
+{
+public:
+  explicit VertexTriangleAdjacency(TriangleGeom& triangleGeom);
+
+  const MeshIndexType* begin(MeshIndexType vertex) const
+  {
+    return m_Triangles.data() + m_Offsets[vertex];
+  }
+
+  const MeshIndexType* end(MeshIndexType vertex) const
+  {
+    return m_Triangles.data() + m_Offsets[vertex + 1];
+  }
+
+private:
+  std::vector<size_t> m_Offsets;
+  std::vector<MeshIndexType> m_Triangles;
+};
+
+/**
+ * @brief The FindNRingNeighbors class calculates the set of triangles that are "N" rings (based on vertex) from a seed triangle.
+ * The rings are grown in vectors that are kept between calls, so reusing an instance does not allocate once its
+ * buffers have grown to the size of a typical patch.
  */
 class FindNRingNeighbors
 {
@@ -68,7 +95,7 @@ public:
 
   virtual ~FindNRingNeighbors();
 
-  using UniqueFaceIds_t = std::set<int64_t>;
+  using UniqueFaceIds_t = std::vector<int64_t>;
 
   /**
    * @brief Setter property for TriangleId
@@ -126,9 +153,19 @@ public:
    */
   int64_t getRing() const;
 
+  /**
+   * @brief Setter property for Adjacency. When it is not set, generate() builds one from the TriangleGeom it is given.
+   */
+  void setAdjacency(const std::shared_ptr<const VertexTriangleAdjacency>& value);
+  /**
+   * @brief Getter property for Adjacency
+   * @return Value of Adjacency
+   */
+  std::shared_ptr<const VertexTriangleAdjacency> getAdjacency() const;
+
   /**
    * @brief getNRingTriangles Returns the N ring set
-   * @return Set of N ring Ids
+   * @return Sorted, unique N ring Ids
    */
   UniqueFaceIds_t& getNRingTriangles();
 
@@ -172,6 +209,11 @@ private:
   bool m_WriteConformalMesh = {true};
 
   UniqueFaceIds_t m_NRingTriangles;
+  std::shared_ptr<const VertexTriangleAdjacency> m_Adjacency;
+  TriangleGeom* m_AdjacencyGeom = nullptr;
+  UniqueFaceIds_t m_Frontier;
+  UniqueFaceIds_t m_Candidates;
+  UniqueFaceIds_t m_Merged;
 
 public:
   FindNRingNeighbors(const FindNRingNeighbors&) = delete;            // Copy Constructor Not Implemented
@@ -179,3 +221,22 @@ public:
   FindNRingNeighbors& operator=(const FindNRingNeighbors&) = delete; // Copy Assignment Not Implemented
   FindNRingNeighbors& operator=(FindNRingNeighbors&&) = delete;      // Move Assignment Not Implemented
 };
+
+/**
+ * @brief The FindNRingNeighborsPool class hands out FindNRingNeighbors instances that share one VertexTriangleAdjacency.
+ * Released instances are handed out again, so each worker thread ends up with an instance whose buffers are already grown.
+ */
+class FindNRingNeighborsPool
+{
+public:
+  explicit FindNRingNeighborsPool(const std::shared_ptr<const VertexTriangleAdjacency>& adjacency);
+
+  FindNRingNeighbors::Pointer acquire();
+
+  void release(const FindNRingNeighbors::Pointer& instance);
+
+private:
+  std::shared_ptr<const VertexTriangleAdjacency> m_Adjacency;
+  std::mutex m_Mutex;
+  std::vector<FindNRingNeighbors::Pointer> m_Available;
+};
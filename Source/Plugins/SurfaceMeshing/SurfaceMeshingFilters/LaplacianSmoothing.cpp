@@ -34,8 +34,10 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "LaplacianSmoothing.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <sstream>
+#include <vector>
 
 #include <QtCore/QDebug>
 #include <QtCore/QTextStream>
@@ -50,10 +52,107 @@
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "SurfaceMeshing/SurfaceMeshingConstants.h"
 #include "SurfaceMeshing/SurfaceMeshingVersion.h"
 
+namespace
+{
+/**
+ * @brief buildVertexAdjacency Builds a compressed (CSR) vertex to vertex adjacency from the unique
+ * edge list. The neighbors of each vertex are stored in edge order, which makes the gathered sums
+ * below add up in exactly the same order as the old per edge scatter did.
+ * @param uedges Unique edge list
+ * @param nedges Number of unique edges
+ * @param nvert Number of vertices
+ * @param offsets Output; neighbors of vertex i are neighbors[offsets[i]] .. neighbors[offsets[i + 1] - 1]
+ * @param neighbors Output; flattened neighbor lists
+ */
+void buildVertexAdjacency(const MeshIndexType* uedges, MeshIndexType nedges, MeshIndexType nvert, std::vector<MeshIndexType>& offsets, std::vector<MeshIndexType>& neighbors)
+{
+  offsets.assign(nvert + 1, 0);
+  for(MeshIndexType i = 0; i < nedges; i++)
+  {
+    offsets[uedges[2 * i] + 1]++;
+    offsets[uedges[2 * i + 1] + 1]++;
+  }
+  for(MeshIndexType i = 0; i < nvert; i++)
+  {
+    offsets[i + 1] += offsets[i];
+  }
+
+  neighbors.resize(offsets[nvert]);
+  std::vector<MeshIndexType> cursor(offsets.begin(), offsets.end() - 1);
+  for(MeshIndexType i = 0; i < nedges; i++)
+  {
+    MeshIndexType in1 = uedges[2 * i];
+    MeshIndexType in2 = uedges[2 * i + 1];
+    neighbors[cursor[in1]++] = in2;
+    neighbors[cursor[in2]++] = in1;
+  }
+}
+
+/**
+ * @brief The SmoothVerticesImpl class moves every vertex towards the average of its neighbors. It reads
+ * the positions of one iteration from a source buffer and writes the result into a separate destination
+ * buffer so that every vertex is updated from the same positions.
+ */
+class SmoothVerticesImpl
+{
+public:
+  SmoothVerticesImpl(const float* source, float* destination, const MeshIndexType* offsets, const MeshIndexType* neighbors, const float* lambda, float factor, bool applyFactor)
+  : m_Source(source)
+  , m_Destination(destination)
+  , m_Offsets(offsets)
+  , m_Neighbors(neighbors)
+  , m_Lambda(lambda)
+  , m_Factor(factor)
+  , m_ApplyFactor(applyFactor)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      const float* vert = m_Source + 3 * i;
+      double delta[3] = {0.0, 0.0, 0.0};
+      MeshIndexType ncon = m_Offsets[i + 1] - m_Offsets[i];
+      for(MeshIndexType n = m_Offsets[i]; n < m_Offsets[i + 1]; n++)
+      {
+        const float* neighbor = m_Source + 3 * m_Neighbors[n];
+        for(size_t j = 0; j < 3; j++)
+        {
+          delta[j] += static_cast<double>(neighbor[j] - vert[j]);
+        }
+      }
+
+      float ll = m_ApplyFactor ? m_Lambda[i] * m_Factor : m_Lambda[i];
+      float* dest = m_Destination + 3 * i;
+      for(size_t j = 0; j < 3; j++)
+      {
+        dest[j] = vert[j] + ll * (delta[j] / static_cast<double>(ncon));
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const float* m_Source;
+  float* m_Destination;
+  const MeshIndexType* m_Offsets;
+  const MeshIndexType* m_Neighbors;
+  const float* m_Lambda;
+  float m_Factor;
+  bool m_ApplyFactor;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -270,104 +369,56 @@ int32_t LaplacianSmoothing::edgeBasedSmoothing()
   MeshIndexType* uedges = surfaceMesh->getEdgePointer(0);
   MeshIndexType nedges = surfaceMesh->getNumberOfEdges();
 
-  DataArray<int32_t>::Pointer numConnections = DataArray<int32_t>::CreateArray(nvert, std::string("_INTERNAL_USE_ONLY_Laplacian_Smoothing_NumberConnections_Array"), true);
-  numConnections->initializeWithZeros();
-  int32_t* ncon = numConnections->getPointer(0);
-
-  std::vector<size_t> cDims(1, 3);
-  DataArray<double>::Pointer deltaArray = DataArray<double>::CreateArray(nvert, cDims, "_INTERNAL_USE_ONLY_Laplacian_Smoothing_Delta_Array", true);
-  deltaArray->initializeWithZeros();
-  double* delta = deltaArray->getPointer(0);
+  // Each vertex gathers the deltas from its own neighbors instead of every edge scattering into both
+  // of its vertices, so the vertices can be moved in parallel without any write conflicts
+  std::vector<MeshIndexType> offsets;
+  std::vector<MeshIndexType> neighbors;
+  buildVertexAdjacency(uedges, nedges, nvert, offsets, neighbors);
+
+  // The positions ping-pong between the geometry's vertex list and this scratch buffer
+  std::vector<float> scratch(3 * nvert);
+  float* source = verts;
+  float* destination = scratch.data();
+
+  auto smoothVertices = [&](bool applyMuFactor) {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0ULL, nvert);
+    dataAlg.execute(SmoothVerticesImpl(source, destination, offsets.data(), neighbors.data(), lambda, m_MuFactor, applyMuFactor));
+    std::swap(source, destination);
+  };
 
-  double dlta = 0.0;
   for(int32_t q = 0; q < m_IterationSteps; q++)
   {
     if(getCancel())
     {
-      return -1;
+      break;
     }
     QString ss = QObject::tr("Iteration %1 of %2").arg(q).arg(m_IterationSteps);
     notifyStatusMessage(ss);
-    // Compute the Deltas for each point
-    for(MeshIndexType i = 0; i < nedges; i++)
-    {
-      MeshIndexType in1 = uedges[2 * i];     // row of the first vertex
-      MeshIndexType in2 = uedges[2 * i + 1]; // row the second vertex
-
-      for(MeshIndexType j = 0; j < 3; j++)
-      {
-        Q_ASSERT(static_cast<size_t>(3 * in1 + j) < static_cast<size_t>(nvert * 3));
-        Q_ASSERT(static_cast<size_t>(3 * in2 + j) < static_cast<size_t>(nvert * 3));
-        dlta = static_cast<double>(verts[3 * in2 + j] - verts[3 * in1 + j]);
-        delta[3 * in1 + j] += dlta;
-        delta[3 * in2 + j] += -1.0 * dlta;
-      }
-      ncon[in1] += 1;
-      ncon[in2] += 1;
-    }
-
-    // Move each point
-    float ll = 0.0f;
-    for(MeshIndexType i = 0; i < nvert; i++)
-    {
-      for(MeshIndexType j = 0; j < 3; j++)
-      {
-        MeshIndexType in0 = 3 * i + j;
-        dlta = delta[in0] / ncon[i];
-
-        ll = lambda[i];
-        verts[3 * i + j] += ll * dlta;
-        delta[in0] = 0.0; // reset for next iteration
-      }
-      ncon[i] = 0; // reset for next iteration
-    }
+    smoothVertices(false);
 
     // Now optionally apply a negative lambda based on the mu Factor value.
     // This is from Taubin's paper on smoothing without shrinkage. This effectively
     // runs a low pass filter on the data
     if(m_UseTaubinSmoothing)
     {
-
       if(getCancel())
       {
-        return -1;
+        break;
       }
-      QString ss = QObject::tr("Iteration %1 of %2").arg(q).arg(m_IterationSteps);
       notifyStatusMessage(ss);
-      // Compute the Delta's
-      for(MeshIndexType i = 0; i < nedges; i++)
-      {
-        MeshIndexType in1 = uedges[2 * i];     // row of the first vertex
-        MeshIndexType in2 = uedges[2 * i + 1]; // row the second vertex
-
-        for(int32_t j = 0; j < 3; j++)
-        {
-          Q_ASSERT(static_cast<size_t>(3 * in1 + j) < static_cast<size_t>(nvert * 3));
-          Q_ASSERT(static_cast<size_t>(3 * in2 + j) < static_cast<size_t>(nvert * 3));
-          dlta = verts[3 * in2 + j] - verts[3 * in1 + j];
-          delta[3 * in1 + j] += dlta;
-          delta[3 * in2 + j] += -1.0 * dlta;
-        }
-        ncon[in1] += 1;
-        ncon[in2] += 1;
-      }
+      smoothVertices(true);
+    }
+  }
 
-      // MOve the points
-      float ll = 0.0f;
-      for(MeshIndexType i = 0; i < nvert; i++)
-      {
-        for(MeshIndexType j = 0; j < 3; j++)
-        {
-          MeshIndexType in0 = 3 * i + j;
-          dlta = delta[in0] / ncon[i];
+  if(source != verts)
+  {
+    std::copy(source, source + 3 * nvert, verts);
+  }
 
-          ll = lambda[i] * m_MuFactor;
-          verts[3 * i + j] += ll * dlta;
-          delta[in0] = 0.0; // reset for next iteration
-        }
-        ncon[i] = 0; // reset for next iteration
-      }
-    }
+  if(getCancel())
+  {
+    return -1;
   }
 
   return err;
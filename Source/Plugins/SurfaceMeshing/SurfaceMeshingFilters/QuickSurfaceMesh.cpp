@@ -53,14 +53,18 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
 #include "SIMPLib/Math/SIMPLibRandom.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include <QtCore/QTextStream>
 
+#include <algorithm>
 #include <array>
 #include <random>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <exception>
+#include <limits>
 
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -206,6 +210,512 @@ void copyCellArraysToFaceArrays(size_t faceIndex, size_t firstcIndex, size_t sec
   }
 }
 
+namespace
+{
+constexpr MeshIndexType k_UnusedNode = std::numeric_limits<MeshIndexType>::max();
+
+/**
+ * @brief The orientations of a voxel face, in the order the mesh sweep visits them for each voxel
+ */
+enum FaceOrientation : uint8_t
+{
+  XMinFace = 0,
+  YMinFace = 1,
+  ZMinFace = 2,
+  XMaxFace = 3,
+  YMaxFace = 4,
+  ZMaxFace = 5
+};
+
+// Grid node offsets (dx, dy, dz) from the voxel of the four corners of each face orientation
+constexpr uint8_t k_FaceCorners[6][4][3] = {
+    {{0, 0, 0}, {0, 1, 0}, {0, 0, 1}, {0, 1, 1}}, // XMinFace
+    {{0, 0, 0}, {1, 0, 0}, {0, 0, 1}, {1, 0, 1}}, // YMinFace
+    {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}}, // ZMinFace
+    {{1, 0, 0}, {1, 1, 0}, {1, 0, 1}, {1, 1, 1}}, // XMaxFace
+    {{1, 1, 0}, {0, 1, 0}, {1, 1, 1}, {0, 1, 1}}, // YMaxFace
+    {{1, 0, 1}, {0, 0, 1}, {1, 1, 1}, {0, 1, 1}}, // ZMaxFace
+};
+
+// Triangle winding of a face on the outside of the volume. 0 => (n1, n2, n3), (n2, n4, n3) and 1 => (n1, n3, n2), (n2, n3, n4)
+constexpr uint8_t k_BoundaryWinding[6] = {1, 0, 1, 0, 0, 1};
+// Triangle winding of an interior face labeled (neighbor, voxel). It is flipped when the labels are swapped. Min faces are never interior.
+constexpr uint8_t k_InteriorWinding[6] = {0, 0, 0, 0, 1, 0};
+
+/**
+ * @brief faceCornerNode Returns the grid node index of a corner of a face of voxel (i, j, k)
+ */
+inline MeshIndexType faceCornerNode(uint8_t orientation, size_t corner, MeshIndexType i, MeshIndexType j, MeshIndexType k, const MeshIndexType* dims)
+{
+  const uint8_t* offset = k_FaceCorners[orientation][corner];
+  return ((k + offset[2]) * (dims[0] + 1) * (dims[1] + 1)) + ((j + offset[1]) * (dims[0] + 1)) + (i + offset[0]);
+}
+
+/**
+ * @brief forEachVoxelFace Calls faceFunctor(orientation, point, neighbor) for each mesh face of voxel (i, j, k) in the
+ * order the mesh is numbered. Faces on the outside of the volume pass the voxel itself as the neighbor.
+ */
+template <typename FaceFunctor>
+inline void forEachVoxelFace(const int32_t* featureIds, const MeshIndexType* dims, MeshIndexType i, MeshIndexType j, MeshIndexType k, FaceFunctor& faceFunctor)
+{
+  const MeshIndexType xP = dims[0];
+  const MeshIndexType yP = dims[1];
+  const MeshIndexType zP = dims[2];
+  const MeshIndexType point = (k * xP * yP) + (j * xP) + i;
+
+  if(i == 0)
+  {
+    faceFunctor(XMinFace, point, point);
+  }
+  if(j == 0)
+  {
+    faceFunctor(YMinFace, point, point);
+  }
+  if(k == 0)
+  {
+    faceFunctor(ZMinFace, point, point);
+  }
+  if(i == (xP - 1))
+  {
+    faceFunctor(XMaxFace, point, point);
+  }
+  else if(featureIds[point] != featureIds[point + 1])
+  {
+    faceFunctor(XMaxFace, point, point + 1);
+  }
+  if(j == (yP - 1))
+  {
+    faceFunctor(YMaxFace, point, point);
+  }
+  else if(featureIds[point] != featureIds[point + xP])
+  {
+    faceFunctor(YMaxFace, point, point + xP);
+  }
+  if(k == (zP - 1))
+  {
+    faceFunctor(ZMaxFace, point, point);
+  }
+  else if(featureIds[point] != featureIds[point + (xP * yP)])
+  {
+    faceFunctor(ZMaxFace, point, point + (xP * yP));
+  }
+}
+
+/**
+ * @brief The CountLayerFacesImpl class counts the triangles of each Z layer of voxels and flags the nodes of
+ * the plane above the layer that its faces touch. Layer k only writes flags of node plane k + 1. Node buffers
+ * only cover a slab of node planes, so all node indices are relative to nodeBase.
+ */
+class CountLayerFacesImpl
+{
+public:
+  CountLayerFacesImpl(const int32_t* featureIds, const MeshIndexType* dims, MeshIndexType nodeBase, uint8_t* touchedFromBelow, MeshIndexType* layerTriangleCounts)
+  : m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_NodeBase(nodeBase)
+  , m_TouchedFromBelow(touchedFromBelow)
+  , m_LayerTriangleCounts(layerTriangleCounts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(MeshIndexType k = start; k < end; k++)
+    {
+      MeshIndexType triangleCount = 0;
+      MeshIndexType i = 0;
+      MeshIndexType j = 0;
+      auto countFace = [&](uint8_t orientation, MeshIndexType /* point */, MeshIndexType /* neighbor */) {
+        triangleCount += 2;
+        for(size_t corner = 0; corner < 4; corner++)
+        {
+          if(k_FaceCorners[orientation][corner][2] == 1)
+          {
+            m_TouchedFromBelow[faceCornerNode(orientation, corner, i, j, k, m_Dims) - m_NodeBase] = 1;
+          }
+        }
+      };
+      for(j = 0; j < m_Dims[1]; j++)
+      {
+        for(i = 0; i < m_Dims[0]; i++)
+        {
+          forEachVoxelFace(m_FeatureIds, m_Dims, i, j, k, countFace);
+        }
+      }
+      m_LayerTriangleCounts[k] = triangleCount;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  const MeshIndexType* m_Dims;
+  MeshIndexType m_NodeBase;
+  uint8_t* m_TouchedFromBelow;
+  MeshIndexType* m_LayerTriangleCounts;
+};
+
+/**
+ * @brief The NumberLayerNodesImpl class numbers the nodes owned by each Z layer of voxels in the order the serial sweep
+ * first encounters them. A layer owns the nodes of the plane above it that it touches and the nodes of the plane below
+ * it that the previous layer did not touch, so no two layers ever write the same node.
+ */
+class NumberLayerNodesImpl
+{
+public:
+  NumberLayerNodesImpl(const int32_t* featureIds, const MeshIndexType* dims, MeshIndexType nodeBase, const uint8_t* touchedFromBelow, MeshIndexType* nodeIds, MeshIndexType* layerNodeCounts)
+  : m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_NodeBase(nodeBase)
+  , m_TouchedFromBelow(touchedFromBelow)
+  , m_NodeIds(nodeIds)
+  , m_LayerNodeCounts(layerNodeCounts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(MeshIndexType k = start; k < end; k++)
+    {
+      MeshIndexType nodeCount = 0;
+      MeshIndexType i = 0;
+      MeshIndexType j = 0;
+      auto numberFace = [&](uint8_t orientation, MeshIndexType /* point */, MeshIndexType /* neighbor */) {
+        for(size_t corner = 0; corner < 4; corner++)
+        {
+          MeshIndexType node = faceCornerNode(orientation, corner, i, j, k, m_Dims) - m_NodeBase;
+          if(k_FaceCorners[orientation][corner][2] == 0 && m_TouchedFromBelow[node] != 0)
+          {
+            continue;
+          }
+          if(m_NodeIds[node] == k_UnusedNode)
+          {
+            m_NodeIds[node] = nodeCount;
+            nodeCount++;
+          }
+        }
+      };
+      for(j = 0; j < m_Dims[1]; j++)
+      {
+        for(i = 0; i < m_Dims[0]; i++)
+        {
+          forEachVoxelFace(m_FeatureIds, m_Dims, i, j, k, numberFace);
+        }
+      }
+      m_LayerNodeCounts[k] = nodeCount;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int32_t* m_FeatureIds;
+  const MeshIndexType* m_Dims;
+  MeshIndexType m_NodeBase;
+  const uint8_t* m_TouchedFromBelow;
+  MeshIndexType* m_NodeIds;
+  MeshIndexType* m_LayerNodeCounts;
+};
+
+/**
+ * @brief The OffsetLayerNodesImpl class converts the per layer node numbers of a set of node planes into global node numbers
+ */
+class OffsetLayerNodesImpl
+{
+public:
+  OffsetLayerNodesImpl(const MeshIndexType* dims, MeshIndexType nodeBase, const uint8_t* touchedFromBelow, const MeshIndexType* layerNodeOffsets, MeshIndexType* nodeIds)
+  : m_Dims(dims)
+  , m_NodeBase(nodeBase)
+  , m_TouchedFromBelow(touchedFromBelow)
+  , m_LayerNodeOffsets(layerNodeOffsets)
+  , m_NodeIds(nodeIds)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const MeshIndexType planeSize = (m_Dims[0] + 1) * (m_Dims[1] + 1);
+    for(MeshIndexType plane = start; plane < end; plane++)
+    {
+      for(MeshIndexType node = plane * planeSize - m_NodeBase; node < (plane + 1) * planeSize - m_NodeBase; node++)
+      {
+        if(m_NodeIds[node] == k_UnusedNode)
+        {
+          continue;
+        }
+        MeshIndexType owner = (m_TouchedFromBelow[node] != 0) ? plane - 1 : plane;
+        m_NodeIds[node] += m_LayerNodeOffsets[owner];
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const MeshIndexType* m_Dims;
+  MeshIndexType m_NodeBase;
+  const uint8_t* m_TouchedFromBelow;
+  const MeshIndexType* m_LayerNodeOffsets;
+  MeshIndexType* m_NodeIds;
+};
+
+/**
+ * @brief The CreateMeshNodesImpl class writes the coordinates and node type of the mesh nodes in a set of node planes
+ * that are owned by the voxel layers [firstLayer, endLayer). The owners of a node are the distinct Feature Ids of the
+ * (up to) eight voxels around it, with -1 standing in for the outside of the volume. This is the same set the faces
+ * that share the node contribute.
+ */
+class CreateMeshNodesImpl
+{
+public:
+  CreateMeshNodesImpl(const IGeometryGrid::Pointer& grid, const int32_t* featureIds, const MeshIndexType* dims, MeshIndexType nodeBase, MeshIndexType firstLayer, MeshIndexType endLayer,
+                      const uint8_t* touchedFromBelow, const MeshIndexType* nodeIds, float* vertex, int8_t* nodeTypes)
+  : m_Grid(grid)
+  , m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_NodeBase(nodeBase)
+  , m_FirstLayer(firstLayer)
+  , m_EndLayer(endLayer)
+  , m_TouchedFromBelow(touchedFromBelow)
+  , m_NodeIds(nodeIds)
+  , m_Vertex(vertex)
+  , m_NodeTypes(nodeTypes)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t xP = static_cast<int64_t>(m_Dims[0]);
+    const int64_t yP = static_cast<int64_t>(m_Dims[1]);
+    const int64_t zP = static_cast<int64_t>(m_Dims[2]);
+    float coords[3] = {0.0f, 0.0f, 0.0f};
+    for(int64_t z = static_cast<int64_t>(start); z < static_cast<int64_t>(end); z++)
+    {
+      for(int64_t y = 0; y <= yP; y++)
+      {
+        for(int64_t x = 0; x <= xP; x++)
+        {
+          MeshIndexType node = static_cast<MeshIndexType>((z * (xP + 1) * (yP + 1)) + (y * (xP + 1)) + x) - m_NodeBase;
+          MeshIndexType nodeId = m_NodeIds[node];
+          if(nodeId == k_UnusedNode)
+          {
+            continue;
+          }
+          int64_t ownerLayer = (m_TouchedFromBelow[node] != 0) ? z - 1 : z;
+          if(ownerLayer < static_cast<int64_t>(m_FirstLayer) || ownerLayer >= static_cast<int64_t>(m_EndLayer))
+          {
+            continue;
+          }
+          m_Grid->getPlaneCoords(static_cast<size_t>(x), static_cast<size_t>(y), static_cast<size_t>(z), coords);
+          m_Vertex[nodeId * 3 + 0] = coords[0];
+          m_Vertex[nodeId * 3 + 1] = coords[1];
+          m_Vertex[nodeId * 3 + 2] = coords[2];
+
+          std::array<int32_t, 8> owners = {0, 0, 0, 0, 0, 0, 0, 0};
+          size_t numOwners = 0;
+          bool onSurface = false;
+          for(int64_t vz = z - 1; vz <= z; vz++)
+          {
+            for(int64_t vy = y - 1; vy <= y; vy++)
+            {
+              for(int64_t vx = x - 1; vx <= x; vx++)
+              {
+                int32_t owner = -1;
+                if(vx >= 0 && vx < xP && vy >= 0 && vy < yP && vz >= 0 && vz < zP)
+                {
+                  owner = m_FeatureIds[(vz * xP * yP) + (vy * xP) + vx];
+                }
+                onSurface = onSurface || owner == -1;
+                if(std::find(owners.begin(), owners.begin() + numOwners, owner) == owners.begin() + numOwners)
+                {
+                  owners[numOwners] = owner;
+                  numOwners++;
+                }
+              }
+            }
+          }
+          int8_t nodeType = static_cast<int8_t>(std::min(numOwners, static_cast<size_t>(4)));
+          if(onSurface)
+          {
+            nodeType += 10;
+          }
+          m_NodeTypes[nodeId] = nodeType;
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  IGeometryGrid::Pointer m_Grid;
+  const int32_t* m_FeatureIds;
+  const MeshIndexType* m_Dims;
+  MeshIndexType m_NodeBase;
+  MeshIndexType m_FirstLayer;
+  MeshIndexType m_EndLayer;
+  const uint8_t* m_TouchedFromBelow;
+  const MeshIndexType* m_NodeIds;
+  float* m_Vertex;
+  int8_t* m_NodeTypes;
+};
+
+/**
+ * @brief The CreateLayerTrianglesImpl class writes the triangles, face labels and face data of a set of Z layers
+ * of voxels. Each layer starts writing at its prefix sum offset so the triangle order matches the serial sweep.
+ */
+class CreateLayerTrianglesImpl
+{
+public:
+  CreateLayerTrianglesImpl(QuickSurfaceMesh* filter, const int32_t* featureIds, const MeshIndexType* dims, MeshIndexType nodeBase, const MeshIndexType* nodeIds,
+                           const MeshIndexType* layerTriangleOffsets, MeshIndexType* triangle, int32_t* faceLabels, const std::vector<IDataArray::Pointer>& selectedArrays,
+                           const std::vector<IDataArray::Pointer>& createdArrays)
+  : m_Filter(filter)
+  , m_FeatureIds(featureIds)
+  , m_Dims(dims)
+  , m_NodeBase(nodeBase)
+  , m_NodeIds(nodeIds)
+  , m_LayerTriangleOffsets(layerTriangleOffsets)
+  , m_Triangle(triangle)
+  , m_FaceLabels(faceLabels)
+  , m_SelectedArrays(selectedArrays)
+  , m_CreatedArrays(createdArrays)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(MeshIndexType k = start; k < end; k++)
+    {
+      MeshIndexType triangleIndex = m_LayerTriangleOffsets[k];
+      MeshIndexType i = 0;
+      MeshIndexType j = 0;
+      auto createFace = [&](uint8_t orientation, MeshIndexType point, MeshIndexType neighbor) {
+        MeshIndexType n[4] = {0, 0, 0, 0};
+        for(size_t corner = 0; corner < 4; corner++)
+        {
+          n[corner] = m_NodeIds[faceCornerNode(orientation, corner, i, j, k, m_Dims) - m_NodeBase];
+        }
+
+        bool onSurface = (neighbor == point);
+        uint8_t winding = k_BoundaryWinding[orientation];
+        int32_t label0 = -1;
+        int32_t label1 = m_FeatureIds[point];
+        if(!onSurface)
+        {
+          winding = k_InteriorWinding[orientation];
+          label0 = m_FeatureIds[neighbor];
+          if(m_FeatureIds[point] < m_FeatureIds[neighbor])
+          {
+            winding = 1 - winding;
+            label0 = m_FeatureIds[point];
+            label1 = m_FeatureIds[neighbor];
+          }
+        }
+
+        for(size_t t = 0; t < 2; t++)
+        {
+          MeshIndexType* tri = m_Triangle + triangleIndex * 3;
+          if(t == 0)
+          {
+            tri[0] = n[0];
+            tri[1] = (winding == 0) ? n[1] : n[2];
+            tri[2] = (winding == 0) ? n[2] : n[1];
+          }
+          else
+          {
+            tri[0] = n[1];
+            tri[1] = (winding == 0) ? n[3] : n[2];
+            tri[2] = (winding == 0) ? n[2] : n[3];
+          }
+          m_FaceLabels[triangleIndex * 2] = label0;
+          m_FaceLabels[triangleIndex * 2 + 1] = label1;
+
+          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedArrays.size(); dataVectorIndex++)
+          {
+            EXECUTE_FUNCTION_TEMPLATE(m_Filter, copyCellArraysToFaceArrays, m_SelectedArrays[dataVectorIndex], triangleIndex, neighbor, point, m_SelectedArrays[dataVectorIndex],
+                                      m_CreatedArrays[dataVectorIndex], onSurface)
+          }
+
+          triangleIndex++;
+        }
+      };
+      for(j = 0; j < m_Dims[1]; j++)
+      {
+        for(i = 0; i < m_Dims[0]; i++)
+        {
+          forEachVoxelFace(m_FeatureIds, m_Dims, i, j, k, createFace);
+        }
+      }
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  QuickSurfaceMesh* m_Filter;
+  const int32_t* m_FeatureIds;
+  const MeshIndexType* m_Dims;
+  MeshIndexType m_NodeBase;
+  const MeshIndexType* m_NodeIds;
+  const MeshIndexType* m_LayerTriangleOffsets;
+  MeshIndexType* m_Triangle;
+  int32_t* m_FaceLabels;
+  const std::vector<IDataArray::Pointer>& m_SelectedArrays;
+  const std::vector<IDataArray::Pointer>& m_CreatedArrays;
+};
+
+/**
+ * @brief slabLayerCount Returns the number of Z layers of voxels meshed per slab. The node buffers only ever hold
+ * a slab worth of node planes, so peak memory does not grow with the Z extent of the volume.
+ */
+inline MeshIndexType slabLayerCount()
+{
+  return std::max<MeshIndexType>(16, 4 * static_cast<MeshIndexType>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * @brief numberSlabNodes Flags and numbers the nodes owned by the voxel layers [firstLayer, endLayer). The buffers
+ * hold the node planes [firstLayer, endLayer] and are reset first. Layer firstLayer - 1 is counted again to recover
+ * the flags of node plane firstLayer.
+ */
+void numberSlabNodes(const int32_t* featureIds, const MeshIndexType* dims, MeshIndexType firstLayer, MeshIndexType endLayer, std::vector<uint8_t>& touchedFromBelow,
+                     std::vector<MeshIndexType>& nodeIds, MeshIndexType* layerTriangleCounts, MeshIndexType* layerNodeCounts)
+{
+  const MeshIndexType planeSize = (dims[0] + 1) * (dims[1] + 1);
+  const MeshIndexType nodeBase = firstLayer * planeSize;
+  const MeshIndexType slabNodes = (endLayer - firstLayer + 1) * planeSize;
+  std::fill(touchedFromBelow.begin(), touchedFromBelow.begin() + slabNodes, 0);
+  std::fill(nodeIds.begin(), nodeIds.begin() + slabNodes, k_UnusedNode);
+
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(static_cast<size_t>(firstLayer > 0 ? firstLayer - 1 : 0), static_cast<size_t>(endLayer));
+    dataAlg.execute(CountLayerFacesImpl(featureIds, dims, nodeBase, touchedFromBelow.data(), layerTriangleCounts));
+  }
+
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(static_cast<size_t>(firstLayer), static_cast<size_t>(endLayer));
+  dataAlg.execute(NumberLayerNodesImpl(featureIds, dims, nodeBase, touchedFromBelow.data(), nodeIds.data(), layerNodeCounts));
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -328,18 +838,6 @@ void QuickSurfaceMesh::dataCheck()
   getDataContainerArray()->createNonPrereqDataContainer(this, getTripleLineDataContainerName(), DataContainerID02);
 }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void QuickSurfaceMesh::getGridCoordinates(const IGeometryGrid::Pointer& grid, size_t x, size_t y, size_t z, float* coords)
-{
-  float tmpCoords[3] = {0.0f, 0.0f, 0.0f};
-  grid->getPlaneCoords(x, y, z, tmpCoords);
-  coords[0] = tmpCoords[0];
-  coords[1] = tmpCoords[1];
-  coords[2] = tmpCoords[2];
-}
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -596,7 +1094,8 @@ void QuickSurfaceMesh::correctProblemVoxels()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void QuickSurfaceMesh::determineActiveNodes(std::vector<MeshIndexType>& nodeIds, MeshIndexType& nodeCount, MeshIndexType& triangleCount)
+void QuickSurfaceMesh::determineActiveNodes(std::vector<MeshIndexType>& layerNodeOffsets, std::vector<MeshIndexType>& layerTriangleOffsets, MeshIndexType& nodeCount,
+                                            MeshIndexType& triangleCount)
 {
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
 
@@ -604,299 +1103,45 @@ void QuickSurfaceMesh::determineActiveNodes(std::vector<MeshIndexType>& nodeIds,
 
   SizeVec3Type udims = grid->getDimensions();
 
-  MeshIndexType xP = udims[0];
-  MeshIndexType yP = udims[1];
-  MeshIndexType zP = udims[2];
-
-  std::vector<std::set<int32_t>> ownerLists;
-
-  MeshIndexType point = 0, neigh1 = 0, neigh2 = 0, neigh3 = 0;
-
-  MeshIndexType nodeId1 = 0, nodeId2 = 0, nodeId3 = 0, nodeId4 = 0;
-
-  // first determining which nodes are actually boundary nodes and
-  // count number of nodes and triangles that will be created
-  for(MeshIndexType k = 0; k < zP; k++)
+  MeshIndexType dims[3] = {udims[0], udims[1], udims[2]};
+  MeshIndexType zP = dims[2];
+  MeshIndexType planeSize = (dims[0] + 1) * (dims[1] + 1);
+  MeshIndexType slabLayers = std::min(slabLayerCount(), zP);
+
+  // Count the triangles and the owned nodes of each Z layer of voxels one slab at a time
+  std::vector<uint8_t> touchedFromBelow((slabLayers + 1) * planeSize, 0);
+  std::vector<MeshIndexType> nodeIds((slabLayers + 1) * planeSize, k_UnusedNode);
+  std::vector<MeshIndexType> layerTriangleCounts(zP, 0);
+  std::vector<MeshIndexType> layerNodeCounts(zP, 0);
+  for(MeshIndexType firstLayer = 0; firstLayer < zP; firstLayer += slabLayers)
   {
-    for(MeshIndexType j = 0; j < yP; j++)
+    if(getCancel())
     {
-      for(MeshIndexType i = 0; i < xP; i++)
-      {
-        point = (k * xP * yP) + (j * xP) + i;
-        neigh1 = point + 1;
-        neigh2 = point + xP;
-        neigh3 = point + (xP * yP);
-
-        if(i == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(j == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(k == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(i == (xP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh1])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(j == (yP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh2])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(k == (zP - 1))
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(k < zP - 1 && m_FeatureIds[point] != m_FeatureIds[neigh3])
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-      }
+      return;
     }
+    MeshIndexType endLayer = std::min(firstLayer + slabLayers, zP);
+    numberSlabNodes(m_FeatureIds, dims, firstLayer, endLayer, touchedFromBelow, nodeIds, layerTriangleCounts.data(), layerNodeCounts.data());
+  }
+
+  // Prefix sums turn the per layer numbering into the global node and triangle numbering
+  layerNodeOffsets.assign(zP, 0);
+  layerTriangleOffsets.assign(zP, 0);
+  nodeCount = 0;
+  triangleCount = 0;
+  for(MeshIndexType k = 0; k < zP; k++)
+  {
+    layerNodeOffsets[k] = nodeCount;
+    layerTriangleOffsets[k] = triangleCount;
+    nodeCount += layerNodeCounts[k];
+    triangleCount += layerTriangleCounts[k];
   }
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_NodeIds, MeshIndexType nodeCount, MeshIndexType triangleCount)
+void QuickSurfaceMesh::createNodesAndTriangles(const std::vector<MeshIndexType>& layerNodeOffsets, const std::vector<MeshIndexType>& layerTriangleOffsets, MeshIndexType nodeCount,
+                                               MeshIndexType triangleCount)
 {
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
   DataContainer::Pointer sm = getDataContainerArray()->getDataContainer(getSurfaceDataContainerName());
@@ -919,17 +1164,10 @@ void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_Node
 
   SizeVec3Type udims = grid->getDimensions();
 
-  MeshIndexType xP = udims[0];
-  MeshIndexType yP = udims[1];
-  MeshIndexType zP = udims[2];
-
-  std::vector<std::set<int32_t>> ownerLists;
-
-  MeshIndexType point = 0, neigh1 = 0, neigh2 = 0, neigh3 = 0;
-
-  MeshIndexType nodeId1 = 0, nodeId2 = 0, nodeId3 = 0, nodeId4 = 0;
-
-  MeshIndexType cIndex1 = 0, cIndex2 = 0;
+  MeshIndexType dims[3] = {udims[0], udims[1], udims[2]};
+  MeshIndexType zP = dims[2];
+  MeshIndexType planeSize = (dims[0] + 1) * (dims[1] + 1);
+  MeshIndexType slabLayers = std::min(slabLayerCount(), zP);
 
   TriangleGeom::Pointer triangleGeom = sm->getGeometryAs<TriangleGeom>();
 
@@ -944,561 +1182,48 @@ void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_Node
   updateVertexInstancePointers();
   updateFaceInstancePointers();
 
-  ownerLists.resize(nodeCount);
+  std::vector<IDataArray::Pointer> selectedArrays;
+  std::vector<IDataArray::Pointer> createdArrays;
+  for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
+  {
+    selectedArrays.push_back(m_SelectedWeakPtrVector[dataVectorIndex].lock());
+    createdArrays.push_back(m_CreatedWeakPtrVector[dataVectorIndex].lock());
+  }
 
-  // Cycle through again assigning coordinates to each node and assigning node numbers and feature labels to each triangle
-  MeshIndexType triangleIndex = 0;
-  for(MeshIndexType k = 0; k < zP; k++)
+  // The triangles of a slab also use the nodes of the plane below it that the previous layer owns, so each slab
+  // numbers one extra layer below itself. Layer counts are recomputed into scratch space, the offsets are already known.
+  std::vector<uint8_t> touchedFromBelow((slabLayers + 2) * planeSize, 0);
+  std::vector<MeshIndexType> nodeIds((slabLayers + 2) * planeSize, k_UnusedNode);
+  std::vector<MeshIndexType> layerTriangleCounts(zP, 0);
+  std::vector<MeshIndexType> layerNodeCounts(zP, 0);
+  for(MeshIndexType firstLayer = 0; firstLayer < zP; firstLayer += slabLayers)
   {
-    for(MeshIndexType j = 0; j < yP; j++)
+    if(getCancel())
     {
-      for(MeshIndexType i = 0; i < xP; i++)
-      {
-        point = (k * xP * yP) + (j * xP) + i;
-        neigh1 = point + 1; // <== What happens if we are at the end of a row?
-        neigh2 = point + xP;
-        neigh3 = point + (xP * yP);
-
-        if(i == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        if(j == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        if(k == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        if(i == (xP - 1)) // Takes care of the end of a Row...
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh1])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh1];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          cIndex1 = neigh1;
-          cIndex2 = point;
-          if(m_FeatureIds[point] < m_FeatureIds[neigh1])
-          {
-            triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-            triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-            m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-            m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[neigh1];
-            cIndex1 = point;
-            cIndex2 = neigh1;
-          }
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, neigh1, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock())
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh1];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          cIndex1 = neigh1;
-          cIndex2 = point;
-          if(m_FeatureIds[point] < m_FeatureIds[neigh1])
-          {
-            triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-            triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-            m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-            m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[neigh1];
-            cIndex1 = point;
-            cIndex2 = neigh1;
-          }
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, neigh1, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock())
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[neigh1]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[neigh1]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[neigh1]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[neigh1]);
-        }
-        if(j == (yP - 1)) // Takes care of the end of a column
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh2])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh2];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          cIndex1 = neigh2;
-          cIndex2 = point;
-          if(m_FeatureIds[point] < m_FeatureIds[neigh2])
-          {
-            triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-            triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-            m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-            m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[neigh2];
-            cIndex1 = point;
-            cIndex2 = neigh2;
-          }
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, neigh2, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock())
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh2];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          cIndex1 = neigh2;
-          cIndex2 = point;
-          if(m_FeatureIds[point] < m_FeatureIds[neigh2])
-          {
-            triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-            triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-            m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-            m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[neigh2];
-            cIndex1 = point;
-            cIndex2 = neigh2;
-          }
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, neigh2, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock())
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[neigh2]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[neigh2]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[neigh2]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[neigh2]);
-        }
-        if(k == (zP - 1)) // Takes care of the end of a Pillar
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k + 1, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k + 1, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-          m_FaceLabels[triangleIndex * 2] = -1;
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, point, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock(), true)
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(-1);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(-1);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(-1);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(-1);
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh3])
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j, k + 1, vertex + (m_NodeIds[nodeId1] * 3));
-
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j, k + 1, vertex + (m_NodeIds[nodeId2] * 3));
-
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
-
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh3];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          cIndex1 = neigh3;
-          cIndex2 = point;
-          if(m_FeatureIds[point] < m_FeatureIds[neigh3])
-          {
-            triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-            triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId2];
-            m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-            m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[neigh3];
-            cIndex1 = point;
-            cIndex2 = neigh3;
-          }
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, neigh3, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock())
-          }
-
-          triangleIndex++;
-
-          triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId2];
-          triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId4];
-          triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId3];
-          m_FaceLabels[triangleIndex * 2] = m_FeatureIds[neigh3];
-          m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[point];
-          cIndex1 = neigh3;
-          cIndex2 = point;
-          if(m_FeatureIds[point] < m_FeatureIds[neigh3])
-          {
-            triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
-            triangle[triangleIndex * 3 + 2] = m_NodeIds[nodeId4];
-            m_FaceLabels[triangleIndex * 2] = m_FeatureIds[point];
-            m_FaceLabels[triangleIndex * 2 + 1] = m_FeatureIds[neigh3];
-            cIndex1 = point;
-            cIndex2 = neigh3;
-          }
-
-          for(size_t dataVectorIndex = 0; dataVectorIndex < m_SelectedWeakPtrVector.size(); dataVectorIndex++)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(this, copyCellArraysToFaceArrays, m_SelectedWeakPtrVector[dataVectorIndex].lock(), triangleIndex, neigh3, point, m_SelectedWeakPtrVector[dataVectorIndex].lock(),
-                                      m_CreatedWeakPtrVector[dataVectorIndex].lock())
-          }
-
-          triangleIndex++;
-
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId1]].insert(m_FeatureIds[neigh3]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId2]].insert(m_FeatureIds[neigh3]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId3]].insert(m_FeatureIds[neigh3]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[point]);
-          ownerLists[m_NodeIds[nodeId4]].insert(m_FeatureIds[neigh3]);
-        }
-      }
+      return;
     }
-  }
+    MeshIndexType endLayer = std::min(firstLayer + slabLayers, zP);
+    MeshIndexType firstNumberedLayer = (firstLayer > 0) ? firstLayer - 1 : 0;
+    MeshIndexType nodeBase = firstNumberedLayer * planeSize;
+    numberSlabNodes(m_FeatureIds, dims, firstNumberedLayer, endLayer, touchedFromBelow, nodeIds, layerTriangleCounts.data(), layerNodeCounts.data());
 
-  for(size_t i = 0; i < nodeCount; i++)
-  {
-    m_NodeTypes[i] = static_cast<int8_t>(ownerLists[i].size());
-    if(m_NodeTypes[i] > 4)
     {
-      m_NodeTypes[i] = 4;
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(static_cast<size_t>(firstNumberedLayer), static_cast<size_t>(endLayer + 1));
+      dataAlg.execute(OffsetLayerNodesImpl(dims, nodeBase, touchedFromBelow.data(), layerNodeOffsets.data(), nodeIds.data()));
     }
-    if(ownerLists[i].find(-1) != ownerLists[i].end())
+
+    // Each node gets its coordinates and node type exactly once, from the slab of the layer that owns it
     {
-      m_NodeTypes[i] += 10;
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(static_cast<size_t>(firstLayer), static_cast<size_t>(endLayer + 1));
+      dataAlg.execute(CreateMeshNodesImpl(grid, m_FeatureIds, dims, nodeBase, firstLayer, endLayer, touchedFromBelow.data(), nodeIds.data(), vertex, m_NodeTypes));
     }
+
+    // Each layer of voxels writes its triangles starting at its prefix sum offset
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(static_cast<size_t>(firstLayer), static_cast<size_t>(endLayer));
+    dataAlg.execute(CreateLayerTrianglesImpl(this, m_FeatureIds, dims, nodeBase, nodeIds.data(), layerTriangleOffsets.data(), triangle, m_FaceLabels, selectedArrays, createdArrays));
   }
 }
 
@@ -1528,35 +1253,33 @@ void QuickSurfaceMesh::execute()
   {
     return;
   }
-  IGeometryGrid::Pointer grid = m->getGeometryAs<IGeometryGrid>();
-
-  SizeVec3Type udims = grid->getDimensions();
-
-  size_t xP = udims[0];
-  size_t yP = udims[1];
-  size_t zP = udims[2];
-
-  std::vector<std::set<int32_t>> ownerLists;
+  std::vector<MeshIndexType> layerNodeOffsets;
+  std::vector<MeshIndexType> layerTriangleOffsets;
 
-  size_t possibleNumNodes = (xP + 1) * (yP + 1) * (zP + 1);
-  std::vector<size_t> m_NodeIds(possibleNumNodes, std::numeric_limits<size_t>::max());
-
-  size_t nodeCount = 0;
-  size_t triangleCount = 0;
+  MeshIndexType nodeCount = 0;
+  MeshIndexType triangleCount = 0;
 
   if(getFixProblemVoxels())
   {
     correctProblemVoxels();
   }
 
-  determineActiveNodes(m_NodeIds, nodeCount, triangleCount);
+  determineActiveNodes(layerNodeOffsets, layerTriangleOffsets, nodeCount, triangleCount);
+  if(getCancel())
+  {
+    return;
+  }
 
   // now create node and triangle arrays knowing the number that will be needed
   TriangleGeom::Pointer triangleGeom = sm->getGeometryAs<TriangleGeom>();
   triangleGeom->resizeTriList(triangleCount);
   triangleGeom->resizeVertexList(nodeCount);
 
-  createNodesAndTriangles(m_NodeIds, nodeCount, triangleCount);
+  createNodesAndTriangles(layerNodeOffsets, layerTriangleOffsets, nodeCount, triangleCount);
+  if(getCancel())
+  {
+    return;
+  }
 
   MeshIndexType* triangle = triangleGeom->getTriPointer(0);
 
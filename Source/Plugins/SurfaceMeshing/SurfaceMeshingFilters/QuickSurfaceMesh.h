@@ -298,16 +298,6 @@ private:
   std::vector<IDataArray::WeakPointer> m_SelectedWeakPtrVector;
   std::vector<IDataArray::WeakPointer> m_CreatedWeakPtrVector;
 
-  /**
-   * @brief getGridCoordinates
-   * @param grid
-   * @param x
-   * @param y
-   * @param z
-   * @param coords
-   */
-  void getGridCoordinates(const IGeometryGrid::Pointer& grid, size_t x, size_t y, size_t z, float* coords);
-
   /**
    * @brief flipProblemVoxelCase1
    * @param v1
@@ -338,9 +328,27 @@ private:
 
   void correctProblemVoxels();
 
-  void determineActiveNodes(std::vector<MeshIndexType>& m_NodeIds, MeshIndexType& nodeCount, MeshIndexType& triangleCount);
+  /**
+   * @brief determineActiveNodes Counts the mesh nodes and triangles of each Z layer of voxels. The volume is swept in
+   * slabs of layers, so only a slab worth of node planes is ever held in memory, and the layers of a slab are
+   * processed in parallel. Prefix sums make the numbering match a serial sweep over the volume.
+   * @param layerNodeOffsets Number of the first mesh node owned by each Z layer of voxels
+   * @param layerTriangleOffsets Index of the first triangle of each Z layer of voxels
+   * @param nodeCount Total number of mesh nodes
+   * @param triangleCount Total number of triangles
+   */
+  void determineActiveNodes(std::vector<MeshIndexType>& layerNodeOffsets, std::vector<MeshIndexType>& layerTriangleOffsets, MeshIndexType& nodeCount, MeshIndexType& triangleCount);
 
-  void createNodesAndTriangles(std::vector<MeshIndexType> m_NodeIds, MeshIndexType nodeCount, MeshIndexType triangleCount);
+  /**
+   * @brief createNodesAndTriangles Writes the vertices, node types, triangles, face labels and face data of the mesh,
+   * one slab of Z layers at a time
+   * @param layerNodeOffsets Number of the first mesh node owned by each Z layer of voxels
+   * @param layerTriangleOffsets Index of the first triangle of each Z layer of voxels
+   * @param nodeCount Total number of mesh nodes
+   * @param triangleCount Total number of triangles
+   */
+  void createNodesAndTriangles(const std::vector<MeshIndexType>& layerNodeOffsets, const std::vector<MeshIndexType>& layerTriangleOffsets, MeshIndexType nodeCount,
+                               MeshIndexType triangleCount);
 
   /**
    * @brief updateFaceInstancePointers Updates raw Face pointers
@@ -35,6 +35,8 @@
 
 #include "PackPrimaryPhases.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 #include <QtCore/QDebug>
@@ -352,6 +354,20 @@ void PackPrimaryPhases::initialize()
   m_FeatureSizeDistStep.clear();
   m_NeighborDistStep.clear();
 
+  m_NeighborGridCellSize = 1.0f;
+  m_NeighborGridDims[0] = m_NeighborGridDims[1] = m_NeighborGridDims[2] = 0;
+  m_NeighborGridCells.clear();
+  m_NeighborGridCellOfFeature.clear();
+  m_NeighborGridSlotOfFeature.clear();
+
+  m_TrackNeighborHistograms = false;
+  m_PrimaryPhaseIndex.clear();
+  m_NeighborHistograms.clear();
+  m_NeighborHistogramCounts.clear();
+  m_NeighborDistMinDia.clear();
+  m_NeighborDistMaxDia.clear();
+  m_NeighborDistOneOverBinStep.clear();
+
   m_PackQualities.clear();
   m_GSizes.clear();
 
@@ -1151,6 +1167,8 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   m_CurrentSizeDistError = 0.0f;
   m_OldSizeDistError = 0.0f;
   int32_t acceptedmoves = 0;
+  m_NeighborGridCells.clear();
+  m_TrackNeighborHistograms = false;
   float totalprimaryfractions = 0.0f;
 
   // find which phases are primary phases
@@ -1185,26 +1203,32 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   Int32ArrayType::Pointer exclusionOwnersPtr = Int32ArrayType::CreateArray(m_TotalPackingPoints, cDim, "_INTERNAL_USE_ONLY_PackPrimaryFeatures::exclusions_owners", true);
   exclusionOwnersPtr->initializeWithValue(0);
 
-  // This is the set that we are going to keep updated with the points that are not in an exclusion zone
-  std::map<size_t, size_t> availablePoints;
-  std::map<size_t, size_t> availablePointsInv;
+  // This is the set that we are going to keep updated with the points that are not in an exclusion zone.
+  // availablePointsInv holds the available points densely in its first m_AvailablePointsCount entries and
+  // availablePoints holds the position of each packing point in that list so points can be swapped out in constant time
+  std::vector<int64_t> availablePoints(static_cast<size_t>(m_TotalPackingPoints), -1);
+  std::vector<int64_t> availablePointsInv(static_cast<size_t>(m_TotalPackingPoints), 0);
 
   // Get a pointer to the Feature Owners that was just initialized in the initialize_packinggrid() method
   int32_t* featureOwners = featureOwnersPtr->getPointer(0);
   int32_t* exclusionOwners = exclusionOwnersPtr->getPointer(0);
   int64_t featureOwnersIdx = 0;
 
-  // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for(int64_t i = 0; i < m_TotalPackingPoints; i++)
   {
-    if((exclusionOwners[i] == 0 && !m_UseMask) || (exclusionOwners[i] == 0 && m_UseMask && m_Mask[i]))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
+    size_t ownersBytes = (featureOwnersPtr->getNumberOfTuples() + exclusionOwnersPtr->getNumberOfTuples()) * sizeof(int32_t);
+    size_t availableBytes = (availablePoints.size() + availablePointsInv.size()) * sizeof(int64_t);
+    QString ss = QObject::tr("Packing Grid: %1 x %2 x %3 points || Owners: %4 MB || Available Points: %5 MB || Total: %6 MB")
+                     .arg(m_PackingPoints[0])
+                     .arg(m_PackingPoints[1])
+                     .arg(m_PackingPoints[2])
+                     .arg(static_cast<double>(ownersBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+                     .arg(static_cast<double>(availableBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+                     .arg(static_cast<double>(ownersBytes + availableBytes) / (1024.0 * 1024.0), 0, 'f', 1);
+    notifyStatusMessage(ss);
   }
+
+  // determine initial set of available points
+  initializeAvailablePoints(exclusionOwners, availablePoints, availablePointsInv);
   // and clear the pointsToRemove and pointsToAdd vectors from the initial packing
   m_PointsToRemove.clear();
   m_PointsToAdd.clear();
@@ -1495,6 +1519,7 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   float timeDiff = 0.0f;
 
   // determine neighborhoods and initial neighbor distribution errors
+  initializeNeighborGrid(totalFeatures);
   for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
   {
     uint64_t currentMillis = QDateTime::currentMSecsSinceEpoch();
@@ -1510,22 +1535,14 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
     }
     determineNeighbors(i, true);
   }
+  initializeNeighborHistograms(totalFeatures);
   m_OldNeighborhoodError = checkNeighborhoodError(-1000, -1000);
 
   // begin swaping/moving/adding/removing features to try to improve packing
   int32_t totalAdjustments = static_cast<int32_t>(100 * (totalFeatures - 1));
 
   // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for(int64_t i = 0; i < m_TotalPackingPoints; i++)
-  {
-    if((exclusionOwners[i] == 0 && !m_UseMask) || (exclusionOwners[i] == 0 && m_UseMask && m_Mask[i]))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
-  }
+  initializeAvailablePoints(exclusionOwners, availablePoints, availablePointsInv);
 
   // and clear the pointsToRemove and pointsToAdd vectors from the initial packing
   m_PointsToRemove.clear();
@@ -1596,7 +1613,7 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
       }
       m_Seed++;
 
-      if(!availablePoints.empty())
+      if(m_AvailablePointsCount > 0)
       {
         key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
         featureOwnersIdx = availablePointsInv[key];
@@ -1722,6 +1739,14 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
     }
   }
 
+  // The neighbor search structures are only needed while the Features are being moved
+  m_NeighborGridCells.clear();
+  m_NeighborGridCellOfFeature.clear();
+  m_NeighborGridSlotOfFeature.clear();
+  m_TrackNeighborHistograms = false;
+  m_NeighborHistograms.clear();
+  m_NeighborHistogramCounts.clear();
+
   if(!m_VtkOutputFile.isEmpty())
   {
     int32_t err = writeVtkFile(featureOwnersPtr->getPointer(0), exclusionOwnersPtr->getPointer(0));
@@ -1947,15 +1972,112 @@ void PackPrimaryPhases::moveFeature(size_t gnum, float xc, float yc, float zc)
     int64_t& pl = m_PlaneList[gnum][i];
     pl += shiftplane;
   }
+
+  if(!m_NeighborGridCells.empty())
+  {
+    updateNeighborGrid(gnum);
+  }
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
+void PackPrimaryPhases::initializeNeighborGrid(size_t totalFeatures)
 {
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
+  m_NeighborGridCells.clear();
+  m_NeighborGridCellOfFeature.assign(totalFeatures, -1);
+  m_NeighborGridSlotOfFeature.assign(totalFeatures, 0);
+
+  // Two Features can only be neighbors if their centroids are closer than the larger of the two
+  // equivalent diameters along every axis, so a cell as wide as the largest diameter guarantees
+  // all neighbors of a Feature sit in the 27 cells around it
+  float maxDia = 0.0f;
+  for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    maxDia = std::max(maxDia, m_EquivalentDiameters[i]);
+  }
+  if(maxDia <= 0.0f)
+  {
+    maxDia = 1.0f;
+  }
+
+  // Larger cells stay correct, so coarsen the grid if it would hold many more cells than Features
+  float size[3] = {m_SizeX, m_SizeY, m_SizeZ};
+  float maxCells = static_cast<float>(8 * std::max(totalFeatures, static_cast<size_t>(1)));
+  float numCells = 1.0f;
+  for(const auto& value : size)
+  {
+    numCells *= (value / maxDia + 1.0f);
+  }
+  if(numCells > maxCells)
+  {
+    maxDia *= std::cbrt(numCells / maxCells);
+  }
+  // Pad the cells a little so rounding in the cell lookup can never put two neighbors two cells apart
+  m_NeighborGridCellSize = maxDia * 1.001f;
+
+  for(size_t i = 0; i < 3; i++)
+  {
+    m_NeighborGridDims[i] = static_cast<int64_t>(size[i] / m_NeighborGridCellSize) + 1;
+  }
+  m_NeighborGridCells.resize(static_cast<size_t>(m_NeighborGridDims[0] * m_NeighborGridDims[1] * m_NeighborGridDims[2]));
+
+  for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    int64_t cell = findNeighborGridCell(i);
+    m_NeighborGridCellOfFeature[i] = cell;
+    m_NeighborGridSlotOfFeature[i] = m_NeighborGridCells[cell].size();
+    m_NeighborGridCells[cell].push_back(static_cast<int32_t>(i));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int64_t PackPrimaryPhases::findNeighborGridCell(size_t gnum) const
+{
+  int64_t cell[3] = {0, 0, 0};
+  for(size_t i = 0; i < 3; i++)
+  {
+    float value = std::floor(m_Centroids[3 * gnum + i] / m_NeighborGridCellSize);
+    if(!(value >= 0.0f))
+    {
+      value = 0.0f;
+    }
+    cell[i] = static_cast<int64_t>(std::min(value, static_cast<float>(m_NeighborGridDims[i] - 1)));
+  }
+  return (cell[2] * m_NeighborGridDims[1] + cell[1]) * m_NeighborGridDims[0] + cell[0];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::updateNeighborGrid(size_t gnum)
+{
+  int64_t oldCell = m_NeighborGridCellOfFeature[gnum];
+  int64_t newCell = findNeighborGridCell(gnum);
+  if(oldCell == newCell)
+  {
+    return;
+  }
+
+  std::vector<int32_t>& oldList = m_NeighborGridCells[oldCell];
+  size_t slot = m_NeighborGridSlotOfFeature[gnum];
+  int32_t last = oldList.back();
+  oldList[slot] = last;
+  m_NeighborGridSlotOfFeature[last] = slot;
+  oldList.pop_back();
 
+  m_NeighborGridCellOfFeature[gnum] = newCell;
+  m_NeighborGridSlotOfFeature[gnum] = m_NeighborGridCells[newCell].size();
+  m_NeighborGridCells[newCell].push_back(static_cast<int32_t>(gnum));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
+{
   float x = 0.0f, y = 0.0f, z = 0.0f;
   float xn = 0.0f, yn = 0.0f, zn = 0.0f;
   float dia = 0.0f, dia2 = 0.0f;
@@ -1964,7 +2086,6 @@ void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
   y = m_Centroids[3 * gnum + 1];
   z = m_Centroids[3 * gnum + 2];
   dia = m_EquivalentDiameters[gnum];
-  size_t totalFeatures = m->getAttributeMatrix(m_OutputCellFeatureAttributeMatrixName)->getNumberOfTuples();
   int32_t increment = 0;
   if(add)
   {
@@ -1974,43 +2095,176 @@ void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
   {
     increment = -1;
   }
-  for(size_t n = m_FirstPrimaryFeature; n < totalFeatures; n++)
+
+  int64_t cell = m_NeighborGridCellOfFeature[gnum];
+  int64_t column = cell % m_NeighborGridDims[0];
+  int64_t row = (cell / m_NeighborGridDims[0]) % m_NeighborGridDims[1];
+  int64_t plane = cell / (m_NeighborGridDims[0] * m_NeighborGridDims[1]);
+  int32_t gnumIncrement = 0;
+  for(int64_t k = std::max(plane - 1, static_cast<int64_t>(0)); k <= std::min(plane + 1, m_NeighborGridDims[2] - 1); k++)
   {
-    xn = m_Centroids[3 * n];
-    yn = m_Centroids[3 * n + 1];
-    zn = m_Centroids[3 * n + 2];
-    dia2 = m_EquivalentDiameters[n];
-    dx = fabs(x - xn);
-    dy = fabs(y - yn);
-    dz = fabs(z - zn);
-    if(dx < dia && dy < dia && dz < dia)
-    {
-      m_Neighborhoods[gnum] = m_Neighborhoods[gnum] + increment;
-    }
-    if(dx < dia2 && dy < dia2 && dz < dia2)
+    for(int64_t j = std::max(row - 1, static_cast<int64_t>(0)); j <= std::min(row + 1, m_NeighborGridDims[1] - 1); j++)
     {
-      m_Neighborhoods[n] = m_Neighborhoods[n] + increment;
+      for(int64_t i = std::max(column - 1, static_cast<int64_t>(0)); i <= std::min(column + 1, m_NeighborGridDims[0] - 1); i++)
+      {
+        const std::vector<int32_t>& features = m_NeighborGridCells[(k * m_NeighborGridDims[1] + j) * m_NeighborGridDims[0] + i];
+        for(const auto& feature : features)
+        {
+          size_t n = static_cast<size_t>(feature);
+          xn = m_Centroids[3 * n];
+          yn = m_Centroids[3 * n + 1];
+          zn = m_Centroids[3 * n + 2];
+          dia2 = m_EquivalentDiameters[n];
+          dx = fabs(x - xn);
+          dy = fabs(y - yn);
+          dz = fabs(z - zn);
+          if(dx < dia && dy < dia && dz < dia)
+          {
+            gnumIncrement += increment;
+          }
+          if(dx < dia2 && dy < dia2 && dz < dia2)
+          {
+            if(n == gnum)
+            {
+              gnumIncrement += increment;
+            }
+            else
+            {
+              updateNeighborhood(n, increment);
+            }
+          }
+        }
+      }
     }
   }
+  updateNeighborhood(gnum, gnumIncrement);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
+void PackPrimaryPhases::updateNeighborhood(size_t gnum, int32_t increment)
 {
-  // Optimized Code
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
+  if(increment == 0)
+  {
+    return;
+  }
+  if(m_TrackNeighborHistograms)
+  {
+    updateNeighborHistogram(gnum, -1);
+  }
+  m_Neighborhoods[gnum] = m_Neighborhoods[gnum] + increment;
+  if(m_TrackNeighborHistograms)
+  {
+    updateNeighborHistogram(gnum, 1);
+  }
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::initializeNeighborHistograms(size_t totalFeatures)
+{
   StatsDataArray& statsDataArray = *(m_StatsDataArray.lock().get());
 
+  size_t numPhases = m_SimNeighborDist.size();
+  int32_t maxPhase = 0;
+  for(size_t iter = 0; iter < numPhases; ++iter)
+  {
+    maxPhase = std::max(maxPhase, m_PrimaryPhases[iter]);
+  }
+  m_PrimaryPhaseIndex.assign(static_cast<size_t>(maxPhase) + 1, -1);
+  m_NeighborHistograms.resize(numPhases);
+  m_NeighborHistogramCounts.resize(numPhases);
+  m_NeighborDistMinDia.resize(numPhases);
+  m_NeighborDistMaxDia.resize(numPhases);
+  m_NeighborDistOneOverBinStep.resize(numPhases);
+  for(size_t iter = 0; iter < numPhases; ++iter)
+  {
+    int32_t phase = m_PrimaryPhases[iter];
+    PrimaryStatsData::Pointer pp = std::dynamic_pointer_cast<PrimaryStatsData>(statsDataArray[phase]);
+    m_PrimaryPhaseIndex[phase] = static_cast<int32_t>(iter);
+    m_NeighborDistMinDia[iter] = pp->getMinFeatureDiameter();
+    m_NeighborDistMaxDia[iter] = pp->getMaxFeatureDiameter();
+    m_NeighborDistOneOverBinStep[iter] = 1.0f / pp->getBinStepSize();
+    size_t numDiaBins = m_SimNeighborDist[iter].size();
+    m_NeighborHistograms[iter].assign(numDiaBins, std::vector<int32_t>(40, 0));
+    m_NeighborHistogramCounts[iter].assign(numDiaBins, 0);
+  }
+
+  for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    updateNeighborHistogram(i, 1);
+  }
+  m_TrackNeighborHistograms = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PackPrimaryPhases::findNeighborDistBins(size_t gnum, size_t& phaseIndex, size_t& diaBin, size_t& nnumBin) const
+{
+  int32_t phase = m_FeaturePhases[gnum];
+  if(phase < 0 || static_cast<size_t>(phase) >= m_PrimaryPhaseIndex.size() || m_PrimaryPhaseIndex[phase] < 0)
+  {
+    return false;
+  }
+  phaseIndex = static_cast<size_t>(m_PrimaryPhaseIndex[phase]);
+  size_t numDiaBins = m_NeighborHistograms[phaseIndex].size();
+  if(numDiaBins == 0)
+  {
+    return false;
+  }
+
+  float maxFeatureDia = m_NeighborDistMaxDia[phaseIndex];
+  float minFeatureDia = m_NeighborDistMinDia[phaseIndex];
+  float dia = m_EquivalentDiameters[gnum];
+  if(dia > maxFeatureDia)
+  {
+    dia = maxFeatureDia;
+  }
+  if(dia < minFeatureDia)
+  {
+    dia = minFeatureDia;
+  }
+  diaBin = static_cast<size_t>(((dia - minFeatureDia) * m_NeighborDistOneOverBinStep[phaseIndex]));
+  if(diaBin >= numDiaBins)
+  {
+    diaBin = numDiaBins - 1;
+  }
+  float oneOverNeighborDistStep = 1.0f / m_NeighborDistStep[phaseIndex];
+  nnumBin = static_cast<size_t>(m_Neighborhoods[gnum] * oneOverNeighborDistStep);
+  if(nnumBin >= 40)
+  {
+    nnumBin = 39;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::updateNeighborHistogram(size_t gnum, int32_t delta)
+{
+  size_t phaseIndex = 0;
+  size_t diaBin = 0;
+  size_t nnumBin = 0;
+  if(findNeighborDistBins(gnum, phaseIndex, diaBin, nnumBin))
+  {
+    m_NeighborHistograms[phaseIndex][diaBin][nnumBin] += delta;
+    m_NeighborHistogramCounts[phaseIndex][diaBin] += delta;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
+{
+  // The raw histograms are kept in sync with m_Neighborhoods by updateNeighborhood, so only the
+  // Features touched by gadd/gremove have to be rebinned here instead of every Feature
   float neighborerror = 0.0f;
   float bhattdist = 0.0f;
-  float dia = 0.0f;
-  int32_t nnum = 0;
-  size_t diabin = 0;
-  size_t nnumbin = 0;
-  int32_t index = 0;
   int32_t phase = 0;
 
   using VectOfVectFloat_t = std::vector<std::vector<float>>;
@@ -2018,93 +2272,29 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
   for(size_t iter = 0; iter < numPhases; ++iter)
   {
     phase = m_PrimaryPhases[iter];
-    PrimaryStatsData::Pointer pp = std::dynamic_pointer_cast<PrimaryStatsData>(statsDataArray[phase]);
     VectOfVectFloat_t& curSimNeighborDist = m_SimNeighborDist[iter];
     size_t curSImNeighborDist_Size = curSimNeighborDist.size();
-    float oneOverNeighborDistStep = 1.0f / m_NeighborDistStep[iter];
 
-    std::vector<int32_t> count(curSImNeighborDist_Size, 0);
-    for(size_t i = 0; i < curSImNeighborDist_Size; i++)
-    {
-      curSimNeighborDist[i].resize(40);
-      for(size_t j = 0; j < 40; j++)
-      {
-        curSimNeighborDist[i][j] = 0;
-      }
-    }
-    if(gadd > 0 && m_FeaturePhases[gadd] == phase)
+    bool addFeature = (gadd > 0 && m_FeaturePhases[gadd] == phase);
+    bool removeFeature = (gremove > 0 && m_FeaturePhases[gremove] == phase);
+    if(addFeature)
     {
       determineNeighbors(gadd, true);
+      updateNeighborHistogram(gadd, 1);
     }
-    if(gremove > 0 && m_FeaturePhases[gremove] == phase)
+    if(removeFeature)
     {
       determineNeighbors(gremove, false);
+      updateNeighborHistogram(gremove, -1);
     }
 
-    float maxFeatureDia = pp->getMaxFeatureDiameter();
-    float minFeatureDia = pp->getMinFeatureDiameter();
-    float oneOverBinStepSize = 1.0f / pp->getBinStepSize();
-
-    size_t totalFeatures = m->getAttributeMatrix(m_OutputCellFeatureAttributeMatrixName)->getNumberOfTuples();
-    for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
-    {
-      nnum = 0;
-      index = static_cast<int32_t>(i);
-      if(index != gremove && m_FeaturePhases[index] == phase)
-      {
-        dia = m_EquivalentDiameters[index];
-        if(dia > maxFeatureDia)
-        {
-          dia = maxFeatureDia;
-        }
-        if(dia < minFeatureDia)
-        {
-          dia = minFeatureDia;
-        }
-        diabin = static_cast<size_t>(((dia - minFeatureDia) * oneOverBinStepSize));
-        if(diabin >= curSImNeighborDist_Size)
-        {
-          diabin = curSImNeighborDist_Size - 1;
-        }
-        nnum = m_Neighborhoods[index];
-        nnumbin = static_cast<size_t>(nnum * oneOverNeighborDistStep);
-        if(nnumbin >= 40)
-        {
-          nnumbin = 39;
-        }
-        curSimNeighborDist[diabin][nnumbin]++;
-        count[diabin]++;
-      }
-    }
-    if(gadd > 0 && m_FeaturePhases[gadd] == phase)
-    {
-      dia = m_EquivalentDiameters[gadd];
-      if(dia > maxFeatureDia)
-      {
-        dia = maxFeatureDia;
-      }
-      if(dia < minFeatureDia)
-      {
-        dia = minFeatureDia;
-      }
-      diabin = static_cast<size_t>(((dia - minFeatureDia) * oneOverBinStepSize));
-      if(diabin >= curSImNeighborDist_Size)
-      {
-        diabin = curSImNeighborDist_Size - 1;
-      }
-      nnum = m_Neighborhoods[gadd];
-      nnumbin = static_cast<size_t>(nnum * oneOverNeighborDistStep);
-      if(nnumbin >= 40)
-      {
-        nnumbin = 39;
-      }
-      curSimNeighborDist[diabin][nnumbin]++;
-      count[diabin]++;
-    }
+    const std::vector<std::vector<int32_t>>& histogram = m_NeighborHistograms[iter];
+    const std::vector<int32_t>& count = m_NeighborHistogramCounts[iter];
     float runningtotal = 0.0f;
 
     for(size_t i = 0; i < curSImNeighborDist_Size; i++)
     {
+      curSimNeighborDist[i].resize(40);
       if(count[i] == 0)
       {
         for(size_t j = 0; j < 40; j++)
@@ -2117,7 +2307,7 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
         float oneOverCount = 1.0f / static_cast<float>(count[i]);
         for(size_t j = 0; j < 40; j++)
         {
-          curSimNeighborDist[i][j] = curSimNeighborDist[i][j] * oneOverCount;
+          curSimNeighborDist[i][j] = static_cast<float>(histogram[i][j]) * oneOverCount;
           runningtotal = runningtotal + curSimNeighborDist[i][j];
         }
       }
@@ -2132,13 +2322,15 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
       }
     }
 
-    if(gadd > 0 && m_FeaturePhases[gadd] == phase)
+    if(addFeature)
     {
+      updateNeighborHistogram(gadd, -1);
       determineNeighbors(gadd, false);
     }
 
-    if(gremove > 0 && m_FeaturePhases[gremove] == phase)
+    if(removeFeature)
     {
+      updateNeighborHistogram(gremove, 1);
       determineNeighbors(gremove, true);
     }
   }
@@ -2150,7 +2342,7 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::compare1dDistributions(std::vector<float> array1, std::vector<float> array2, float& bhattdist)
+void PackPrimaryPhases::compare1dDistributions(const std::vector<float>& array1, const std::vector<float>& array2, float& bhattdist)
 {
   bhattdist = 0.0f;
   size_t array1Size = array1.size();
@@ -2163,7 +2355,7 @@ void PackPrimaryPhases::compare1dDistributions(std::vector<float> array1, std::v
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::compare2dDistributions(std::vector<std::vector<float>> array1, std::vector<std::vector<float>> array2, float& bhattdist)
+void PackPrimaryPhases::compare2dDistributions(const std::vector<std::vector<float>>& array1, const std::vector<std::vector<float>>& array2, float& bhattdist)
 {
   bhattdist = 0.0f;
   size_t array1Size = array1.size();
@@ -2180,7 +2372,7 @@ void PackPrimaryPhases::compare2dDistributions(std::vector<std::vector<float>> a
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::compare3dDistributions(std::vector<std::vector<std::vector<float>>> array1, std::vector<std::vector<std::vector<float>>> array2, float& bhattdist)
+void PackPrimaryPhases::compare3dDistributions(const std::vector<std::vector<std::vector<float>>>& array1, const std::vector<std::vector<std::vector<float>>>& array2, float& bhattdist)
 {
   bhattdist = 0.0f;
   size_t array1Size = array1.size();
@@ -2475,30 +2667,56 @@ float PackPrimaryPhases::checkFillingError(int32_t gadd, int32_t gremove, Int32A
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::updateAvailablePoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv)
+void PackPrimaryPhases::initializeAvailablePoints(const int32_t* exclusionOwners, std::vector<int64_t>& availablePoints, std::vector<int64_t>& availablePointsInv)
+{
+  m_AvailablePointsCount = 0;
+  for(int64_t i = 0; i < m_TotalPackingPoints; i++)
+  {
+    if((exclusionOwners[i] == 0 && !m_UseMask) || (exclusionOwners[i] == 0 && m_UseMask && m_Mask[i]))
+    {
+      availablePoints[i] = static_cast<int64_t>(m_AvailablePointsCount);
+      availablePointsInv[m_AvailablePointsCount] = i;
+      m_AvailablePointsCount++;
+    }
+    else
+    {
+      availablePoints[i] = -1;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::updateAvailablePoints(std::vector<int64_t>& availablePoints, std::vector<int64_t>& availablePointsInv)
 {
   size_t removeSize = m_PointsToRemove.size();
   size_t addSize = m_PointsToAdd.size();
-  size_t featureOwnersIdx = 0;
-  size_t key = 0, val = 0;
+  int64_t featureOwnersIdx = 0;
+  int64_t key = 0, val = 0;
   for(size_t i = 0; i < removeSize; i++)
   {
     featureOwnersIdx = m_PointsToRemove[i];
     key = availablePoints[featureOwnersIdx];
-    //  availablePoints.erase(featureOwnersIdx);
-    val = availablePointsInv[m_AvailablePointsCount - 1];
-    //  availablePointsInv.erase(availablePointsCount-1);
-    if(key < m_AvailablePointsCount - 1)
+    // Masked points are never in the set
+    if(key < 0)
     {
-      availablePointsInv[key] = val;
-      availablePoints[val] = key;
+      continue;
     }
+    val = availablePointsInv[m_AvailablePointsCount - 1];
+    availablePointsInv[key] = val;
+    availablePoints[val] = key;
+    availablePoints[featureOwnersIdx] = -1;
     m_AvailablePointsCount--;
   }
   for(size_t i = 0; i < addSize; i++)
   {
     featureOwnersIdx = m_PointsToAdd[i];
-    availablePoints[featureOwnersIdx] = m_AvailablePointsCount;
+    if(availablePoints[featureOwnersIdx] >= 0 || (m_UseMask && !m_Mask[featureOwnersIdx]))
+    {
+      continue;
+    }
+    availablePoints[featureOwnersIdx] = static_cast<int64_t>(m_AvailablePointsCount);
     availablePointsInv[m_AvailablePointsCount] = featureOwnersIdx;
     m_AvailablePointsCount++;
   }
@@ -521,6 +521,60 @@ protected:
    */
   void determineNeighbors(size_t gnum, bool add);
 
+  /**
+   * @brief initializeNeighborGrid Bins the Feature centroids into a uniform grid whose cells are as
+   * wide as the largest equivalent diameter, so determineNeighbors only has to visit the 27 cells
+   * around a Feature. The grid is kept up to date by moveFeature
+   * @param totalFeatures Number of Features
+   */
+  void initializeNeighborGrid(size_t totalFeatures);
+
+  /**
+   * @brief findNeighborGridCell Returns the neighbor grid cell that contains the centroid of a Feature
+   * @param gnum Id for the Feature
+   * @return Cell index
+   */
+  int64_t findNeighborGridCell(size_t gnum) const;
+
+  /**
+   * @brief updateNeighborGrid Moves a Feature into the neighbor grid cell of its current centroid
+   * @param gnum Id for the Feature
+   */
+  void updateNeighborGrid(size_t gnum);
+
+  /**
+   * @brief initializeNeighborHistograms Fills the raw neighborhood histograms used by checkNeighborhoodError
+   * from the current neighborhood counts. From then on the histograms are updated incrementally
+   * whenever a neighborhood count changes
+   * @param totalFeatures Number of Features
+   */
+  void initializeNeighborHistograms(size_t totalFeatures);
+
+  /**
+   * @brief findNeighborDistBins Finds the histogram bins a Feature falls into for the neighbor distribution
+   * @param gnum Id for the Feature
+   * @param phaseIndex Index of the Feature's phase in the primary phases
+   * @param diaBin Equivalent diameter bin
+   * @param nnumBin Number of neighbors bin
+   * @return False if the Feature does not belong to a primary phase
+   */
+  bool findNeighborDistBins(size_t gnum, size_t& phaseIndex, size_t& diaBin, size_t& nnumBin) const;
+
+  /**
+   * @brief updateNeighborHistogram Adds (or removes) a Feature to the raw neighborhood histogram of its phase
+   * @param gnum Id for the Feature
+   * @param delta Value to add to the Feature's histogram bin
+   */
+  void updateNeighborHistogram(size_t gnum, int32_t delta);
+
+  /**
+   * @brief updateNeighborhood Changes the neighborhood count of a Feature while keeping the neighborhood
+   * histograms in sync
+   * @param gnum Id for the Feature
+   * @param increment Value to add to the neighborhood count
+   */
+  void updateNeighborhood(size_t gnum, int32_t increment);
+
   /**
    * @brief check_neighborhooderror Computes the error between the current Feature neighbor distribution
    * and the goal Feature neighbor distribution
@@ -541,11 +595,19 @@ protected:
   float checkFillingError(int32_t gadd, int32_t gremove, Int32ArrayType::Pointer featureOwnersPtr, Int32ArrayType::Pointer exclusionOwnersPtr);
 
   /**
-   * @brief update_availablepoints Updates the maps used to associate packing points with an "available" state
-   * @param availablePoints Map between Feature owners and number of available points
-   * @param availablePointsInv Inverse associations for the availablePoints map
+   * @brief initializeAvailablePoints Fills the set of packing points that are not in an exclusion zone
+   * @param exclusionOwners Array of exclusion Ids for each packing point
+   * @param availablePoints Position of each packing point in availablePointsInv, or -1 if the point is not available
+   * @param availablePointsInv Dense list of the available packing points
+   */
+  void initializeAvailablePoints(const int32_t* exclusionOwners, std::vector<int64_t>& availablePoints, std::vector<int64_t>& availablePointsInv);
+
+  /**
+   * @brief update_availablepoints Updates the arrays used to associate packing points with an "available" state
+   * @param availablePoints Position of each packing point in availablePointsInv, or -1 if the point is not available
+   * @param availablePointsInv Dense list of the available packing points
    */
-  void updateAvailablePoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv);
+  void updateAvailablePoints(std::vector<int64_t>& availablePoints, std::vector<int64_t>& availablePointsInv);
 
   /**
    * @brief assign_voxels Assigns Feature Id values to voxels within the packing grid
@@ -571,19 +633,19 @@ protected:
    * @brief compare_1Ddistributions Computes the 1D Bhattacharyya distance
    * @param sqrerror Float 1D Bhattacharyya distance
    */
-  void compare1dDistributions(std::vector<float>, std::vector<float>, float& sqrerror);
+  void compare1dDistributions(const std::vector<float>&, const std::vector<float>&, float& sqrerror);
 
   /**
    * @brief compare_2Ddistributions Computes the 2D Bhattacharyya distance
    * @param sqrerror Float 1D Bhattacharyya distance
    */
-  void compare2dDistributions(std::vector<std::vector<float>>, std::vector<std::vector<float>>, float& sqrerror);
+  void compare2dDistributions(const std::vector<std::vector<float>>&, const std::vector<std::vector<float>>&, float& sqrerror);
 
   /**
    * @brief compare_3Ddistributions Computes the 3D Bhattacharyya distance
    * @param sqrerror Float 1D Bhattacharyya distance
    */
-  void compare3dDistributions(std::vector<std::vector<std::vector<float>>>, std::vector<std::vector<std::vector<float>>>, float& sqrerror);
+  void compare3dDistributions(const std::vector<std::vector<std::vector<float>>>&, const std::vector<std::vector<std::vector<float>>>&, float& sqrerror);
 
   /**
    * @brief writeVtkFile Outputs a debug VTK file for visualization
@@ -720,6 +782,22 @@ private:
   std::vector<float> m_FeatureSizeDistStep;
   std::vector<float> m_NeighborDistStep;
 
+  // Uniform grid over the Feature centroids used to find neighborhoods
+  float m_NeighborGridCellSize = 1.0f;
+  int64_t m_NeighborGridDims[3] = {0, 0, 0};
+  std::vector<std::vector<int32_t>> m_NeighborGridCells;
+  std::vector<int64_t> m_NeighborGridCellOfFeature;
+  std::vector<size_t> m_NeighborGridSlotOfFeature;
+
+  // Raw (unnormalized) neighbor distribution counts per primary phase that mirror m_Neighborhoods
+  bool m_TrackNeighborHistograms = false;
+  std::vector<int32_t> m_PrimaryPhaseIndex;
+  std::vector<std::vector<std::vector<int32_t>>> m_NeighborHistograms;
+  std::vector<std::vector<int32_t>> m_NeighborHistogramCounts;
+  std::vector<float> m_NeighborDistMinDia;
+  std::vector<float> m_NeighborDistMaxDia;
+  std::vector<float> m_NeighborDistOneOverBinStep;
+
   std::vector<int64_t> m_PackQualities;
   std::vector<int64_t> m_GSizes;
 